@@ -2,6 +2,10 @@
 #include "mocked_utils.hpp"
 
 #include <libpldm/platform.h>
+#include <libpldm/utils.h>
+
+#include <chrono>
+#include <numeric>
 
 #include <gtest/gtest.h>
 
@@ -1067,3 +1071,74 @@ TEST(Split, allTestCases)
     auto results5 = split(s5, "\\");
     EXPECT_EQ(results5[0], "aa");
 }
+
+TEST(calcCrc32, testMatchesLibpldm)
+{
+    std::vector<uint8_t> data(1031);
+    std::iota(data.begin(), data.end(), 0);
+
+    // Every length and alignment around the 8 byte blocks
+    for (size_t offset = 0; offset < 8; offset++)
+    {
+        for (size_t size = 0; size + offset <= 40; size++)
+        {
+            EXPECT_EQ(calcCrc32(data.data() + offset, size),
+                      ::crc32(data.data() + offset, size));
+        }
+    }
+    EXPECT_EQ(calcCrc32(data.data(), data.size()),
+              ::crc32(data.data(), data.size()));
+
+    const char check[] = "123456789";
+    EXPECT_EQ(calcCrc32(check, sizeof(check) - 1), 0xCBF43926);
+
+    // Computed a piece at a time
+    uint32_t crc = 0;
+    for (size_t offset = 0; offset < data.size(); offset += 100)
+    {
+        crc = calcCrc32(data.data() + offset,
+                        std::min<size_t>(100, data.size() - offset), crc);
+    }
+    EXPECT_EQ(crc, ::crc32(data.data(), data.size()));
+}
+
+TEST(calcCrc32, testBenchmark)
+{
+    std::vector<uint8_t> data(1024 * 1024);
+    std::iota(data.begin(), data.end(), 0);
+    constexpr int iterations = 16;
+
+    auto elapsed = [&data](auto&& crc) {
+        auto start = std::chrono::steady_clock::now();
+        uint32_t result = 0;
+        for (int i = 0; i < iterations; i++)
+        {
+            result ^= crc(data.data(), data.size());
+        }
+        auto end = std::chrono::steady_clock::now();
+        EXPECT_EQ(result, 0);
+        return std::chrono::duration_cast<std::chrono::microseconds>(end -
+                                                                     start)
+            .count();
+    };
+
+    auto bytewise = elapsed(
+        [](const void* p, size_t size) { return ::crc32(p, size); });
+    auto sliced = elapsed(
+        [](const void* p, size_t size) { return calcCrc32(p, size); });
+    RecordProperty("libpldm_crc32_us", std::to_string(bytewise));
+    RecordProperty("calcCrc32_us", std::to_string(sliced));
+}
+
+TEST(checkForFruPresence, testPresentPropertyInObject)
+{
+    InterfaceMap interfaces{
+        {"xyz.openbmc_project.Inventory.Item", {{"Present", true}}},
+        {"xyz.openbmc_project.Inventory.Item.Board", {}}};
+    EXPECT_TRUE(checkForFruPresence("/xyz/openbmc_project/inventory/system",
+                                    interfaces));
+
+    interfaces["xyz.openbmc_project.Inventory.Item"]["Present"] = false;
+    EXPECT_FALSE(checkForFruPresence("/xyz/openbmc_project/inventory/system",
+                                     interfaces));
+}
@@ -167,6 +167,71 @@ uint8_t getNumPadBytes(uint32_t data)
     return pad;
 } // end getNumPadBytes
 
+namespace
+{
+
+using Crc32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+/** @brief Build the slicing-by-8 tables of the reflected CRC32 polynomial,
+ *         tables[n][b] is the CRC of byte b followed by n zero bytes
+ */
+constexpr Crc32Tables makeCrc32Tables()
+{
+    Crc32Tables tables{};
+    for (uint32_t byte = 0; byte < 256; byte++)
+    {
+        uint32_t crc = byte;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0U - (crc & 1)));
+        }
+        tables[0][byte] = crc;
+    }
+    for (uint32_t byte = 0; byte < 256; byte++)
+    {
+        for (size_t n = 1; n < tables.size(); n++)
+        {
+            auto prev = tables[n - 1][byte];
+            tables[n][byte] = (prev >> 8) ^ tables[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr Crc32Tables crc32Tables = makeCrc32Tables();
+
+} // namespace
+
+uint32_t calcCrc32(const void* data, size_t size, uint32_t crc)
+{
+    const auto& t = crc32Tables;
+    auto p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+
+    for (; size >= 8; size -= 8, p += 8)
+    {
+        uint32_t lo = crc ^ (static_cast<uint32_t>(p[0]) |
+                             static_cast<uint32_t>(p[1]) << 8 |
+                             static_cast<uint32_t>(p[2]) << 16 |
+                             static_cast<uint32_t>(p[3]) << 24);
+        uint32_t hi = static_cast<uint32_t>(p[4]) |
+                      static_cast<uint32_t>(p[5]) << 8 |
+                      static_cast<uint32_t>(p[6]) << 16 |
+                      static_cast<uint32_t>(p[7]) << 24;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][hi & 0xFF] ^
+              t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^
+              t[0][hi >> 24];
+    }
+
+    for (; size; size--, p++)
+    {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFF];
+    }
+
+    return ~crc;
+}
+
 bool uintToDate(uint64_t data, uint16_t* year, uint8_t* month, uint8_t* day,
                 uint8_t* hour, uint8_t* min, uint8_t* sec)
 {
@@ -634,6 +699,22 @@ bool checkForFruPresence(const std::string& objPath)
     return isPresent;
 }
 
+bool checkForFruPresence(const std::string& objPath,
+                         const InterfaceMap& interfaces)
+{
+    auto interface = interfaces.find("xyz.openbmc_project.Inventory.Item");
+    if (interface != interfaces.end())
+    {
+        auto present = interface->second.find("Present");
+        if (present != interface->second.end() &&
+            std::holds_alternative<bool>(present->second))
+        {
+            return std::get<bool>(present->second);
+        }
+    }
+    return checkForFruPresence(objPath);
+}
+
 bool checkIfLogicalBitSet(const uint16_t& containerId)
 {
     return !(containerId & 0x8000);
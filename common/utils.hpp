@@ -84,6 +84,17 @@ struct CustomFD
  */
 uint8_t getNumPadBytes(uint32_t data);
 
+/** @brief Calculate the CRC32 of the data, same as crc32() of libpldm but
+ *         processing 8 bytes at a time with slicing-by-8 lookup tables
+ *
+ *  @param[in] data - the data
+ *  @param[in] size - size of the data in bytes
+ *  @param[in] crc - CRC32 of the data preceding this data, which allows the
+ *                   CRC32 of a large buffer to be computed a piece at a time
+ *  @return - uint32_t - CRC32 of the data
+ */
+uint32_t calcCrc32(const void* data, size_t size, uint32_t crc = 0);
+
 /** @brief Convert uint64 to date
  *
  *  @param[in] data - time date of uint64
@@ -494,6 +505,17 @@ std::string getCurrentSystemTime();
  */
 bool checkForFruPresence(const std::string& objPath);
 
+/** @brief checks if the FRU is actually present, from the properties of the
+ *         FRU object when they hold the Present property, such as the ones
+ *         from GetManagedObjects, and from D-Bus otherwise.
+ *  @param[in] objPath - FRU object path.
+ *  @param[in] interfaces - interfaces and properties of the FRU object.
+ *
+ *  @return bool to indicate presence or absence of FRU.
+ */
+bool checkForFruPresence(const std::string& objPath,
+                         const InterfaceMap& interfaces);
+
 /** @brief Method to check if the logical bit is set
  *
  *  @param[containerId] - container id of the entity
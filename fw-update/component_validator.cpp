@@ -0,0 +1,120 @@
+#include "component_validator.hpp"
+
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <utility>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+ComponentValidator::ComponentValidator(
+    sdeventplus::Event& event, int packageFd, const struct stat& packageStat,
+    const ComponentImageInfos& compImageInfos, Callback completed) :
+    packageFd(packageFd),
+    packageStat(packageStat), compImageInfos(compImageInfos),
+    completed(std::move(completed))
+{
+    // Large enough to keep the reads efficient, small enough for a slice to
+    // not hold up the PLDM messages of the devices being updated
+    constexpr size_t sliceSize = 256 * 1024;
+
+    buffer.resize(sliceSize);
+    validationEvent = std::make_unique<sdeventplus::source::Defer>(
+        event, std::bind_front(&ComponentValidator::validateSlice, this));
+    // Only run a slice when there are no other events pending, so that the
+    // RequestUpdate and PassComponentTable exchanges go ahead in between
+    validationEvent->set_priority(SD_EVENT_PRIORITY_IDLE);
+}
+
+void ComponentValidator::await(Callback callback)
+{
+    if (componentsValid)
+    {
+        callback(*componentsValid);
+        return;
+    }
+    waiting.emplace_back(std::move(callback));
+}
+
+void ComponentValidator::validateSlice(
+    sdeventplus::source::EventBase& /*source */)
+{
+    if (component == compImageInfos.size())
+    {
+        struct stat sb;
+        if (fstat(packageFd, &sb) < 0 || sb.st_size != packageStat.st_size ||
+            sb.st_mtim.tv_sec != packageStat.st_mtim.tv_sec ||
+            sb.st_mtim.tv_nsec != packageStat.st_mtim.tv_nsec)
+        {
+            error("PLDM fw update package was modified while it was validated");
+            complete(false);
+            return;
+        }
+        complete(true);
+        return;
+    }
+
+    const auto& comp = compImageInfos[component];
+    CompLocationOffset compOffset = std::get<static_cast<size_t>(
+        ComponentImageInfoPos::CompLocationOffsetPos)>(comp);
+    CompSize compSize =
+        std::get<static_cast<size_t>(ComponentImageInfoPos::CompSizePos)>(
+            comp);
+    const auto& compVersion =
+        std::get<static_cast<size_t>(ComponentImageInfoPos::CompVersionPos)>(
+            comp);
+
+    auto length = std::min<size_t>(buffer.size(), compSize - offset);
+    auto rc = pread(packageFd, buffer.data(), length,
+                    static_cast<off_t>(compOffset) + offset);
+    if (rc < 0 || static_cast<size_t>(rc) != length)
+    {
+        error(
+            "Failed to read component image '{COMPONENT_VERSION}' at offset '{OFFSET}' of the PLDM fw update package, error - {ERROR}",
+            "COMPONENT_VERSION", compVersion, "OFFSET", offset, "ERROR",
+            rc < 0 ? errno : 0);
+        complete(false);
+        return;
+    }
+
+    offset += length;
+    if (offset == compSize)
+    {
+        info(
+            "Read component image '{COMPONENT_VERSION}' of size '{SIZE}' from the PLDM fw update package",
+            "COMPONENT_VERSION", compVersion, "SIZE", compSize);
+        component++;
+        offset = 0;
+    }
+}
+
+void ComponentValidator::complete(bool status)
+{
+    validationEvent.reset();
+    buffer.clear();
+    buffer.shrink_to_fit();
+    componentsValid = status;
+
+    // The callbacks may end the firmware update and destroy the validator
+    auto callbacks = std::exchange(waiting, {});
+    if (completed)
+    {
+        std::exchange(completed, {})(status);
+    }
+    for (const auto& callback : callbacks)
+    {
+        callback(status);
+    }
+}
+
+} // namespace fw_update
+
+} // namespace pldm
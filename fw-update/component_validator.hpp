@@ -0,0 +1,113 @@
+#pragma once
+
+#include "common/types.hpp"
+
+#include <sys/stat.h>
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/event.hpp>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @class ComponentValidator
+ *
+ *  Checks in the background, a slice at a time, that the component images of
+ *  a firmware update package can be read in full from the package file and
+ *  that the file is not modified meanwhile. The PLDM package carries no
+ *  checksum of the component images, their contents are checked by the
+ *  firmware devices on VerifyComplete.
+ */
+class ComponentValidator
+{
+  public:
+    using Callback = std::function<void(bool status)>;
+
+    ComponentValidator() = delete;
+    ComponentValidator(const ComponentValidator&) = delete;
+    ComponentValidator(ComponentValidator&&) = delete;
+    ComponentValidator& operator=(const ComponentValidator&) = delete;
+    ComponentValidator& operator=(ComponentValidator&&) = delete;
+    ~ComponentValidator() = default;
+
+    /** @brief Constructor, starts the validation
+     *
+     *  @param[in] event - event loop the validation runs on
+     *  @param[in] packageFd - file descriptor of the firmware update package
+     *  @param[in] packageStat - status of the package file when it was opened
+     *  @param[in] compImageInfos - component images of the package
+     *  @param[in] completed - called with the outcome of the validation,
+     *                         before the callbacks passed to await()
+     */
+    explicit ComponentValidator(sdeventplus::Event& event, int packageFd,
+                                const struct stat& packageStat,
+                                const ComponentImageInfos& compImageInfos,
+                                Callback completed);
+
+    /** @brief Get the outcome of the validation
+     *
+     *  @return true if the component images are valid, std::nullopt while
+     *          the validation is in progress
+     */
+    std::optional<bool> result() const
+    {
+        return componentsValid;
+    }
+
+    /** @brief Wait for the outcome of the validation, the callback is called
+     *         right away if the outcome is known
+     *
+     *  @param[in] callback - called with the outcome of the validation
+     */
+    void await(Callback callback);
+
+  private:
+    /** @brief Read the next slice of the component images
+     *
+     *  @param[in] source - the event source
+     */
+    void validateSlice(sdeventplus::source::EventBase& source);
+
+    /** @brief Record the outcome of the validation and call the callbacks
+     *         waiting for it
+     *
+     *  @param[in] status - true if the component images are valid
+     */
+    void complete(bool status);
+
+    int packageFd;
+    struct stat packageStat;
+    const ComponentImageInfos& compImageInfos;
+    Callback completed;
+
+    /** @brief Event source validating the component images */
+    std::unique_ptr<sdeventplus::source::Defer> validationEvent;
+
+    /** @brief Buffer a slice of a component image is read into */
+    std::vector<uint8_t> buffer;
+
+    /** @brief Position of the validation, the component image in the
+     *         ComponentImageInfos and the offset in it
+     */
+    size_t component = 0;
+    uint32_t offset = 0;
+
+    /** @brief Outcome of the validation, std::nullopt while it is in progress
+     */
+    std::optional<bool> componentsValid;
+
+    /** @brief Callbacks waiting for the outcome of the validation */
+    std::vector<Callback> waiting;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -4,9 +4,11 @@
 #include "update_manager.hpp"
 
 #include <libpldm/firmware_update.h>
+#include <unistd.h>
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <functional>
 
 PHOSPHOR_LOG2_USING;
@@ -19,6 +21,7 @@ namespace fw_update
 
 void DeviceUpdater::startFwUpdateFlow()
 {
+    enterPhase(UpdatePhase::RequestUpdate);
     auto instanceId = updateManager->instanceIdDb.next(eid);
     // NumberOfComponents
     const auto& applicableComponents =
@@ -53,6 +56,8 @@ void DeviceUpdater::startFwUpdateFlow()
         error(
             "Failed to encode request update request for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
+        return;
     }
 
     rc = updateManager->handler.registerRequest(
@@ -64,6 +69,7 @@ void DeviceUpdater::startFwUpdateFlow()
         error(
             "Failed to send request update for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
     }
 }
 
@@ -75,6 +81,7 @@ void DeviceUpdater::requestUpdate(mctp_eid_t eid, const pldm_msg* response,
         // Handle error scenario
         error("No response received for request update for endpoint ID '{EID}'",
               "EID", unsigned(eid));
+        updateCompleted(false);
         return;
     }
 
@@ -89,6 +96,7 @@ void DeviceUpdater::requestUpdate(mctp_eid_t eid, const pldm_msg* response,
         error(
             "Failed to decode request update response for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
         return;
     }
     if (completionCode)
@@ -96,10 +104,12 @@ void DeviceUpdater::requestUpdate(mctp_eid_t eid, const pldm_msg* response,
         error(
             "Failure in request update response for endpoint ID '{EID}', completion code '{CC}'",
             "EID", unsigned(eid), "CC", unsigned(completionCode));
+        updateCompleted(false);
         return;
     }
 
     // Optional fields DeviceMetaData and GetPackageData not handled
+    enterPhase(UpdatePhase::PassComponentTable);
     pldmRequest = std::make_unique<sdeventplus::source::Defer>(
         updateManager->event,
         std::bind(&DeviceUpdater::sendPassCompTableRequest, this,
@@ -181,6 +191,8 @@ void DeviceUpdater::sendPassCompTableRequest(size_t offset)
         error(
             "Failed to encode pass component table req for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
+        return;
     }
 
     rc = updateManager->handler.registerRequest(
@@ -193,6 +205,7 @@ void DeviceUpdater::sendPassCompTableRequest(size_t offset)
         error(
             "Failed to send pass component table request for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
     }
 }
 
@@ -205,6 +218,7 @@ void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
         error(
             "No response received for pass component table for endpoint ID '{EID}'",
             "EID", unsigned(eid));
+        updateCompleted(false);
         return;
     }
 
@@ -221,6 +235,7 @@ void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
         error(
             "Failed to decode pass component table response for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
         return;
     }
     if (completionCode)
@@ -229,6 +244,7 @@ void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
         error(
             "Failed to pass component table response for endpoint ID '{EID}', completion code '{CC}'",
             "EID", unsigned(eid), "CC", unsigned(completionCode));
+        updateCompleted(false);
         return;
     }
     // Handle ComponentResponseCode
@@ -238,10 +254,9 @@ void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
     if (componentIndex == applicableComponents.size() - 1)
     {
         componentIndex = 0;
-        pldmRequest = std::make_unique<sdeventplus::source::Defer>(
-            updateManager->event,
-            std::bind(&DeviceUpdater::sendUpdateComponentRequest, this,
-                      componentIndex));
+        // The component images are verified in the background, the transfer
+        // starts once they are known to be good
+        updateManager->awaitComponentValidation(eid);
     }
     else
     {
@@ -253,6 +268,24 @@ void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
     }
 }
 
+void DeviceUpdater::componentValidationCompleted(bool status)
+{
+    if (!status)
+    {
+        error(
+            "Failed to validate the component images, aborting the firmware update of endpoint ID '{EID}'",
+            "EID", unsigned(eid));
+        updateCompleted(false);
+        return;
+    }
+
+    enterPhase(UpdatePhase::UpdateComponent);
+    pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+        updateManager->event,
+        std::bind(&DeviceUpdater::sendUpdateComponentRequest, this,
+                  componentIndex));
+}
+
 void DeviceUpdater::sendUpdateComponentRequest(size_t offset)
 {
     pldmRequest.reset();
@@ -313,6 +346,8 @@ void DeviceUpdater::sendUpdateComponentRequest(size_t offset)
         error(
             "Failed to encode update component req for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
+        return;
     }
 
     rc = updateManager->handler.registerRequest(
@@ -324,6 +359,7 @@ void DeviceUpdater::sendUpdateComponentRequest(size_t offset)
         error(
             "Failed to send update request for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
     }
 }
 
@@ -336,6 +372,7 @@ void DeviceUpdater::updateComponent(mctp_eid_t eid, const pldm_msg* response,
         error(
             "No response received for update component with endpoint ID {EID}",
             "EID", unsigned(eid));
+        updateCompleted(false);
         return;
     }
 
@@ -354,6 +391,7 @@ void DeviceUpdater::updateComponent(mctp_eid_t eid, const pldm_msg* response,
         error(
             "Failed to decode update request response for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
         return;
     }
     if (completionCode)
@@ -361,8 +399,13 @@ void DeviceUpdater::updateComponent(mctp_eid_t eid, const pldm_msg* response,
         error(
             "Failed to update request response for endpoint ID '{EID}', completion code '{CC}'",
             "EID", unsigned(eid), "CC", unsigned(completionCode));
+        updateCompleted(false);
         return;
     }
+
+    // The FD requests the firmware data from now on
+    enterPhase(UpdatePhase::Transfer);
+    lastFwDataRequest.reset();
 }
 
 Response DeviceUpdater::requestFwData(const pldm_msg* request,
@@ -392,13 +435,25 @@ Response DeviceUpdater::requestFwData(const pldm_msg* request,
         return response;
     }
 
+    watchInactivity();
+
     const auto& applicableComponents =
         std::get<ApplicableComponents>(fwDeviceIDRecord);
     const auto& comp = compImageInfos[applicableComponents[componentIndex]];
     auto compOffset = std::get<5>(comp);
     auto compSize = std::get<6>(comp);
-    info("Decoded fw request data at offset '{OFFSET}' and length '{LENGTH}' ",
-         "OFFSET", unsigned(offset), "LENGTH", unsigned(length));
+    // Logging every request floods the journal when many devices update
+    fwDataRequests++;
+    auto logTime = std::chrono::steady_clock::now();
+    if (logTime - lastFwDataLog >= fwDataLogInterval)
+    {
+        info(
+            "Decoded fw request data at offset '{OFFSET}' and length '{LENGTH}' for endpoint ID '{EID}', {COUNT} requests since the last entry",
+            "OFFSET", unsigned(offset), "LENGTH", unsigned(length), "EID",
+            unsigned(eid), "COUNT", fwDataRequests);
+        lastFwDataLog = logTime;
+        fwDataRequests = 0;
+    }
     if (length < PLDM_FWUP_BASELINE_TRANSFER_SIZE || length > maxTransferSize)
     {
         rc = encode_request_firmware_data_resp(
@@ -413,7 +468,9 @@ Response DeviceUpdater::requestFwData(const pldm_msg* request,
         return response;
     }
 
-    if (offset + length > compSize + PLDM_FWUP_BASELINE_TRANSFER_SIZE)
+    if (offset + length > compSize + PLDM_FWUP_BASELINE_TRANSFER_SIZE ||
+        compOffset + std::min<size_t>(offset + length, compSize) >
+            packageSize)
     {
         rc = encode_request_firmware_data_resp(
             request->hdr.instance_id, PLDM_FWUP_DATA_OUT_OF_RANGE, responseMsg,
@@ -433,13 +490,41 @@ Response DeviceUpdater::requestFwData(const pldm_msg* request,
         padBytes = offset + length - compSize;
     }
 
+    auto now = std::chrono::steady_clock::now();
+    if (lastFwDataRequest)
+    {
+        auto latency = now - *lastFwDataRequest;
+        metrics.totalChunkLatency += latency;
+        metrics.maxChunkLatency = std::max(metrics.maxChunkLatency, latency);
+    }
+    lastFwDataRequest = now;
+
+    // The firmware data is read once from the package, the pad bytes past the
+    // end of the component are left 0
     response.resize(sizeof(pldm_msg_hdr) + sizeof(completionCode) + length);
     responseMsg = reinterpret_cast<pldm_msg*>(response.data());
-    package.seekg(compOffset + offset);
-    package.read(reinterpret_cast<char*>(response.data() +
-                                         sizeof(pldm_msg_hdr) +
-                                         sizeof(completionCode)),
-                 length - padBytes);
+    auto readLength = length - padBytes;
+    auto bytesRead = pread(packageFd,
+                           response.data() + sizeof(pldm_msg_hdr) +
+                               sizeof(completionCode),
+                           readLength, compOffset + offset);
+    if (bytesRead < 0 || static_cast<size_t>(bytesRead) != readLength)
+    {
+        // The package file is truncated or failing
+        error(
+            "Failed to read firmware data at offset '{OFFSET}' and length '{LENGTH}' for endpoint ID '{EID}', error - {ERROR}",
+            "OFFSET", unsigned(offset), "LENGTH", unsigned(length), "EID",
+            unsigned(eid), "ERROR", bytesRead < 0 ? errno : 0);
+        response.resize(sizeof(pldm_msg_hdr) + sizeof(completionCode));
+        responseMsg = reinterpret_cast<pldm_msg*>(response.data());
+        completionCode =
+            bytesRead < 0 ? PLDM_ERROR : PLDM_FWUP_DATA_OUT_OF_RANGE;
+    }
+    else
+    {
+        metrics.chunks++;
+        metrics.bytesTransferred += readLength;
+    }
     rc = encode_request_firmware_data_resp(request->hdr.instance_id,
                                            completionCode, responseMsg,
                                            sizeof(completionCode));
@@ -481,11 +566,27 @@ Response DeviceUpdater::transferComplete(const pldm_msg* request,
         return response;
     }
 
+    if (phase != UpdatePhase::Transfer)
+    {
+        // The update of the FD has been cancelled or has ended
+        rc = encode_transfer_complete_resp(
+            request->hdr.instance_id, PLDM_FWUP_COMMAND_NOT_EXPECTED,
+            responseMsg, sizeof(completionCode));
+        if (rc)
+        {
+            error(
+                "Failed to encode TransferComplete response for endpoint ID '{EID}', response code '{RC}'",
+                "EID", unsigned(eid), "RC", rc);
+        }
+        return response;
+    }
+
     const auto& applicableComponents =
         std::get<ApplicableComponents>(fwDeviceIDRecord);
     const auto& comp = compImageInfos[applicableComponents[componentIndex]];
     const auto& compVersion = std::get<7>(comp);
 
+    enterPhase(UpdatePhase::Verify);
     if (transferResult == PLDM_FWUP_TRANSFER_SUCCESS)
     {
         info(
@@ -498,6 +599,7 @@ Response DeviceUpdater::transferComplete(const pldm_msg* request,
             "Failure in transfer of the component endpoint ID '{EID}' and version '{COMPONENT_VERSION}' with transfer result - {RESULT}",
             "EID", unsigned(eid), "COMPONENT_VERSION", compVersion, "RESULT",
             unsigned(transferResult));
+        abortUpdate();
     }
 
     rc = encode_transfer_complete_resp(request->hdr.instance_id, completionCode,
@@ -539,11 +641,27 @@ Response DeviceUpdater::verifyComplete(const pldm_msg* request,
         return response;
     }
 
+    if (phase != UpdatePhase::Verify)
+    {
+        // The update of the FD has been cancelled or has ended
+        rc = encode_verify_complete_resp(request->hdr.instance_id,
+                                         PLDM_FWUP_COMMAND_NOT_EXPECTED,
+                                         responseMsg, sizeof(completionCode));
+        if (rc)
+        {
+            error(
+                "Failed to encode VerifyComplete response for endpoint ID '{EID}', response code '{RC}'",
+                "EID", unsigned(eid), "RC", rc);
+        }
+        return response;
+    }
+
     const auto& applicableComponents =
         std::get<ApplicableComponents>(fwDeviceIDRecord);
     const auto& comp = compImageInfos[applicableComponents[componentIndex]];
     const auto& compVersion = std::get<7>(comp);
 
+    enterPhase(UpdatePhase::Apply);
     if (verifyResult == PLDM_FWUP_VERIFY_SUCCESS)
     {
         info(
@@ -556,6 +674,7 @@ Response DeviceUpdater::verifyComplete(const pldm_msg* request,
             "Failed to verify component endpoint ID '{EID}' and version '{COMPONENT_VERSION}' with transfer result - '{RESULT}'",
             "EID", unsigned(eid), "COMPONENT_VERSION", compVersion, "RESULT",
             unsigned(verifyResult));
+        abortUpdate();
     }
 
     rc = encode_verify_complete_resp(request->hdr.instance_id, completionCode,
@@ -599,13 +718,30 @@ Response DeviceUpdater::applyComplete(const pldm_msg* request,
         return response;
     }
 
+    if (phase != UpdatePhase::Apply)
+    {
+        // The update of the FD has been cancelled or has ended
+        rc = encode_apply_complete_resp(request->hdr.instance_id,
+                                        PLDM_FWUP_COMMAND_NOT_EXPECTED,
+                                        responseMsg, sizeof(completionCode));
+        if (rc)
+        {
+            error(
+                "Failed to encode ApplyComplete response for endpoint ID '{EID}', response code '{RC}'",
+                "EID", unsigned(eid), "RC", rc);
+        }
+        return response;
+    }
+
     const auto& applicableComponents =
         std::get<ApplicableComponents>(fwDeviceIDRecord);
     const auto& comp = compImageInfos[applicableComponents[componentIndex]];
     const auto& compVersion = std::get<7>(comp);
 
-    if (applyResult == PLDM_FWUP_APPLY_SUCCESS ||
-        applyResult == PLDM_FWUP_APPLY_SUCCESS_WITH_ACTIVATION_METHOD)
+    bool applied =
+        applyResult == PLDM_FWUP_APPLY_SUCCESS ||
+        applyResult == PLDM_FWUP_APPLY_SUCCESS_WITH_ACTIVATION_METHOD;
+    if (applied)
     {
         info(
             "Component endpoint ID '{EID}' with '{COMPONENT_VERSION}' apply complete.",
@@ -618,6 +754,7 @@ Response DeviceUpdater::applyComplete(const pldm_msg* request,
             "Failed to apply component endpoint ID '{EID}' and version '{COMPONENT_VERSION}', error - {ERROR}",
             "EID", unsigned(eid), "COMPONENT_VERSION", compVersion, "ERROR",
             unsigned(applyResult));
+        abortUpdate();
     }
 
     rc = encode_apply_complete_resp(request->hdr.instance_id, completionCode,
@@ -630,9 +767,15 @@ Response DeviceUpdater::applyComplete(const pldm_msg* request,
         return response;
     }
 
+    if (!applied)
+    {
+        return response;
+    }
+
     if (componentIndex == applicableComponents.size() - 1)
     {
         componentIndex = 0;
+        enterPhase(UpdatePhase::Activate);
         pldmRequest = std::make_unique<sdeventplus::source::Defer>(
             updateManager->event,
             std::bind(&DeviceUpdater::sendActivateFirmwareRequest, this));
@@ -640,6 +783,7 @@ Response DeviceUpdater::applyComplete(const pldm_msg* request,
     else
     {
         componentIndex++;
+        enterPhase(UpdatePhase::UpdateComponent);
         pldmRequest = std::make_unique<sdeventplus::source::Defer>(
             updateManager->event,
             std::bind(&DeviceUpdater::sendUpdateComponentRequest, this,
@@ -666,6 +810,8 @@ void DeviceUpdater::sendActivateFirmwareRequest()
         error(
             "Failed to encode activate firmware req for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
+        return;
     }
 
     rc = updateManager->handler.registerRequest(
@@ -676,6 +822,7 @@ void DeviceUpdater::sendActivateFirmwareRequest()
         error(
             "Failed to send activate firmware request for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
     }
 }
 
@@ -688,6 +835,7 @@ void DeviceUpdater::activateFirmware(mctp_eid_t eid, const pldm_msg* response,
         error(
             "No response received for activate firmware for endpoint ID '{EID}'",
             "EID", eid);
+        updateCompleted(false);
         return;
     }
 
@@ -702,6 +850,7 @@ void DeviceUpdater::activateFirmware(mctp_eid_t eid, const pldm_msg* response,
         error(
             "Failed to decode activate firmware response for endpoint ID '{EID}', response code '{RC}'",
             "EID", eid, "RC", rc);
+        updateCompleted(false);
         return;
     }
     if (completionCode)
@@ -710,12 +859,143 @@ void DeviceUpdater::activateFirmware(mctp_eid_t eid, const pldm_msg* response,
         error(
             "Failed to activate firmware response for endpoint ID '{EID}', completion code '{CC}'",
             "EID", eid, "CC", completionCode);
+        updateCompleted(false);
         return;
     }
 
-    updateManager->updateDeviceCompletion(eid, true);
+    updateCompleted(true);
 }
 
+void DeviceUpdater::abortUpdate()
+{
+    if (!phase || phase == UpdatePhase::Cancel)
+    {
+        // The flow of the FD has already ended or is being cancelled
+        return;
+    }
+    if (!updateManager)
+    {
+        updateCompleted(false);
+        return;
+    }
+    enterPhase(UpdatePhase::Cancel);
+    pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+        updateManager->event,
+        std::bind(&DeviceUpdater::sendCancelUpdateRequest, this));
+}
+
+void DeviceUpdater::sendCancelUpdateRequest()
+{
+    pldmRequest.reset();
+    auto instanceId = updateManager->instanceIdDb.next(eid);
+    Request request(sizeof(pldm_msg_hdr) + PLDM_CANCEL_UPDATE_REQ_BYTES);
+    auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+
+    auto rc = encode_cancel_update_req(instanceId, requestMsg,
+                                       PLDM_CANCEL_UPDATE_REQ_BYTES);
+    if (rc)
+    {
+        updateManager->instanceIdDb.free(eid, instanceId);
+        error(
+            "Failed to encode cancel update request for endpoint ID '{EID}', response code '{RC}'",
+            "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
+        return;
+    }
+
+    rc = updateManager->handler.registerRequest(
+        eid, instanceId, PLDM_FWUP, PLDM_CANCEL_UPDATE, std::move(request),
+        std::move(std::bind_front(&DeviceUpdater::cancelUpdate, this)));
+    if (rc)
+    {
+        error(
+            "Failed to send cancel update request for endpoint ID '{EID}', response code '{RC}'",
+            "EID", unsigned(eid), "RC", rc);
+        updateCompleted(false);
+    }
+}
+
+void DeviceUpdater::cancelUpdate(mctp_eid_t eid, const pldm_msg* response,
+                                 size_t respMsgLen)
+{
+    // The update of the FD has failed whatever the outcome of the command
+    if (response == nullptr || !respMsgLen)
+    {
+        error("No response received for cancel update for endpoint ID '{EID}'",
+              "EID", unsigned(eid));
+        updateCompleted(false);
+        return;
+    }
+
+    uint8_t completionCode = 0;
+    bool8_t nonFunctioningComponentIndication = 0;
+    bitfield64_t nonFunctioningComponentBitmap{};
+    auto rc = decode_cancel_update_resp(response, respMsgLen, &completionCode,
+                                        &nonFunctioningComponentIndication,
+                                        &nonFunctioningComponentBitmap);
+    if (rc)
+    {
+        error(
+            "Failed to decode cancel update response for endpoint ID '{EID}', response code '{RC}'",
+            "EID", unsigned(eid), "RC", rc);
+    }
+    else if (completionCode)
+    {
+        error(
+            "Failed to cancel update for endpoint ID '{EID}', completion code '{CC}'",
+            "EID", unsigned(eid), "CC", unsigned(completionCode));
+    }
+    else if (nonFunctioningComponentIndication)
+    {
+        error(
+            "Components of endpoint ID '{EID}' are not functioning after the cancelled update, bitmap '{BITMAP}'",
+            "EID", unsigned(eid), "BITMAP", lg2::hex,
+            nonFunctioningComponentBitmap.value);
+    }
+    updateCompleted(false);
+}
+
+void DeviceUpdater::enterPhase(std::optional<UpdatePhase> nextPhase)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (phase)
+    {
+        metrics.phaseTimes[static_cast<size_t>(*phase)] += now - phaseStart;
+    }
+    phase = nextPhase;
+    phaseStart = now;
+    watchInactivity();
+}
+
+void DeviceUpdater::watchInactivity()
+{
+    bool fdDriven = phase == UpdatePhase::Transfer ||
+                    phase == UpdatePhase::Verify ||
+                    phase == UpdatePhase::Apply;
+    if (!fdDriven || !updateManager || inactivityTimeout.count() == 0)
+    {
+        if (inactivityTimer)
+        {
+            inactivityTimer->setEnabled(false);
+        }
+        return;
+    }
+
+    if (!inactivityTimer)
+    {
+        inactivityTimer = std::make_unique<
+            sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>(
+            updateManager->event, [this](auto&) {
+            error(
+                "No command received from endpoint ID '{EID}' in {TIMEOUT} seconds, cancelling its firmware update",
+                "EID", unsigned(eid), "TIMEOUT", inactivityTimeout.count());
+            abortUpdate();
+        });
+    }
+    inactivityTimer->restartOnce(inactivityTimeout);
+}
+
+
 } // namespace fw_update
 
 } // namespace pldm
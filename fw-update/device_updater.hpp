@@ -6,8 +6,11 @@
 
 #include <sdeventplus/event.hpp>
 #include <sdeventplus/source/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
 
-#include <fstream>
+#include <array>
+#include <chrono>
+#include <optional>
 
 namespace pldm
 {
@@ -17,6 +20,61 @@ namespace fw_update
 
 class UpdateManager;
 
+/** @brief Phases of the firmware update flow of a firmware device */
+enum class UpdatePhase
+{
+    RequestUpdate,
+    PassComponentTable,
+    UpdateComponent,
+    Transfer,
+    Verify,
+    Apply,
+    Activate,
+    Cancel,
+};
+
+constexpr size_t numUpdatePhases =
+    static_cast<size_t>(UpdatePhase::Cancel) + 1;
+
+/** @struct DeviceUpdateMetrics
+ *
+ *  Time spent in each phase of the firmware update of a firmware device and
+ *  the throughput of its firmware data transfer
+ */
+struct DeviceUpdateMetrics
+{
+    using Duration = std::chrono::steady_clock::duration;
+
+    std::array<Duration, numUpdatePhases> phaseTimes{};
+    uint64_t bytesTransferred = 0; //!< firmware data, without pad bytes
+    uint64_t chunks = 0;           //!< RequestFirmwareData requests served
+    /** @brief Time between consecutive RequestFirmwareData requests */
+    Duration totalChunkLatency{};
+    Duration maxChunkLatency{};
+
+    /** @brief Time spent in a phase */
+    Duration phaseTime(UpdatePhase phase) const
+    {
+        return phaseTimes[static_cast<size_t>(phase)];
+    }
+
+    /** @brief Firmware data throughput over the transfer phases */
+    double bytesPerSecond() const
+    {
+        auto seconds = std::chrono::duration<double>(
+                           phaseTime(UpdatePhase::Transfer))
+                           .count();
+        return seconds > 0 ? bytesTransferred / seconds : 0;
+    }
+
+    /** @brief Average time between consecutive RequestFirmwareData requests
+     */
+    Duration averageChunkLatency() const
+    {
+        return chunks > 1 ? totalChunkLatency / (chunks - 1) : Duration{};
+    }
+};
+
 /** @class DeviceUpdater
  *
  *  DeviceUpdater orchestrates the firmware update of the firmware device and
@@ -35,7 +93,8 @@ class DeviceUpdater
     /** @brief Constructor
      *
      *  @param[in] eid - Endpoint ID of the firmware device
-     *  @param[in] package - File stream for firmware update package
+     *  @param[in] packageFd - File descriptor of the firmware update package
+     *  @param[in] packageSize - Size of the firmware update package
      *  @param[in] fwDeviceIDRecord - FirmwareDeviceIDRecord in the fw update
      *                                package that matches this firmware device
      *  @param[in] compImageInfos - Component image information for all the
@@ -47,14 +106,16 @@ class DeviceUpdater
      *  @param[in] updateManager - To update the status of fw update of the
      *                             device
      */
-    explicit DeviceUpdater(mctp_eid_t eid, std::ifstream& package,
+    explicit DeviceUpdater(mctp_eid_t eid, int packageFd,
+                           uintmax_t packageSize,
                            const FirmwareDeviceIDRecord& fwDeviceIDRecord,
                            const ComponentImageInfos& compImageInfos,
                            const ComponentInfo& compInfo,
                            uint32_t maxTransferSize,
                            UpdateManager* updateManager) :
         eid(eid),
-        package(package), fwDeviceIDRecord(fwDeviceIDRecord),
+        packageFd(packageFd), packageSize(packageSize),
+        fwDeviceIDRecord(fwDeviceIDRecord),
         compImageInfos(compImageInfos), compInfo(compInfo),
         maxTransferSize(maxTransferSize), updateManager(updateManager)
     {}
@@ -98,6 +159,16 @@ class DeviceUpdater
     void passCompTable(mctp_eid_t eid, const pldm_msg* response,
                        size_t respMsgLen);
 
+    /** @brief Continue the update flow once the UpdateManager has validated
+     *         the component images of the package
+     *
+     *  The PassComponentTable phase ends by waiting for the validation, on
+     *  success the UpdateComponent command is sent for the first component.
+     *
+     *  @param[in] status - true if the component images are valid
+     */
+    void componentValidationCompleted(bool status);
+
     /** @brief Handler for UpdateComponent command response
      *
      *  The response of the UpdateComponent is processed and will wait for
@@ -154,7 +225,27 @@ class DeviceUpdater
     void activateFirmware(mctp_eid_t eid, const pldm_msg* response,
                           size_t respMsgLen);
 
+    /** @brief Metrics of the firmware update of the FD */
+    const DeviceUpdateMetrics& getMetrics() const
+    {
+        return metrics;
+    }
+
   private:
+    /** @brief Account the time spent in the current phase and move to the
+     *         next phase of the firmware update flow
+     *
+     *  @param[in] phase - the next phase, std::nullopt when the flow ends
+     */
+    void enterPhase(std::optional<UpdatePhase> phase);
+
+    /** @brief End the firmware update flow of the FD and report the result to
+     *         the UpdateManager
+     *
+     *  @param[in] status - true if the firmware update succeeded
+     */
+    void updateCompleted(bool status);
+
     /** @brief Send PassComponentTable command request
      *
      *  @param[in] compOffset - component offset in compImageInfos
@@ -170,11 +261,39 @@ class DeviceUpdater
     /** @brief Send ActivateFirmware command request */
     void sendActivateFirmwareRequest();
 
+    /** @brief Cancel the update of the FD after a failure, the flow ends once
+     *         the FD answers the CancelUpdate command
+     */
+    void abortUpdate();
+
+    /** @brief Send CancelUpdate command request */
+    void sendCancelUpdateRequest();
+
+    /** @brief Handler for CancelUpdate command response
+     *
+     *  @param[in] eid - Remote MCTP endpoint
+     *  @param[in] response - PLDM response message
+     *  @param[in] respMsgLen - Response message length
+     */
+    void cancelUpdate(mctp_eid_t eid, const pldm_msg* response,
+                      size_t respMsgLen);
+
+    /** @brief Restart the inactivity timer while the FD drives the flow and
+     *         stop it otherwise
+     */
+    void watchInactivity();
+
     /** @brief Endpoint ID of the firmware device */
     mctp_eid_t eid;
 
-    /** @brief File stream for firmware update package */
-    std::ifstream& package;
+    /** @brief File descriptor of the firmware update package, the firmware
+     *         data is read from it straight into the RequestFirmwareData
+     *         response
+     */
+    int packageFd;
+
+    /** @brief Size of the firmware update package when it was opened */
+    uintmax_t packageSize;
 
     /** @brief FirmwareDeviceIDRecord in the fw update package that matches this
      *         firmware device
@@ -208,6 +327,39 @@ class DeviceUpdater
 
     /** @brief To send a PLDM request after the current command handling */
     std::unique_ptr<sdeventplus::source::Defer> pldmRequest;
+
+    /** @brief Time of the last RequestFirmwareData journal entry, the requests
+     *         are logged at most once per fwDataLogInterval
+     */
+    std::chrono::steady_clock::time_point lastFwDataLog{};
+
+    /** @brief Number of RequestFirmwareData requests since the last journal
+     *         entry
+     */
+    size_t fwDataRequests = 0;
+
+    static constexpr std::chrono::seconds fwDataLogInterval{5};
+
+    /** @brief Metrics of the firmware update of the FD */
+    DeviceUpdateMetrics metrics;
+
+    /** @brief Current phase of the firmware update flow and when it started
+     */
+    std::optional<UpdatePhase> phase;
+    std::chrono::steady_clock::time_point phaseStart{};
+
+    /** @brief Time of the previous RequestFirmwareData request */
+    std::optional<std::chrono::steady_clock::time_point> lastFwDataRequest;
+
+    /** @brief Cancels the update if the FD stops sending commands while it
+     *         transfers, verifies and applies a component
+     */
+    std::unique_ptr<
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
+        inactivityTimer;
+
+    static constexpr std::chrono::seconds inactivityTimeout{
+        FW_UPDATE_INACTIVITY_TIMEOUT_SECONDS};
 };
 
 } // namespace fw_update
@@ -7,6 +7,7 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <functional>
 
 PHOSPHOR_LOG2_USING;
@@ -19,35 +20,51 @@ void InventoryManager::discoverFDs(const std::vector<mctp_eid_t>& eids)
 {
     for (const auto& eid : eids)
     {
-        auto instanceId = instanceIdDb.next(eid);
-        Request requestMsg(sizeof(pldm_msg_hdr) +
-                           PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES);
-        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-        auto rc = encode_query_device_identifiers_req(
-            instanceId, PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES, request);
-        if (rc)
+        auto record = inventoryRecords.find(eid);
+        if (record != inventoryRecords.end() &&
+            !record->second.fwParams.empty() && descriptorMap.contains(eid) &&
+            componentInfoMap.contains(eid))
         {
-            instanceIdDb.free(eid, instanceId);
-            error(
-                "Failed to encode query device identifiers req for endpoint ID '{EID}', response code '{RC}'",
-                "EID", unsigned(eid), "RC", rc);
-            continue;
+            revalidatingFDs.emplace(eid);
+            sendGetFirmwareParametersRequest(eid);
         }
-
-        rc = handler.registerRequest(
-            eid, instanceId, PLDM_FWUP, PLDM_QUERY_DEVICE_IDENTIFIERS,
-            std::move(requestMsg),
-            std::move(std::bind_front(&InventoryManager::queryDeviceIdentifiers,
-                                      this)));
-        if (rc)
+        else
         {
-            error(
-                "Failed to send query device identifiers request for endpoint ID '{EID}', response code '{RC}'",
-                "EID", unsigned(eid), "RC", rc);
+            sendQueryDeviceIdentifiersRequest(eid);
         }
     }
 }
 
+void InventoryManager::sendQueryDeviceIdentifiersRequest(mctp_eid_t eid)
+{
+    auto instanceId = instanceIdDb.next(eid);
+    Request requestMsg(sizeof(pldm_msg_hdr) +
+                       PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    auto rc = encode_query_device_identifiers_req(
+        instanceId, PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES, request);
+    if (rc)
+    {
+        instanceIdDb.free(eid, instanceId);
+        error(
+            "Failed to encode query device identifiers req for endpoint ID '{EID}', response code '{RC}'",
+            "EID", unsigned(eid), "RC", rc);
+        return;
+    }
+
+    rc = handler.registerRequest(
+        eid, instanceId, PLDM_FWUP, PLDM_QUERY_DEVICE_IDENTIFIERS,
+        std::move(requestMsg),
+        std::move(
+            std::bind_front(&InventoryManager::queryDeviceIdentifiers, this)));
+    if (rc)
+    {
+        error(
+            "Failed to send query device identifiers request for endpoint ID '{EID}', response code '{RC}'",
+            "EID", unsigned(eid), "RC", rc);
+    }
+}
+
 void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
                                               const pldm_msg* response,
                                               size_t respMsgLen)
@@ -145,7 +162,7 @@ void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
         deviceIdentifiersLen -= nextDescriptorOffset;
     }
 
-    descriptorMap.emplace(eid, std::move(descriptors));
+    descriptorMap.insert_or_assign(eid, std::move(descriptors));
 
     // Send GetFirmwareParameters request
     sendGetFirmwareParametersRequest(eid);
@@ -178,6 +195,7 @@ void InventoryManager::sendGetFirmwareParametersRequest(mctp_eid_t eid)
         error(
             "Failed to send get firmware parameters request for endpoint ID '{EID}', response code '{RC}'",
             "EID", unsigned(eid), "RC", rc);
+        revalidatingFDs.erase(eid);
     }
 }
 
@@ -185,12 +203,34 @@ void InventoryManager::getFirmwareParameters(mctp_eid_t eid,
                                              const pldm_msg* response,
                                              size_t respMsgLen)
 {
+    bool revalidating = revalidatingFDs.erase(eid);
     if (response == nullptr || !respMsgLen)
     {
         error(
             "No response received for get firmware parameters for endpoint ID '{EID}'",
             "EID", unsigned(eid));
         descriptorMap.erase(eid);
+        inventoryRecords.erase(eid);
+        return;
+    }
+
+    if (revalidating)
+    {
+        auto& record = inventoryRecords[eid];
+        if (std::equal(record.fwParams.begin(), record.fwParams.end(),
+                       response->payload, response->payload + respMsgLen))
+        {
+            info(
+                "Firmware inventory of endpoint ID '{EID}' is unchanged, keeping generation {GENERATION}",
+                "EID", unsigned(eid), "GENERATION", record.generation);
+            return;
+        }
+
+        info(
+            "Firmware inventory of endpoint ID '{EID}' has changed, discovering it again",
+            "EID", unsigned(eid));
+        record.fwParams.clear();
+        sendQueryDeviceIdentifiersRequest(eid);
         return;
     }
 
@@ -248,7 +288,10 @@ void InventoryManager::getFirmwareParameters(mctp_eid_t eid,
         compParamTableLen -= sizeof(pldm_component_parameter_entry) +
                              activeCompVerStr.length + pendingCompVerStr.length;
     }
-    componentInfoMap.emplace(eid, std::move(componentInfo));
+    componentInfoMap.insert_or_assign(eid, std::move(componentInfo));
+    auto& record = inventoryRecords[eid];
+    record.fwParams.assign(response->payload, response->payload + respMsgLen);
+    record.generation++;
 }
 
 } // namespace fw_update
@@ -4,6 +4,10 @@
 #include "common/types.hpp"
 #include "requester/handler.hpp"
 
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 namespace pldm
 {
 
@@ -52,10 +56,30 @@ class InventoryManager
      *  commands are sent to every FD and the response is used to populate
      *  the firmware identifiers and component details of the FDs.
      *
+     *  An FD discovered before, for instance across a transient MCTP bus
+     *  reset, is only sent GetFirmwareParameters. If the response matches
+     *  the one the inventory was populated from the inventory is kept as is,
+     *  otherwise the FD is discovered again from scratch. The requests of
+     *  different FDs are in flight concurrently.
+     *
      *  @param[in] eids - MCTP endpoint ID of the FDs
      */
     void discoverFDs(const std::vector<mctp_eid_t>& eids);
 
+    /** @brief Get the generation of the inventory of an FD, which is bumped
+     *         each time the inventory of the FD is populated
+     *
+     *  @param[in] eid - MCTP endpoint ID of the FD
+     *
+     *  @return the generation, 0 if the FD has not been discovered
+     */
+    uint64_t getGeneration(mctp_eid_t eid) const
+    {
+        auto search = inventoryRecords.find(eid);
+        return search == inventoryRecords.end() ? 0
+                                                : search->second.generation;
+    }
+
     /** @brief Handler for QueryDeviceIdentifiers command response
      *
      *  The response of the QueryDeviceIdentifiers is processed and firmware
@@ -82,6 +106,12 @@ class InventoryManager
                                size_t respMsgLen);
 
   private:
+    /** @brief Send QueryDeviceIdentifiers command request
+     *
+     *  @param[in] eid - Remote MCTP endpoint
+     */
+    void sendQueryDeviceIdentifiersRequest(mctp_eid_t eid);
+
     /** @brief Send GetFirmwareParameters command request
      *
      *  @param[in] eid - Remote MCTP endpoint
@@ -99,6 +129,25 @@ class InventoryManager
 
     /** @brief Component information needed for the update of the managed FDs */
     ComponentInfoMap& componentInfoMap;
+
+    /** @struct InventoryRecord
+     *
+     *  What the inventory of an FD was populated from
+     */
+    struct InventoryRecord
+    {
+        uint64_t generation = 0;
+        /** @brief Payload of the GetFirmwareParameters response */
+        std::vector<uint8_t> fwParams;
+    };
+
+    /** @brief Inventory records of the discovered FDs */
+    std::unordered_map<mctp_eid_t, InventoryRecord> inventoryRecords;
+
+    /** @brief FDs whose cached inventory is being revalidated with
+     *         GetFirmwareParameters
+     */
+    std::unordered_set<mctp_eid_t> revalidatingFDs;
 };
 
 } // namespace fw_update
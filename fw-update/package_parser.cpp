@@ -3,7 +3,6 @@
 #include "common/utils.hpp"
 
 #include <libpldm/firmware_update.h>
-#include <libpldm/utils.h>
 
 #include <phosphor-logging/lg2.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
@@ -22,7 +21,7 @@ using InternalFailure =
     sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
 
 size_t PackageParser::parseFDIdentificationArea(
-    DeviceIDRecordCount deviceIdRecCount, const std::vector<uint8_t>& pkgHdr,
+    DeviceIDRecordCount deviceIdRecCount, std::span<const uint8_t> pkgHdr,
     size_t offset)
 {
     size_t pkgHdrRemainingSize = pkgHdr.size() - offset;
@@ -141,7 +140,7 @@ size_t PackageParser::parseFDIdentificationArea(
 }
 
 size_t PackageParser::parseCompImageInfoArea(ComponentImageCount compImageCount,
-                                             const std::vector<uint8_t>& pkgHdr,
+                                             std::span<const uint8_t> pkgHdr,
                                              size_t offset)
 {
     size_t pkgHdrRemainingSize = pkgHdr.size() - offset;
@@ -221,8 +220,7 @@ void PackageParser::validatePkgTotalSize(uintmax_t pkgSize)
     }
 }
 
-void PackageParserV1::parse(const std::vector<uint8_t>& pkgHdr,
-                            uintmax_t pkgSize)
+void PackageParserV1::parse(std::span<const uint8_t> pkgHdr, uintmax_t pkgSize)
 {
     if (pkgHeaderSize != pkgHdr.size())
     {
@@ -239,6 +237,16 @@ void PackageParserV1::parse(const std::vector<uint8_t>& pkgHdr,
         throw InternalFailure();
     }
 
+    // The checksum is folded in area by area while the bytes just decoded are
+    // still in the cache, rather than in another walk over the header.
+    uint32_t calcChecksum = 0;
+    size_t checksummed = 0;
+    auto updateChecksum = [&](size_t end) {
+        calcChecksum = utils::calcCrc32(pkgHdr.data() + checksummed,
+                                        end - checksummed, calcChecksum);
+        checksummed = end;
+    };
+
     auto deviceIdRecCount = static_cast<DeviceIDRecordCount>(pkgHdr[offset]);
     offset += sizeof(DeviceIDRecordCount);
 
@@ -255,6 +263,7 @@ void PackageParserV1::parse(const std::vector<uint8_t>& pkgHdr,
               "PKG_HDR_SIZE", pkgHeaderSize);
         throw InternalFailure();
     }
+    updateChecksum(offset);
 
     auto compImageCount = static_cast<ComponentImageCount>(
         le16toh(pkgHdr[offset] | (pkgHdr[offset + 1] << 8)));
@@ -274,8 +283,8 @@ void PackageParserV1::parse(const std::vector<uint8_t>& pkgHdr,
               "PKG_HDR_SIZE", pkgHeaderSize);
         throw InternalFailure();
     }
+    updateChecksum(offset);
 
-    auto calcChecksum = crc32(pkgHdr.data(), offset);
     auto checksum = static_cast<PackageHeaderChecksum>(
         le32toh(pkgHdr[offset] | (pkgHdr[offset + 1] << 8) |
                 (pkgHdr[offset + 2] << 16) | (pkgHdr[offset + 3] << 24)));
@@ -291,7 +300,7 @@ void PackageParserV1::parse(const std::vector<uint8_t>& pkgHdr,
     validatePkgTotalSize(pkgSize);
 }
 
-std::unique_ptr<PackageParser> parsePkgHeader(std::vector<uint8_t>& pkgData)
+std::unique_ptr<PackageParser> parsePkgHeader(std::span<const uint8_t> pkgData)
 {
     constexpr std::array<uint8_t, PLDM_FWUP_UUID_LENGTH> hdrIdentifierv1{
         0xF0, 0x18, 0x87, 0x8C, 0xCB, 0x7D, 0x49, 0x43,
@@ -7,6 +7,7 @@
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <tuple>
 #include <vector>
 
@@ -52,15 +53,16 @@ class PackageParser
         componentBitmapBitLength(componentBitmapBitLength)
     {}
 
-    /** @brief Parse the firmware update package header
+    /** @brief Parse the firmware update package header in a single pass,
+     *         validating the package header checksum along the way
      *
-     *  @param[in] pkgHdr - Package header
+     *  @param[in] pkgHdr - Package header, typically a view into the mapping
+     *                      of the package
      *  @param[in] pkgSize - Size of the firmware update package
      *
      *  @note Throws exception is parsing fails
      */
-    virtual void parse(const std::vector<uint8_t>& pkgHdr,
-                       uintmax_t pkgSize) = 0;
+    virtual void parse(std::span<const uint8_t> pkgHdr, uintmax_t pkgSize) = 0;
 
     /** @brief Get firmware device ID records from the package
      *
@@ -100,7 +102,7 @@ class PackageParser
      *          device identification area, on error throw exception.
      */
     size_t parseFDIdentificationArea(DeviceIDRecordCount deviceIdRecCount,
-                                     const std::vector<uint8_t>& pkgHdr,
+                                     std::span<const uint8_t> pkgHdr,
                                      size_t offset);
 
     /** @brief Parse the component image information area
@@ -114,7 +116,7 @@ class PackageParser
      *          image information area, on error throw exception.
      */
     size_t parseCompImageInfoArea(ComponentImageCount compImageCount,
-                                  const std::vector<uint8_t>& pkgHdr,
+                                  std::span<const uint8_t> pkgHdr,
                                   size_t offset);
 
     /** @brief Validate the total size of the package
@@ -171,17 +173,20 @@ class PackageParserV1 final : public PackageParser
         PackageParser(pkgHeaderSize, pkgVersion, componentBitmapBitLength)
     {}
 
-    virtual void parse(const std::vector<uint8_t>& pkgHdr, uintmax_t pkgSize);
+    virtual void parse(std::span<const uint8_t> pkgHdr, uintmax_t pkgSize);
 };
 
 /** @brief Parse the package header information
  *
- *  @param[in] pkgHdrInfo - package header information section in the package
+ *  @param[in] pkgHdrInfo - package header information section in the package,
+ *                          it is fine to pass the whole package as only the
+ *                          package header information is looked at
  *
  *  @return On success return the PackageParser for the header format version
  *          on failure return nullptr
  */
-std::unique_ptr<PackageParser> parsePkgHeader(std::vector<uint8_t>& pkgHdrInfo);
+std::unique_ptr<PackageParser>
+    parsePkgHeader(std::span<const uint8_t> pkgHdrInfo);
 
 } // namespace fw_update
 
@@ -0,0 +1,121 @@
+#include "fw-update/component_validator.hpp"
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <sdeventplus/event.hpp>
+
+#include <optional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace pldm::fw_update;
+
+class ComponentValidatorTest : public testing::Test
+{
+  protected:
+    ComponentValidatorTest() : event(sdeventplus::Event::get_new())
+    {
+        char tmpFile[] = "/tmp/pldm_fw_pkg_XXXXXX";
+        fd = mkstemp(tmpFile);
+        unlink(tmpFile);
+
+        // A component spanning several slices after a 139 byte header
+        std::vector<uint8_t> package(139 + 600 * 1024, 0x5A);
+        if (write(fd, package.data(), package.size()) !=
+            static_cast<ssize_t>(package.size()))
+        {
+            close(fd);
+            fd = -1;
+        }
+        compImageInfos = {
+            {10, 100, 0xFFFFFFFF, 0, 0, 139, 600 * 1024, "VersionString3"}};
+    }
+
+    ~ComponentValidatorTest()
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    /** @brief Run the event loop until the validation is complete */
+    void runValidation(ComponentValidator& validator)
+    {
+        while (!validator.result())
+        {
+            event.run(std::nullopt);
+        }
+    }
+
+    sdeventplus::Event event;
+    int fd = -1;
+    ComponentImageInfos compImageInfos;
+};
+
+TEST_F(ComponentValidatorTest, ValidPackage)
+{
+    ASSERT_GE(fd, 0);
+    struct stat sb;
+    ASSERT_EQ(fstat(fd, &sb), 0);
+
+    std::optional<bool> completed;
+    std::optional<bool> awaited;
+    ComponentValidator validator(event, fd, sb, compImageInfos,
+                                 [&](bool status) { completed = status; });
+    validator.await([&](bool status) { awaited = status; });
+    EXPECT_FALSE(validator.result());
+    EXPECT_FALSE(awaited);
+
+    runValidation(validator);
+    EXPECT_EQ(validator.result(), true);
+    EXPECT_EQ(completed, true);
+    EXPECT_EQ(awaited, true);
+
+    // A device done with PassComponentTable after the validation is told
+    // the outcome right away
+    std::optional<bool> late;
+    validator.await([&](bool status) { late = status; });
+    EXPECT_EQ(late, true);
+}
+
+TEST_F(ComponentValidatorTest, ComponentPastEndOfPackage)
+{
+    ASSERT_GE(fd, 0);
+    struct stat sb;
+    ASSERT_EQ(fstat(fd, &sb), 0);
+    std::get<static_cast<size_t>(ComponentImageInfoPos::CompSizePos)>(
+        compImageInfos[0]) += 1;
+
+    std::optional<bool> completed;
+    std::optional<bool> awaited;
+    ComponentValidator validator(event, fd, sb, compImageInfos,
+                                 [&](bool status) { completed = status; });
+    validator.await([&](bool status) { awaited = status; });
+
+    // The package is refused and the waiting device aborts its update
+    runValidation(validator);
+    EXPECT_EQ(validator.result(), false);
+    EXPECT_EQ(completed, false);
+    EXPECT_EQ(awaited, false);
+}
+
+TEST_F(ComponentValidatorTest, PackageModifiedDuringValidation)
+{
+    ASSERT_GE(fd, 0);
+    struct stat sb;
+    ASSERT_EQ(fstat(fd, &sb), 0);
+
+    std::optional<bool> completed;
+    ComponentValidator validator(event, fd, sb, compImageInfos,
+                                 [&](bool status) { completed = status; });
+    ASSERT_EQ(ftruncate(fd, sb.st_size + 1), 0);
+
+    runValidation(validator);
+    EXPECT_EQ(validator.result(), false);
+    EXPECT_EQ(completed, false);
+}
@@ -4,7 +4,15 @@
 #include "fw-update/package_parser.hpp"
 #include "requester/handler.hpp"
 
+#include <fcntl.h>
 #include <libpldm/firmware_update.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <array>
+#include <fstream>
+#include <span>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -18,6 +26,11 @@ class DeviceUpdaterTest : public testing::Test
     DeviceUpdaterTest() :
         package("./test_pkg", std::ios::binary | std::ios::in | std::ios::ate)
     {
+        packageData.resize(package.tellg());
+        package.seekg(0);
+        package.read(reinterpret_cast<char*>(packageData.data()),
+                     packageData.size());
+
         fwDeviceIDRecord = {
             1,
             {0x00},
@@ -30,10 +43,21 @@ class DeviceUpdaterTest : public testing::Test
         compImageInfos = {
             {10, 100, 0xFFFFFFFF, 0, 0, 139, 1024, "VersionString3"}};
         compInfo = {{std::make_pair(10, 100), 1}};
+
+        fd = open("./test_pkg", O_RDONLY | O_CLOEXEC);
+    }
+
+    ~DeviceUpdaterTest()
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
     }
 
     int fd = -1;
     std::ifstream package;
+    std::vector<uint8_t> packageData;
     FirmwareDeviceIDRecord fwDeviceIDRecord;
     ComponentImageInfos compImageInfos;
     ComponentInfo compInfo;
@@ -45,31 +69,11 @@ TEST_F(DeviceUpdaterTest, validatePackage)
     uintmax_t packageSize = package.tellg();
     EXPECT_EQ(packageSize, testPkgSize);
 
-    package.seekg(0);
-    std::vector<uint8_t> packageHeader(sizeof(pldm_package_header_information));
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 sizeof(pldm_package_header_information));
-
-    auto pkgHeaderInfo =
-        reinterpret_cast<const pldm_package_header_information*>(
-            packageHeader.data());
-    auto pkgHeaderInfoSize = sizeof(pldm_package_header_information) +
-                             pkgHeaderInfo->package_version_string_length;
-    packageHeader.clear();
-    packageHeader.resize(pkgHeaderInfoSize);
-    package.seekg(0);
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 pkgHeaderInfoSize);
-
-    auto parser = parsePkgHeader(packageHeader);
-    EXPECT_NE(parser, nullptr);
-
-    package.seekg(0);
-    packageHeader.resize(parser->pkgHeaderSize);
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 parser->pkgHeaderSize);
-
-    parser->parse(packageHeader, packageSize);
+    auto parser = parsePkgHeader(packageData);
+    ASSERT_NE(parser, nullptr);
+
+    parser->parse(std::span(packageData).first(parser->pkgHeaderSize),
+                  packageSize);
     const auto& fwDeviceIDRecords = parser->getFwDeviceIDRecords();
     const auto& testPkgCompImageInfos = parser->getComponentImageInfos();
 
@@ -81,8 +85,8 @@ TEST_F(DeviceUpdaterTest, validatePackage)
 
 TEST_F(DeviceUpdaterTest, ReadPackage512B)
 {
-    DeviceUpdater deviceUpdater(0, package, fwDeviceIDRecord, compImageInfos,
-                                compInfo, 512, nullptr);
+    DeviceUpdater deviceUpdater(0, fd, packageData.size(), fwDeviceIDRecord,
+                                compImageInfos, compInfo, 512, nullptr);
 
     constexpr std::array<uint8_t, sizeof(pldm_msg_hdr) +
                                       sizeof(pldm_request_firmware_data_req)>
@@ -150,3 +154,111 @@ TEST_F(DeviceUpdaterTest, ReadPackage512B)
         0xA2, 0x72, 0x33, 0x00, 0x3C, 0x7E, 0x28, 0x36, 0x10, 0x90, 0x38, 0xFB};
     EXPECT_EQ(response, compFirst512B);
 }
+
+TEST_F(DeviceUpdaterTest, ReadTruncatedPackage)
+{
+    // The component starts at offset 139, the package ends in its middle
+    packageData.resize(400);
+    DeviceUpdater deviceUpdater(0, fd, packageData.size(), fwDeviceIDRecord,
+                                compImageInfos, compInfo, 512, nullptr);
+
+    constexpr std::array<uint8_t, sizeof(pldm_msg_hdr) +
+                                      sizeof(pldm_request_firmware_data_req)>
+        reqFwDataReq{0x8A, 0x05, 0x15, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x02, 0x00, 0x00};
+    auto requestMsg = reinterpret_cast<const pldm_msg*>(reqFwDataReq.data());
+    auto response = deviceUpdater.requestFwData(
+        requestMsg, sizeof(pldm_request_firmware_data_req));
+
+    EXPECT_EQ(response.size(), sizeof(pldm_msg_hdr) + sizeof(uint8_t));
+    EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_FWUP_DATA_OUT_OF_RANGE);
+}
+
+TEST_F(DeviceUpdaterTest, PackageTruncatedDuringUpdate)
+{
+    char tmpFile[] = "/tmp/pldm_fw_pkg_XXXXXX";
+    int pkgFd = mkstemp(tmpFile);
+    ASSERT_GE(pkgFd, 0);
+    unlink(tmpFile);
+    ASSERT_EQ(write(pkgFd, packageData.data(), packageData.size()),
+              static_cast<ssize_t>(packageData.size()));
+
+    DeviceUpdater deviceUpdater(0, pkgFd, packageData.size(),
+                                fwDeviceIDRecord, compImageInfos, compInfo,
+                                512, nullptr);
+
+    // The component starts at offset 139, the package now ends in its middle
+    ASSERT_EQ(ftruncate(pkgFd, 400), 0);
+
+    constexpr std::array<uint8_t, sizeof(pldm_msg_hdr) +
+                                      sizeof(pldm_request_firmware_data_req)>
+        reqFwDataReq{0x8A, 0x05, 0x15, 0x00, 0x00, 0x00,
+                     0x00, 0x00, 0x02, 0x00, 0x00};
+    auto requestMsg = reinterpret_cast<const pldm_msg*>(reqFwDataReq.data());
+    auto response = deviceUpdater.requestFwData(
+        requestMsg, sizeof(pldm_request_firmware_data_req));
+
+    EXPECT_EQ(response.size(), sizeof(pldm_msg_hdr) + sizeof(uint8_t));
+    EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_FWUP_DATA_OUT_OF_RANGE);
+    close(pkgFd);
+}
+
+TEST_F(DeviceUpdaterTest, FwDataMetrics)
+{
+    DeviceUpdater deviceUpdater(0, fd, packageData.size(), fwDeviceIDRecord,
+                                compImageInfos, compInfo, 512, nullptr);
+
+    // Request the last 512 bytes of the 1024 byte component, then 512 bytes
+    // from offset 544 of which 32 bytes are pad bytes
+    constexpr std::array<uint8_t, sizeof(pldm_msg_hdr) +
+                                      sizeof(pldm_request_firmware_data_req)>
+        lastBlock{0x8A, 0x05, 0x15, 0x00, 0x02, 0x00,
+                  0x00, 0x00, 0x02, 0x00, 0x00};
+    constexpr std::array<uint8_t, sizeof(pldm_msg_hdr) +
+                                      sizeof(pldm_request_firmware_data_req)>
+        paddedBlock{0x8A, 0x05, 0x15, 0x20, 0x02, 0x00,
+                    0x00, 0x00, 0x02, 0x00, 0x00};
+    deviceUpdater.requestFwData(
+        reinterpret_cast<const pldm_msg*>(lastBlock.data()),
+        sizeof(pldm_request_firmware_data_req));
+    deviceUpdater.requestFwData(
+        reinterpret_cast<const pldm_msg*>(paddedBlock.data()),
+        sizeof(pldm_request_firmware_data_req));
+
+    const auto& metrics = deviceUpdater.getMetrics();
+    EXPECT_EQ(metrics.chunks, 2);
+    EXPECT_EQ(metrics.bytesTransferred, 512 + 480);
+    EXPECT_GE(metrics.maxChunkLatency, metrics.averageChunkLatency());
+}
+
+TEST_F(DeviceUpdaterTest, FailedComponentEndsFlow)
+{
+    DeviceUpdater deviceUpdater(0, fd, packageData.size(), fwDeviceIDRecord,
+                                compImageInfos, compInfo, 512, nullptr);
+
+    constexpr std::array<uint8_t, sizeof(pldm_msg_hdr) + 1> transferFailed{
+        0x8A, 0x05, 0x16, PLDM_FWUP_TRANSFER_ERROR_IMAGE_CORRUPT};
+    constexpr std::array<uint8_t, sizeof(pldm_msg_hdr) + 1> verifySucceeded{
+        0x8A, 0x05, 0x17, PLDM_FWUP_VERIFY_SUCCESS};
+    constexpr std::array<uint8_t, sizeof(pldm_msg_hdr) +
+                                      sizeof(pldm_update_component_resp)>
+        updateComponentResp{0x0A, 0x05, 0x14, 0x00, 0x00, 0x00,
+                            0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+    // No component is being transferred
+    auto response = deviceUpdater.transferComplete(
+        reinterpret_cast<const pldm_msg*>(transferFailed.data()), 1);
+    EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_FWUP_COMMAND_NOT_EXPECTED);
+
+    deviceUpdater.updateComponent(
+        0, reinterpret_cast<const pldm_msg*>(updateComponentResp.data()),
+        sizeof(pldm_update_component_resp));
+    response = deviceUpdater.transferComplete(
+        reinterpret_cast<const pldm_msg*>(transferFailed.data()), 1);
+    EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_SUCCESS);
+
+    // The failed transfer has ended the flow of the device
+    response = deviceUpdater.verifyComplete(
+        reinterpret_cast<const pldm_msg*>(verifySucceeded.data()), 1);
+    EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_FWUP_COMMAND_NOT_EXPECTED);
+}
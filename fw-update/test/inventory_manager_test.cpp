@@ -185,3 +185,56 @@ TEST_F(InventoryManagerTest, getFirmwareParametersResponseErrorCC)
     inventoryManager.getFirmwareParameters(1, responseMsg, respPayloadLength);
     EXPECT_EQ(outComponentInfoMap.size(), 0);
 }
+
+TEST_F(InventoryManagerTest, revalidateCachedInventory)
+{
+    constexpr size_t queryRespPayloadLength = 26;
+    constexpr std::array<uint8_t, sizeof(pldm_msg_hdr) + queryRespPayloadLength>
+        queryDeviceIdentifiersResp{
+            0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x01, 0x02,
+            0x00, 0x10, 0x00, 0xF0, 0x18, 0x87, 0x8C, 0xCB, 0x7D, 0x49,
+            0x43, 0x98, 0x00, 0xA0, 0x2F, 0x59, 0x9A, 0xCA, 0x02};
+    constexpr size_t respPayloadLength = 119;
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + respPayloadLength>
+        getFirmwareParametersResp{
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01,
+            0x0c, 0x00, 0x00, 0x44, 0x65, 0x76, 0x69, 0x63, 0x65, 0x56, 0x65,
+            0x72, 0x32, 0x2e, 0x30, 0x02, 0x00, 0x2e, 0x01, 0x28, 0x00, 0x00,
+            0x00, 0x00, 0x01, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x43,
+            0x6f, 0x6d, 0x70, 0x33, 0x76, 0x34, 0x2e, 0x30};
+    auto queryResponse =
+        reinterpret_cast<const pldm_msg*>(queryDeviceIdentifiersResp.data());
+    auto response =
+        reinterpret_cast<const pldm_msg*>(getFirmwareParametersResp.data());
+
+    EXPECT_EQ(inventoryManager.getGeneration(1), 0);
+    inventoryManager.queryDeviceIdentifiers(1, queryResponse,
+                                            queryRespPayloadLength);
+    inventoryManager.getFirmwareParameters(1, response, respPayloadLength);
+    EXPECT_EQ(inventoryManager.getGeneration(1), 1);
+    auto componentInfoMap = outComponentInfoMap;
+
+    // Rediscovered with the same firmware parameters, the inventory is kept
+    inventoryManager.discoverFDs({1});
+    inventoryManager.getFirmwareParameters(1, response, respPayloadLength);
+    EXPECT_EQ(inventoryManager.getGeneration(1), 1);
+    EXPECT_EQ(outComponentInfoMap, componentInfoMap);
+
+    // Rediscovered with a different ComponentClassificationIndex, the FD is
+    // discovered again from scratch
+    getFirmwareParametersResp[sizeof(pldm_msg_hdr) + 27] = 0x29;
+    inventoryManager.discoverFDs({1});
+    inventoryManager.getFirmwareParameters(1, response, respPayloadLength);
+    EXPECT_EQ(inventoryManager.getGeneration(1), 1);
+    EXPECT_EQ(outComponentInfoMap, componentInfoMap);
+
+    inventoryManager.queryDeviceIdentifiers(1, queryResponse,
+                                            queryRespPayloadLength);
+    inventoryManager.getFirmwareParameters(1, response, respPayloadLength);
+    EXPECT_EQ(inventoryManager.getGeneration(1), 2);
+    ComponentInfoMap changedComponentInfoMap{
+        {1, {{std::make_pair(2, 302), 0x29}}}};
+    EXPECT_EQ(outComponentInfoMap, changedComponentInfoMap);
+}
@@ -4,13 +4,20 @@
 #include "common/utils.hpp"
 #include "package_parser.hpp"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <filesystem>
-#include <fstream>
+#include <functional>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 PHOSPHOR_LOG2_USING;
 
@@ -51,51 +58,42 @@ int UpdateManager::processPackage(const std::filesystem::path& packageFilePath)
         }
     }
 
-    package.open(packageFilePath,
-                 std::ios::binary | std::ios::in | std::ios::ate);
-    if (!package.good())
+    if (!openPackage(packageFilePath))
     {
-        error(
-            "Failed to open the PLDM fw update package file '{FILE}', error - {ERROR}.",
-            "ERROR", unsigned(errno), "FILE", packageFilePath.c_str());
-        package.close();
         std::filesystem::remove(packageFilePath);
         return -1;
     }
 
-    uintmax_t packageSize = package.tellg();
+    uintmax_t packageSize = packageStat.st_size;
     if (packageSize < sizeof(pldm_package_header_information))
     {
         error(
             "PLDM fw update package length {SIZE} less than the length of the package header information '{PACKAGE_HEADER_INFO_SIZE}'.",
             "SIZE", packageSize, "PACKAGE_HEADER_INFO_SIZE",
             sizeof(pldm_package_header_information));
-        package.close();
+        closePackage();
         std::filesystem::remove(packageFilePath);
         return -1;
     }
 
-    package.seekg(0);
-    std::vector<uint8_t> packageHeader(sizeof(pldm_package_header_information));
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 sizeof(pldm_package_header_information));
-
-    auto pkgHeaderInfo =
-        reinterpret_cast<const pldm_package_header_information*>(
-            packageHeader.data());
-    auto pkgHeaderInfoSize = sizeof(pldm_package_header_information) +
-                             pkgHeaderInfo->package_version_string_length;
-    packageHeader.clear();
-    packageHeader.resize(pkgHeaderInfoSize);
-    package.seekg(0);
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 pkgHeaderInfoSize);
+    // The package version string is at most 255 bytes long
+    std::vector<uint8_t> packageHeader(std::min<uintmax_t>(
+        packageSize, sizeof(pldm_package_header_information) + UINT8_MAX));
+    if (!readPackage(0, packageHeader))
+    {
+        error(
+            "Failed to read the PLDM fw update package header information, error - {ERROR}",
+            "ERROR", errno);
+        closePackage();
+        std::filesystem::remove(packageFilePath);
+        return -1;
+    }
 
     parser = parsePkgHeader(packageHeader);
     if (parser == nullptr)
     {
         error("Invalid PLDM package header information");
-        package.close();
+        closePackage();
         std::filesystem::remove(packageFilePath);
         return -1;
     }
@@ -104,12 +102,18 @@ int UpdateManager::processPackage(const std::filesystem::path& packageFilePath)
     size_t versionHash = std::hash<std::string>{}(parser->pkgVersion);
     objPath = swRootPath + std::to_string(versionHash);
 
-    package.seekg(0);
-    packageHeader.resize(parser->pkgHeaderSize);
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 parser->pkgHeaderSize);
     try
     {
+        if (parser->pkgHeaderSize > packageSize)
+        {
+            throw std::runtime_error(
+                "Package header size exceeds the package size");
+        }
+        packageHeader.resize(parser->pkgHeaderSize);
+        if (!readPackage(0, packageHeader))
+        {
+            throw std::runtime_error("Failed to read the package header");
+        }
         parser->parse(packageHeader, packageSize);
     }
     catch (const std::exception& e)
@@ -118,7 +122,7 @@ int UpdateManager::processPackage(const std::filesystem::path& packageFilePath)
         activation = std::make_unique<Activation>(
             pldm::utils::DBusHandler::getBus(), objPath,
             software::Activation::Activations::Invalid, this);
-        package.close();
+        closePackage();
         parser.reset();
         return -1;
     }
@@ -133,7 +137,7 @@ int UpdateManager::processPackage(const std::filesystem::path& packageFilePath)
         activation = std::make_unique<Activation>(
             pldm::utils::DBusHandler::getBus(), objPath,
             software::Activation::Activations::Invalid, this);
-        package.close();
+        closePackage();
         parser.reset();
         return 0;
     }
@@ -149,8 +153,9 @@ int UpdateManager::processPackage(const std::filesystem::path& packageFilePath)
         deviceUpdaterMap.emplace(
             deviceUpdaterInfo.first,
             std::make_unique<DeviceUpdater>(
-                deviceUpdaterInfo.first, package, fwDeviceIDRecord,
-                compImageInfos, search->second, MAXIMUM_TRANSFER_SIZE, this));
+                deviceUpdaterInfo.first, (*packageFd)(), packageSize,
+                fwDeviceIDRecord, compImageInfos, search->second,
+                MAXIMUM_TRANSFER_SIZE, this));
     }
 
     fwPackageFilePath = packageFilePath;
@@ -159,10 +164,66 @@ int UpdateManager::processPackage(const std::filesystem::path& packageFilePath)
         software::Activation::Activations::Ready, this);
     activationProgress = std::make_unique<ActivationProgress>(
         pldm::utils::DBusHandler::getBus(), objPath);
+    componentValidator = std::make_unique<ComponentValidator>(
+        event, (*packageFd)(), packageStat, parser->getComponentImageInfos(),
+        std::bind_front(&UpdateManager::componentValidationCompleted, this));
 
     return 0;
 }
 
+bool UpdateManager::openPackage(const std::filesystem::path& packageFilePath)
+{
+    int fd = open(packageFilePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error(
+            "Failed to open the PLDM fw update package file '{FILE}', error - {ERROR}.",
+            "ERROR", unsigned(errno), "FILE", packageFilePath.c_str());
+        return false;
+    }
+    auto packageFile = std::make_unique<pldm::utils::CustomFD>(fd);
+
+    struct stat sb;
+    if (fstat(fd, &sb) < 0)
+    {
+        error(
+            "Failed to get the size of the PLDM fw update package file '{FILE}', error - {ERROR}.",
+            "ERROR", unsigned(errno), "FILE", packageFilePath.c_str());
+        return false;
+    }
+    packageStat = sb;
+    packageFd = std::move(packageFile);
+    return true;
+}
+
+bool UpdateManager::readPackage(off_t offset, std::span<uint8_t> data)
+{
+    auto rc = pread((*packageFd)(), data.data(), data.size(), offset);
+    return rc >= 0 && static_cast<size_t>(rc) == data.size();
+}
+
+void UpdateManager::closePackage()
+{
+    packageFd.reset();
+}
+
+void UpdateManager::componentValidationCompleted(bool status)
+{
+    if (!status && activation &&
+        activation->activation() == software::Activation::Activations::Ready)
+    {
+        // The package is refused before any device is updated with it
+        activation->activation(software::Activation::Activations::Invalid);
+    }
+}
+
+void UpdateManager::awaitComponentValidation(mctp_eid_t eid)
+{
+    componentValidator->await([this, eid](bool status) {
+        deviceUpdaterMap.at(eid)->componentValidationCompleted(status);
+    });
+}
+
 DeviceUpdaterInfos UpdateManager::associatePkgToDevices(
     const FirmwareDeviceIDRecords& fwDeviceIDRecords,
     const DescriptorMap& descriptorMap,
@@ -191,27 +252,43 @@ DeviceUpdaterInfos UpdateManager::associatePkgToDevices(
 
 void UpdateManager::updateDeviceCompletion(mctp_eid_t eid, bool status)
 {
-    deviceUpdateCompletionMap.emplace(eid, status);
-    if (deviceUpdateCompletionMap.size() == deviceUpdaterMap.size())
+    if (!deviceUpdateCompletionMap.emplace(eid, status).second)
+    {
+        return;
+    }
+    activeDeviceUpdates--;
+    logDeviceUpdateMetrics(eid, status);
+
+    if (deviceUpdateCompletionMap.size() != deviceUpdaterMap.size())
     {
-        for (const auto& [eid, status] : deviceUpdateCompletionMap)
+        // A device finished, its slot goes to the next one waiting
+        startDeviceUpdates();
+        return;
+    }
+
+    for (const auto& [eid, status] : deviceUpdateCompletionMap)
+    {
+        if (!status)
         {
-            if (!status)
-            {
-                activation->activation(
-                    software::Activation::Activations::Failed);
-                return;
-            }
+            activation->activation(software::Activation::Activations::Failed);
+            return;
         }
+    }
 
-        auto endTime = std::chrono::steady_clock::now();
-        auto dur =
-            std::chrono::duration<double, std::milli>(endTime - startTime)
-                .count();
-        info("Firmware update time: {DURATION}ms", "DURATION", dur);
-        activation->activation(software::Activation::Activations::Active);
+    auto endTime = std::chrono::steady_clock::now();
+    auto dur = std::chrono::duration<double, std::milli>(endTime - startTime)
+                   .count();
+    uint64_t bytes = 0;
+    for (const auto& [deviceEid, deviceUpdater] : deviceUpdaterMap)
+    {
+        bytes += deviceUpdater->getMetrics().bytesTransferred;
     }
-    return;
+    info(
+        "Firmware update time: {DURATION}ms for {DEVICES} devices, {BYTES} bytes transferred at {BYTES_PER_SEC} bytes/s",
+        "DURATION", dur, "DEVICES", deviceUpdaterMap.size(), "BYTES", bytes,
+        "BYTES_PER_SEC", dur > 0 ? static_cast<uint64_t>(bytes * 1000 / dur)
+                                 : 0);
+    activation->activation(software::Activation::Activations::Active);
 }
 
 Response UpdateManager::handleRequest(mctp_eid_t eid, uint8_t command,
@@ -261,10 +338,56 @@ Response UpdateManager::handleRequest(mctp_eid_t eid, uint8_t command,
 void UpdateManager::activatePackage()
 {
     startTime = std::chrono::steady_clock::now();
+    pendingDeviceUpdates.clear();
     for (const auto& [eid, deviceUpdaterPtr] : deviceUpdaterMap)
     {
-        deviceUpdaterPtr->startFwUpdateFlow();
+        pendingDeviceUpdates.emplace_back(eid);
     }
+    startDeviceUpdates();
+}
+
+void UpdateManager::startDeviceUpdates()
+{
+    static constexpr size_t maxParallelUpdates = MAXIMUM_PARALLEL_FW_UPDATES;
+
+    // A device failing to start completes right away and re-enters here, so
+    // the bookkeeping is done before starting it
+    while (!pendingDeviceUpdates.empty() &&
+           (!maxParallelUpdates || activeDeviceUpdates < maxParallelUpdates))
+    {
+        auto eid = pendingDeviceUpdates.front();
+        pendingDeviceUpdates.pop_front();
+        activeDeviceUpdates++;
+        deviceUpdaterMap.at(eid)->startFwUpdateFlow();
+    }
+}
+
+void UpdateManager::logDeviceUpdateMetrics(mctp_eid_t eid, bool status)
+{
+    auto deviceUpdater = deviceUpdaterMap.find(eid);
+    if (deviceUpdater == deviceUpdaterMap.end())
+    {
+        return;
+    }
+
+    auto toMs = [](DeviceUpdateMetrics::Duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+    const auto& metrics = deviceUpdater->second->getMetrics();
+    info(
+        "Firmware update of endpoint ID '{EID}' {STATUS}, {BYTES} bytes in {CHUNKS} chunks at {BYTES_PER_SEC} bytes/s, chunk latency average {CHUNK_LATENCY_AVG}ms and maximum {CHUNK_LATENCY_MAX}ms, phase times RequestUpdate {REQUEST_UPDATE}ms, PassComponentTable {PASS_COMP_TABLE}ms, UpdateComponent {UPDATE_COMP}ms, transfer {TRANSFER}ms, verify {VERIFY}ms, apply {APPLY}ms, activate {ACTIVATE}ms",
+        "EID", unsigned(eid), "STATUS", status ? "succeeded" : "failed",
+        "BYTES", metrics.bytesTransferred, "CHUNKS", metrics.chunks,
+        "BYTES_PER_SEC", static_cast<uint64_t>(metrics.bytesPerSecond()),
+        "CHUNK_LATENCY_AVG", toMs(metrics.averageChunkLatency()),
+        "CHUNK_LATENCY_MAX", toMs(metrics.maxChunkLatency), "REQUEST_UPDATE",
+        toMs(metrics.phaseTime(UpdatePhase::RequestUpdate)), "PASS_COMP_TABLE",
+        toMs(metrics.phaseTime(UpdatePhase::PassComponentTable)),
+        "UPDATE_COMP", toMs(metrics.phaseTime(UpdatePhase::UpdateComponent)),
+        "TRANSFER", toMs(metrics.phaseTime(UpdatePhase::Transfer)), "VERIFY",
+        toMs(metrics.phaseTime(UpdatePhase::Verify)), "APPLY",
+        toMs(metrics.phaseTime(UpdatePhase::Apply)), "ACTIVATE",
+        toMs(metrics.phaseTime(UpdatePhase::Activate)));
 }
 
 void UpdateManager::clearActivationInfo()
@@ -273,10 +396,13 @@ void UpdateManager::clearActivationInfo()
     activationProgress.reset();
     objPath.clear();
 
+    pendingDeviceUpdates.clear();
+    activeDeviceUpdates = 0;
+    componentValidator.reset();
     deviceUpdaterMap.clear();
     deviceUpdateCompletionMap.clear();
     parser.reset();
-    package.close();
+    closePackage();
     std::filesystem::remove(fwPackageFilePath);
     totalNumComponentUpdates = 0;
     compUpdateCompletedCount = 0;
@@ -2,16 +2,21 @@
 
 #include "common/instance_id.hpp"
 #include "common/types.hpp"
+#include "common/utils.hpp"
+#include "component_validator.hpp"
 #include "device_updater.hpp"
 #include "package_parser.hpp"
 #include "requester/handler.hpp"
 #include "watch.hpp"
 
 #include <libpldm/base.h>
+#include <sys/stat.h>
 
 #include <chrono>
+#include <deque>
 #include <filesystem>
-#include <fstream>
+#include <memory>
+#include <span>
 #include <tuple>
 #include <unordered_map>
 
@@ -73,6 +78,15 @@ class UpdateManager
 
     void updateDeviceCompletion(mctp_eid_t eid, bool status);
 
+    /** @brief Called by a DeviceUpdater before it transfers the component
+     *         images, the DeviceUpdater is told the outcome of the validation
+     *         of the component images right away if it is known, or else
+     *         once it is complete
+     *
+     *  @param[in] eid - endpoint ID of the firmware device
+     */
+    void awaitComponentValidation(mctp_eid_t eid);
+
     void updateActivationProgress();
 
     /** @brief Callback function that will be invoked when the
@@ -108,14 +122,75 @@ class UpdateManager
     std::unique_ptr<ActivationProgress> activationProgress;
     std::string objPath;
 
+    /** @brief Open the firmware update package
+     *
+     *  @param[in] packageFilePath - path of the firmware update package
+     *
+     *  @return true if the package is opened
+     */
+    bool openPackage(const std::filesystem::path& packageFilePath);
+
+    /** @brief Read from the firmware update package
+     *
+     *  @param[in] offset - offset in the package
+     *  @param[out] data - filled with the package contents at the offset
+     *
+     *  @return true if all of data was read
+     */
+    bool readPackage(off_t offset, std::span<uint8_t> data);
+
+    /** @brief Close the firmware update package */
+    void closePackage();
+
+    /** @brief Record the outcome of the validation of the component images,
+     *         the package is refused if they are not valid
+     *
+     *  @param[in] status - true if the component images are valid
+     */
+    void componentValidationCompleted(bool status);
+
     std::filesystem::path fwPackageFilePath;
     std::unique_ptr<PackageParser> parser;
-    std::ifstream package;
+
+    /** @brief The package file, shared by the DeviceUpdater instances. It is
+     *         only read with pread, so that the devices don't share a file
+     *         position and a package truncated during an update is reported
+     *         as a short read
+     */
+    std::unique_ptr<pldm::utils::CustomFD> packageFd;
+
+    /** @brief Status of the package file when it was opened, to detect the
+     *         file being modified while its component images are validated
+     */
+    struct stat packageStat{};
+
+    /** @brief Validates the component images of the package, the
+     *         DeviceUpdaters wait for it before they transfer them
+     */
+    std::unique_ptr<ComponentValidator> componentValidator;
 
     std::unordered_map<mctp_eid_t, std::unique_ptr<DeviceUpdater>>
         deviceUpdaterMap;
     std::unordered_map<mctp_eid_t, bool> deviceUpdateCompletionMap;
 
+    /** @brief Start the firmware update of the devices waiting for their turn,
+     *         while fewer than MAXIMUM_PARALLEL_FW_UPDATES devices update
+     */
+    void startDeviceUpdates();
+
+    /** @brief Log the metrics of the firmware update of a device
+     *
+     *  @param[in] eid - endpoint ID of the firmware device
+     *  @param[in] status - true if the firmware update succeeded
+     */
+    void logDeviceUpdateMetrics(mctp_eid_t eid, bool status);
+
+    /** @brief Devices waiting for their firmware update to start */
+    std::deque<mctp_eid_t> pendingDeviceUpdates;
+
+    /** @brief Number of devices with a firmware update in progress */
+    size_t activeDeviceUpdates = 0;
+
     /** @brief Total number of component updates to calculate the progress of
      *         the Firmware activation
      */
@@ -7,6 +7,7 @@
 #include "custom_dbus.hpp"
 
 #include <assert.h>
+#include <endian.h>
 
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/lg2.hpp>
@@ -15,6 +16,8 @@
 #include <sdeventplus/source/io.hpp>
 #include <sdeventplus/source/time.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <type_traits>
 
@@ -54,14 +57,10 @@ uint16_t extractTerminusHandle(std::vector<uint8_t>& pdr)
 }
 
 template <typename T>
-void updateContainerId(pldm_entity_association_tree* entityTree,
+void updateContainerId(EntityTreeIndex& entityTreeIndex,
                        std::vector<uint8_t>& pdr)
 {
     T* t = nullptr;
-    if (entityTree == nullptr)
-    {
-        return;
-    }
     if (std::is_same<T, pldm_pdr_fru_record_set>::value)
     {
         t = (T*)(pdr.data() + sizeof(pldm_pdr_hdr));
@@ -76,8 +75,7 @@ void updateContainerId(pldm_entity_association_tree* entityTree,
     }
 
     pldm_entity entity{t->entity_type, t->entity_instance, t->container_id};
-    auto node = pldm_entity_association_tree_find_with_locality(entityTree,
-                                                                &entity, true);
+    auto node = entityTreeIndex.find(entity, true);
     if (node)
     {
         pldm_entity e = pldm_entity_extract(node);
@@ -95,7 +93,8 @@ HostPDRHandler::HostPDRHandler(
     mctp_fd(mctp_fd),
     mctp_eid(mctp_eid), event(event), repo(repo),
     stateSensorHandler(eventsJsonsDir), entityTree(entityTree),
-    bmcEntityTree(bmcEntityTree), instanceIdDb(instanceIdDb), handler(handler),
+    bmcEntityTree(bmcEntityTree), entityTreeIndex(entityTree),
+    instanceIdDb(instanceIdDb), handler(handler),
     oemPlatformHandler(oemPlatformHandler),
     entityMaps(parseEntityMap(ENTITY_MAP_JSON))
 {
@@ -124,6 +123,7 @@ HostPDRHandler::HostPDRHandler(
                 pldm_entity_association_tree_destroy_root(entityTree);
                 pldm_entity_association_tree_copy_root(bmcEntityTree,
                                                        entityTree);
+                this->entityTreeIndex.clear();
                 this->sensorMap.clear();
                 this->responseReceived = false;
                 this->mergedHostParents = false;
@@ -245,13 +245,11 @@ void HostPDRHandler::mergeEntityAssociations(
         pldm_entity_node* pNode = nullptr;
         if (!mergedHostParents)
         {
-            pNode = pldm_entity_association_tree_find_with_locality(
-                entityTree, &entities[0], false);
+            pNode = entityTreeIndex.find(entities[0], false);
         }
         else
         {
-            pNode = pldm_entity_association_tree_find_with_locality(
-                entityTree, &entities[0], true);
+            pNode = entityTreeIndex.find(entities[0], true);
         }
         if (!pNode)
         {
@@ -268,10 +266,9 @@ void HostPDRHandler::mergeEntityAssociations(
                 isUpdateContainerId =
                     checkIfLogicalBitSet(entities[i].entity_container_id);
             }
-            auto node = pldm_entity_association_tree_add_entity(
-                entityTree, &entities[i], entities[i].entity_instance_num,
-                pNode, entityPdr->association_type, true, isUpdateContainerId,
-                0xFFFF);
+            auto node = entityTreeIndex.addEntity(
+                &entities[i], entities[i].entity_instance_num, pNode,
+                entityPdr->association_type, true, isUpdateContainerId, 0xFFFF);
             if (!node)
             {
                 continue;
@@ -335,10 +332,7 @@ void HostPDRHandler::sendPDRRepositoryChgEvent(std::vector<uint8_t>&& pdrTypes,
 
     // Extract from the PDR repo record handles of PDRs we want the host
     // to pull up.
-    std::vector<uint8_t> eventDataOps{PLDM_RECORDS_ADDED};
-    std::vector<uint8_t> numsOfChangeEntries(1);
-    std::vector<std::vector<ChangeEntry>> changeEntries(
-        numsOfChangeEntries.size());
+    std::vector<ChangeEntry> recordHandles;
     for (auto pdrType : pdrTypes)
     {
         const pldm_pdr_record* record{};
@@ -348,16 +342,24 @@ void HostPDRHandler::sendPDRRepositoryChgEvent(std::vector<uint8_t>&& pdrTypes,
                                                   nullptr, nullptr);
             if (record && pldm_pdr_record_is_remote(record))
             {
-                changeEntries[0].push_back(
+                recordHandles.push_back(
                     pldm_pdr_get_record_handle(repo, record));
             }
         } while (record);
     }
-    if (changeEntries.empty())
-    {
-        return;
-    }
-    numsOfChangeEntries[0] = changeEntries[0].size();
+
+    sendPDRRecordsChgEvent(PLDM_RECORDS_ADDED, std::move(recordHandles));
+}
+
+void HostPDRHandler::sendPDRRecordsChgEvent(
+    uint8_t eventDataOperation, std::vector<ChangeEntry>&& recordHandles)
+{
+    std::vector<uint8_t> eventDataOps{eventDataOperation};
+    std::vector<uint8_t> numsOfChangeEntries{
+        static_cast<uint8_t>(recordHandles.size())};
+    std::vector<std::vector<ChangeEntry>> changeEntries{
+        std::move(recordHandles)};
+    uint8_t eventDataFormat = FORMAT_IS_PDR_HANDLES;
 
     // Encode PLDM platform event msg to indicate a PDR repo change.
     size_t maxSize = PLDM_PDR_REPOSITORY_CHG_EVENT_MIN_LENGTH +
@@ -479,6 +481,10 @@ void HostPDRHandler::processHostPDRs(mctp_eid_t /*eid*/,
         return;
     }
 
+    // FRU hot plug adds the BMC's entities to the tree in between the GetPDR
+    // responses, without going through the index
+    entityTreeIndex.clearMisses();
+
     auto rc = decode_get_pdr_resp(
         response, respMsgLen /*- sizeof(pldm_msg_hdr)*/, &completionCode,
         &nextRecordHandle, &nextDataTransferHandle, &transferFlag, &respCount,
@@ -577,21 +583,24 @@ void HostPDRHandler::processHostPDRs(mctp_eid_t /*eid*/,
                 {
                     pdrTerminusHandle =
                         extractTerminusHandle<pldm_state_sensor_pdr>(pdr);
-                    updateContainerId<pldm_state_sensor_pdr>(entityTree, pdr);
+                    updateContainerId<pldm_state_sensor_pdr>(entityTreeIndex,
+                                                             pdr);
                     stateSensorPDRs.emplace_back(pdr);
                 }
                 else if (pdrHdr->type == PLDM_PDR_FRU_RECORD_SET)
                 {
                     pdrTerminusHandle =
                         extractTerminusHandle<pldm_pdr_fru_record_set>(pdr);
-                    updateContainerId<pldm_pdr_fru_record_set>(entityTree, pdr);
+                    updateContainerId<pldm_pdr_fru_record_set>(entityTreeIndex,
+                                                               pdr);
                     fruRecordSetPDRs.emplace_back(pdr);
                 }
                 else if (pdrHdr->type == PLDM_STATE_EFFECTER_PDR)
                 {
                     pdrTerminusHandle =
                         extractTerminusHandle<pldm_state_effecter_pdr>(pdr);
-                    updateContainerId<pldm_state_effecter_pdr>(entityTree, pdr);
+                    updateContainerId<pldm_state_effecter_pdr>(entityTreeIndex,
+                                                               pdr);
                 }
                 else if (pdrHdr->type == PLDM_NUMERIC_EFFECTER_PDR)
                 {
@@ -599,7 +608,7 @@ void HostPDRHandler::processHostPDRs(mctp_eid_t /*eid*/,
                         extractTerminusHandle<pldm_numeric_effecter_value_pdr>(
                             pdr);
                     updateContainerId<pldm_numeric_effecter_value_pdr>(
-                        entityTree, pdr);
+                        entityTreeIndex, pdr);
                 }
                 // if the TLPDR is invalid update the repo accordingly
                 if (!tlValid)
@@ -963,7 +972,8 @@ void HostPDRHandler::getFRURecordTableMetadataByRemote(
         }
 
         // pass total to getFRURecordTableByRemote
-        this->getFRURecordTableByRemote(fruRecordSetPDRs, total);
+        this->getFRURecordTableByRemote(fruRecordSetPDRs, total,
+                                        fru_table_length, checksum);
     };
 
     rc = handler->registerRequest(
@@ -981,7 +991,9 @@ void HostPDRHandler::getFRURecordTableMetadataByRemote(
 }
 
 void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
-                                               uint16_t totalTableRecords)
+                                               uint16_t totalTableRecords,
+                                               uint32_t tableLength,
+                                               uint32_t checksum)
 {
     fruRecordData.clear();
 
@@ -991,6 +1003,20 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
         return;
     }
 
+    // A new transfer discards an unfinished one, the responses still due
+    // for it are told apart by the generation
+    auto generation = ++fruTableGeneration;
+    fruTableTransfer.emplace(FruTableTransfer{
+        fruRecordSetPDRs, totalTableRecords, generation,
+        pldm::hostbmc::utils::MultipartTable(tableLength, checksum)});
+
+    getFRURecordTablePartByRemote(generation, 0, PLDM_GET_FIRSTPART);
+}
+
+void HostPDRHandler::getFRURecordTablePartByRemote(uint32_t generation,
+                                                   uint32_t transferHandle,
+                                                   uint8_t transferOpFlag)
+{
     auto instanceId = instanceIdDb.next(mctp_eid);
     std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
                                     PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
@@ -998,11 +1024,12 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
     // send the getFruRecordTable command
     auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
     auto rc = encode_get_fru_record_table_req(
-        instanceId, 0, PLDM_GET_FIRSTPART, request,
+        instanceId, transferHandle, transferOpFlag, request,
         requestMsg.size() - sizeof(pldm_msg_hdr));
     if (rc != PLDM_SUCCESS)
     {
         instanceIdDb.free(mctp_eid, instanceId);
+        fruTableTransfer.reset();
         error(
             "Failed to encode get fru record table request, response code '{RC}'",
             "RC", lg2::hex, rc);
@@ -1010,10 +1037,15 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
     }
 
     auto getFruRecordTableResponseHandler =
-        [totalTableRecords, this, fruRecordSetPDRs](
-            mctp_eid_t /*eid*/, const pldm_msg* response, size_t respMsgLen) {
+        [this, generation](mctp_eid_t /*eid*/, const pldm_msg* response,
+                           size_t respMsgLen) {
+        if (!fruTableTransfer || fruTableTransfer->generation != generation)
+        {
+            return;
+        }
         if (response == nullptr || !respMsgLen)
         {
+            fruTableTransfer.reset();
             error("Failed to receive response for the get fru record table");
             return;
         }
@@ -1032,24 +1064,31 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
 
         if (rc != PLDM_SUCCESS || cc != PLDM_SUCCESS)
         {
+            fruTableTransfer.reset();
             error(
                 "Failed to decode get fru record table resp, response code '{RC}' and completion code '{CC}'",
                 "RC", lg2::hex, rc, "CC", cc);
             return;
         }
 
-        fruRecordData = responder::pdr_utils::parseFruRecordTable(
-            fru_record_table_data.data(), fru_record_table_length);
-
-        if (totalTableRecords != fruRecordData.size())
+        if (!fruTableTransfer->table.append(std::span<const uint8_t>(
+                fru_record_table_data.data(), fru_record_table_length)))
         {
-            fruRecordData.clear();
-
-            error("Failed to parse fru recrod data format.");
+            fruTableTransfer.reset();
+            error(
+                "Remote FRU record table exceeds the length in its metadata");
             return;
         }
 
-        this->setFRUDataOnDBus(fruRecordSetPDRs, fruRecordData);
+        if (transfer_flag == PLDM_END || transfer_flag == PLDM_START_AND_END)
+        {
+            this->processFRURecordTable();
+            return;
+        }
+        // The request is only queued, it is sent once this response is
+        // handled. A failure to queue it abandons the transfer.
+        this->getFRURecordTablePartByRemote(
+            generation, next_data_transfer_handle, PLDM_GET_NEXTPART);
     };
 
     rc = handler->registerRequest(
@@ -1057,10 +1096,37 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
         std::move(requestMsg), std::move(getFruRecordTableResponseHandler));
     if (rc != PLDM_SUCCESS)
     {
-        error("Failed to send the the set state effecter states request");
+        fruTableTransfer.reset();
+        error("Failed to send the get fru record table request");
     }
 }
 
+void HostPDRHandler::processFRURecordTable()
+{
+    auto transfer = std::move(*fruTableTransfer);
+    fruTableTransfer.reset();
+
+    auto table = transfer.table.verify();
+    if (!table)
+    {
+        error("Remote FRU record table failed the integrity check");
+        return;
+    }
+
+    fruRecordData = responder::pdr_utils::parseFruRecordTable(table->data(),
+                                                              table->size());
+
+    if (transfer.totalTableRecords != fruRecordData.size())
+    {
+        fruRecordData.clear();
+
+        error("Failed to parse fru recrod data format.");
+        return;
+    }
+
+    setFRUDataOnDBus(transfer.fruRecordSetPDRs, fruRecordData);
+}
+
 std::optional<uint16_t> HostPDRHandler::getRSI(const PDRList& fruRecordSetPDRs,
                                                const pldm_entity& entity)
 {
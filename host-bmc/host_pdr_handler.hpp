@@ -19,6 +19,7 @@
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace pldm
@@ -55,6 +56,20 @@ struct SensorEntry
 using HostStateSensorMap = std::map<SensorEntry, pdr::SensorInfo>;
 using PDRList = std::vector<std::vector<uint8_t>>;
 
+/** @struct FruTableTransfer
+ *
+ *  State of a multipart GetFRURecordTable transfer from the remote terminus,
+ *  along with what GetFRURecordTableMetadata reported about the table.
+ */
+struct FruTableTransfer
+{
+    PDRList fruRecordSetPDRs;
+    uint16_t totalTableRecords;
+    uint32_t generation; //!< tells the responses of an abandoned transfer
+                         //!< apart
+    pldm::hostbmc::utils::MultipartTable table; //!< the parts received so far
+};
+
 /** @class HostPDRHandler
  *  @brief This class can fetch and process PDRs from host firmware
  *  @details Provides an API to fetch PDRs from the host firmware. Upon
@@ -114,6 +129,25 @@ class HostPDRHandler
     void sendPDRRepositoryChgEvent(std::vector<uint8_t>&& pdrTypes,
                                    uint8_t eventDataFormat);
 
+    /** @brief Send a PLDM event to host firmware containing a list of record
+     *  handles of PDRs that were added, deleted or modified in the BMC repo.
+     *  @param[in] eventDataOperation - PLDM_RECORDS_ADDED,
+     *             PLDM_RECORDS_DELETED or PLDM_RECORDS_MODIFIED
+     *  @param[in] recordHandles - record handles of the changed PDRs
+     */
+    void sendPDRRecordsChgEvent(uint8_t eventDataOperation,
+                                std::vector<ChangeEntry>&& recordHandles);
+
+    /** @brief Forget a node of the BMC's entity association tree before it is
+     *         removed from the tree, e.g. on a FRU hot unplug
+     *
+     *  @param[in] node - node about to be removed from the tree
+     */
+    void entityNodeRemoved(const pldm_entity_node* node)
+    {
+        entityTreeIndex.erase(node);
+    }
+
     /** @brief Lookup host sensor info corresponding to requested SensorEntry
      *
      *  @param[in] entry - TerminusID and SensorID
@@ -230,14 +264,34 @@ class HostPDRHandler
         const std::vector<responder::pdr_utils::FruRecordDataFormat>&
             fruRecordData);
 
-    /** @brief Get FRU record table by remote PLDM terminus
+    /** @brief Get FRU record table by remote PLDM terminus, the table is
+     *         fetched part by part and verified against its checksum
      *
      *  @param[in] fruRecordSetPDRs  - the Fru Record set PDR's
      *  @param[in] totalTableRecords - the Number of total table records
+     *  @param[in] tableLength - length of the FRU table from the metadata
+     *  @param[in] checksum - checksum of the FRU table from the metadata
      *  @return
      */
     void getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
-                                   uint16_t totalTableRecords);
+                                   uint16_t totalTableRecords,
+                                   uint32_t tableLength, uint32_t checksum);
+
+    /** @brief Request a part of the FRU record table from the remote PLDM
+     *         terminus
+     *
+     *  @param[in] generation - generation of the transfer the part is for
+     *  @param[in] transferHandle - data transfer handle of the part
+     *  @param[in] transferOpFlag - PLDM_GET_FIRSTPART or PLDM_GET_NEXTPART
+     */
+    void getFRURecordTablePartByRemote(uint32_t generation,
+                                       uint32_t transferHandle,
+                                       uint8_t transferOpFlag);
+
+    /** @brief Verify the reassembled FRU record table against its checksum
+     *         and set the FRU data on D-Bus
+     */
+    void processFRURecordTable();
 
     /** @brief Create Dbus objects by remote PLDM entity Fru PDRs
      *
@@ -273,6 +327,15 @@ class HostPDRHandler
     /** @brief Pointer to BMC's entity association tree */
     pldm_entity_association_tree* bmcEntityTree;
 
+    /** @brief Index of the nodes of the BMC's and Host's entity association
+     *  tree, used to merge the host's PDRs without walking the tree
+     */
+    /** @brief Index of entityTree for merging the host PDRs. bmcEntityTree
+     *         needs none, it is only copied back into entityTree when the host
+     *         powers off, and never searched here
+     */
+    pldm::hostbmc::utils::EntityTreeIndex entityTreeIndex;
+
     /** @brief reference to Instance ID database object, used to obtain PLDM
      * instance IDs
      */
@@ -325,6 +388,13 @@ class HostPDRHandler
      */
     std::vector<responder::pdr_utils::FruRecordDataFormat> fruRecordData;
 
+    /** @brief GetFRURecordTable transfer in progress from the remote terminus
+     */
+    std::optional<FruTableTransfer> fruTableTransfer;
+
+    /** @brief Generation of the last GetFRURecordTable transfer started */
+    uint32_t fruTableGeneration = 0;
+
     /** @OEM platform handler */
     pldm::responder::oem_platform::Handler* oemPlatformHandler;
 
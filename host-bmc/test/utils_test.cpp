@@ -1,9 +1,14 @@
 #include "../utils.hpp"
 #include "common/utils.hpp"
 
+#include <endian.h>
 #include <libpldm/pdr.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -114,3 +119,194 @@ TEST(EntityAssociation, addObjectPathEntityAssociations1)
     EXPECT_EQ(index, retObjectMaps.size());
     pldm_entity_association_tree_destroy(tree);
 }
+
+TEST(EntityAssociation, entityTreeIndex)
+{
+    auto tree = pldm_entity_association_tree_init();
+    pldm_entity system{45, 1, 0};
+    auto root = pldm_entity_association_tree_add_entity(
+        tree, &system, 1, nullptr, PLDM_ENTITY_ASSOCIAION_PHYSICAL, false,
+        true, 0xFFFF);
+    ASSERT_NE(root, nullptr);
+
+    EntityTreeIndex index(tree);
+    pldm_entity lookup{45, 1, 0};
+    EXPECT_EQ(index.find(lookup, false), root);
+
+    pldm_entity entities[2]{{64, 1, 10}, {67, 2, 10}};
+    auto l1 = index.addEntity(&entities[0], 1, root,
+                              PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true,
+                              0xFFFF);
+    auto l2 = index.addEntity(&entities[1], 2, l1,
+                              PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true,
+                              0xFFFF);
+    ASSERT_NE(l1, nullptr);
+    ASSERT_NE(l2, nullptr);
+
+    for (auto node : {root, l1, l2})
+    {
+        pldm_entity entity = pldm_entity_extract(node);
+        EXPECT_EQ(index.find(entity, false),
+                  pldm_entity_association_tree_find_with_locality(
+                      tree, &entity, false));
+
+        entity.entity_container_id =
+            pldm_entity_node_get_remote_container_id(node);
+        EXPECT_EQ(index.find(entity, true),
+                  pldm_entity_association_tree_find_with_locality(
+                      tree, &entity, true));
+    }
+
+    pldm_entity missing{135, 1, 10};
+    EXPECT_EQ(index.find(missing, true), nullptr);
+
+    // A node added behind the index's back is not found until the recorded
+    // misses are cleared. The children of the root share a container ID.
+    auto containerId = pldm_entity_extract(l1).entity_container_id;
+    pldm_entity board{64, 2, containerId};
+    EXPECT_EQ(index.find(board, false), nullptr);
+    auto added = pldm_entity_association_tree_add_entity(
+        tree, &board, 2, root, PLDM_ENTITY_ASSOCIAION_PHYSICAL, false, true,
+        0xFFFF);
+    ASSERT_NE(added, nullptr);
+    ASSERT_EQ(pldm_entity_extract(added).entity_container_id, containerId);
+    EXPECT_EQ(index.find(board, false), nullptr);
+    index.clearMisses();
+    EXPECT_EQ(index.find(board, false), added);
+
+    // Adding a node through the index clears the misses
+    pldm_entity dimm{142, 1, containerId};
+    EXPECT_EQ(index.find(dimm, false), nullptr);
+    auto dimmNode = pldm_entity_association_tree_add_entity(
+        tree, &dimm, 1, root, PLDM_ENTITY_ASSOCIAION_PHYSICAL, false, true,
+        0xFFFF);
+    ASSERT_NE(dimmNode, nullptr);
+    pldm_entity fan{29, 1, 10};
+    ASSERT_NE(index.addEntity(&fan, 1, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                              true, true, 0xFFFF),
+              nullptr);
+    EXPECT_EQ(index.find(dimm, false), dimmNode);
+
+    pldm_entity_association_tree_destroy(tree);
+}
+
+TEST(EntityAssociation, updateEntityAssociationLargeTopology)
+{
+    // Synthetic host topology of a chassis with a motherboard, populated
+    // with dcms, each with cpus and each cpu with cores
+    constexpr uint16_t dcms = 256;
+    constexpr uint16_t cpusPerDcm = 4;
+    constexpr uint16_t coresPerCpu = 4;
+
+    auto tree = pldm_entity_association_tree_init();
+    uint16_t containerId = 1;
+    auto addEntity = [&](uint16_t type, uint16_t instance,
+                         pldm_entity_node* parent, uint16_t container) {
+        pldm_entity entity{type, instance, container};
+        return pldm_entity_association_tree_add_entity(
+            tree, &entity, instance, parent, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+            true, true, 0xFFFF);
+    };
+
+    EntityAssociations entityAssociations{};
+    auto chassis = addEntity(45, 1, nullptr, 0);
+    auto motherboard = addEntity(64, 1, chassis, containerId++);
+    entityAssociations.push_back({chassis, motherboard});
+    Entities dcmAssociation{motherboard};
+    auto dcmContainer = containerId++;
+    for (uint16_t dcm = 0; dcm < dcms; dcm++)
+    {
+        auto dcmNode = addEntity(67, dcm, motherboard, dcmContainer);
+        dcmAssociation.push_back(dcmNode);
+        Entities cpuAssociation{dcmNode};
+        auto cpuContainer = containerId++;
+        for (uint16_t cpu = 0; cpu < cpusPerDcm; cpu++)
+        {
+            auto cpuNode = addEntity(135, cpu, dcmNode, cpuContainer);
+            cpuAssociation.push_back(cpuNode);
+            Entities coreAssociation{cpuNode};
+            auto coreContainer = containerId++;
+            for (uint16_t core = 0; core < coresPerCpu; core++)
+            {
+                coreAssociation.push_back(
+                    addEntity(32903, core, cpuNode, coreContainer));
+            }
+            entityAssociations.push_back(std::move(coreAssociation));
+        }
+        entityAssociations.push_back(std::move(cpuAssociation));
+    }
+    entityAssociations.push_back(std::move(dcmAssociation));
+
+    ObjectPathMaps objPathMap;
+    EntityMaps entityMaps = parseEntityMap("./entitymap_test.json");
+    auto start = std::chrono::steady_clock::now();
+    updateEntityAssociation(entityAssociations, tree, objPathMap, entityMaps,
+                            nullptr);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    RecordProperty("elapsed_ms", std::to_string(elapsed.count()));
+
+    size_t entities = 2 + dcms + dcms * cpusPerDcm +
+                      dcms * cpusPerDcm * coresPerCpu;
+    EXPECT_EQ(objPathMap.size(), entities);
+    EXPECT_TRUE(objPathMap.contains(
+        "/xyz/openbmc_project/inventory/chassis1/motherboard1/dcm255/cpu3/core3"));
+
+    pldm_entity_association_tree_destroy(tree);
+}
+
+TEST(MultipartTable, reassembly)
+{
+    // A table of 10 bytes, followed by 2 pad bytes and its checksum
+    std::vector<uint8_t> table{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 0, 0};
+    auto checksum = calcCrc32(table.data(), table.size());
+    table.resize(table.size() + sizeof(checksum));
+    auto le = htole32(checksum);
+    memcpy(table.data() + table.size() - sizeof(le), &le, sizeof(le));
+
+    auto reassemble = [&table](size_t partSize, MultipartTable& multipart) {
+        for (size_t offset = 0; offset < table.size(); offset += partSize)
+        {
+            auto length = std::min(partSize, table.size() - offset);
+            if (!multipart.append(
+                    std::span<const uint8_t>(table.data() + offset, length)))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // In a single part and in parts, only the table is returned
+    for (size_t partSize : {table.size(), size_t(1), size_t(5)})
+    {
+        MultipartTable multipart(10, checksum);
+        ASSERT_TRUE(reassemble(partSize, multipart));
+        auto records = multipart.verify();
+        ASSERT_TRUE(records.has_value());
+        EXPECT_TRUE(std::equal(records->begin(), records->end(),
+                               table.begin(), table.begin() + 10));
+        EXPECT_EQ(records->size(), 10);
+    }
+
+    // A checksum other than the one reported fails the integrity check
+    MultipartTable badChecksum(10, checksum + 1);
+    ASSERT_TRUE(reassemble(5, badChecksum));
+    EXPECT_FALSE(badChecksum.verify().has_value());
+
+    // A corrupted part fails the integrity check
+    MultipartTable corrupted(10, checksum);
+    table[3] ^= 0xff;
+    ASSERT_TRUE(reassemble(5, corrupted));
+    EXPECT_FALSE(corrupted.verify().has_value());
+    table[3] ^= 0xff;
+
+    // A table longer than reported is refused
+    MultipartTable tooLong(4, checksum);
+    EXPECT_FALSE(reassemble(5, tooLong));
+
+    // A table without its checksum fails the integrity check
+    MultipartTable truncated(10, checksum);
+    ASSERT_TRUE(truncated.append(std::span<const uint8_t>(table.data(), 2)));
+    EXPECT_FALSE(truncated.verify().has_value());
+}
@@ -4,8 +4,15 @@
 
 #include "utils.hpp"
 
+#include <endian.h>
+
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <iostream>
+#include <optional>
+#include <unordered_set>
 
 namespace pldm
 {
@@ -13,52 +20,142 @@ namespace hostbmc
 {
 namespace utils
 {
-Entities getParentEntites(const EntityAssociations& entityAssoc)
+pldm_entity_node* EntityTreeIndex::find(const pldm_entity& entity,
+                                        bool isRemote)
 {
-    Entities parents{};
-    for (const auto& et : entityAssoc)
+    auto entityKey = key(entity, isRemote);
+    auto it = nodes.find(entityKey);
+    if (it != nodes.end())
+    {
+        return it->second;
+    }
+    if (misses.contains(entityKey))
+    {
+        return nullptr;
+    }
+
+    pldm_entity lookup = entity;
+    auto node = pldm_entity_association_tree_find_with_locality(tree, &lookup,
+                                                                isRemote);
+    if (node)
+    {
+        nodes.emplace(entityKey, node);
+    }
+    else
     {
-        parents.push_back(et[0]);
+        misses.insert(entityKey);
     }
+    return node;
+}
 
-    bool found = false;
-    for (auto it = parents.begin(); it != parents.end();
-         it = found ? parents.erase(it) : std::next(it))
+pldm_entity_node* EntityTreeIndex::addEntity(
+    pldm_entity* entity, uint16_t entityInstanceNum, pldm_entity_node* parent,
+    uint8_t associationType, bool isRemote, bool isUpdateContainerId,
+    uint16_t containerId)
+{
+    auto node = pldm_entity_association_tree_add_entity(
+        tree, entity, entityInstanceNum, parent, associationType, isRemote,
+        isUpdateContainerId, containerId);
+    if (!node)
     {
-        uint16_t parent_contained_id =
-            pldm_entity_node_get_remote_container_id(*it);
-        found = false;
-        for (const auto& evs : entityAssoc)
+        return node;
+    }
+
+    // The added node, or the container ID it was given, may be one that was
+    // looked up and not found
+    misses.clear();
+    auto added = pldm_entity_extract(node);
+    nodes.try_emplace(key(added, false), node);
+    added.entity_container_id = pldm_entity_node_get_remote_container_id(node);
+    nodes.try_emplace(key(added, true), node);
+    return node;
+}
+
+/** @brief Key identifying an entity of a remote terminus, made of the entity
+ *         type, instance number and remote container ID
+ */
+using EntityKey = uint64_t;
+
+/** @brief Maps an entity to the indices of the entity associations in which
+ *         it is the container entity
+ */
+using AssociationIndex = std::unordered_map<EntityKey, std::vector<size_t>>;
+
+static EntityKey getEntityKey(pldm_entity_node* node)
+{
+    pldm_entity entity = pldm_entity_extract(node);
+    return (static_cast<EntityKey>(entity.entity_type) << 32) |
+           (static_cast<EntityKey>(entity.entity_instance_num) << 16) |
+           pldm_entity_node_get_remote_container_id(node);
+}
+
+/** @class InventoryPaths
+ *
+ *  D-Bus object paths hosted under the inventory. They are looked up from
+ *  the mapper with a single call, the first time a path is checked, instead
+ *  of one GetObject call per path.
+ */
+class InventoryPaths
+{
+  public:
+    /** @brief Check if a D-Bus object is hosted at the path
+     *
+     *  @param[in] path - D-Bus object path
+     *
+     *  @return true if the object exists
+     */
+    bool contains(const std::string& path)
+    {
+        if (!paths)
         {
-            for (size_t i = 1; i < evs.size() && !found; i++)
+            paths.emplace();
+            try
             {
-                uint16_t node_contained_id =
-                    pldm_entity_node_get_remote_container_id(evs[i]);
-
-                pldm_entity parent_entity = pldm_entity_extract(*it);
-                pldm_entity node_entity = pldm_entity_extract(evs[i]);
-
-                if (node_entity.entity_type == parent_entity.entity_type &&
-                    node_entity.entity_instance_num ==
-                        parent_entity.entity_instance_num &&
-                    node_contained_id == parent_contained_id)
-                {
-                    found = true;
-                }
+                auto response = pldm::utils::DBusHandler().getSubTreePaths(
+                    "/xyz/openbmc_project/inventory", 0, {});
+                paths->insert(response.begin(), response.end());
             }
-            if (found)
+            catch (const std::exception& e)
             {
-                break;
+                lg2::error(
+                    "Failed to look up the inventory D-Bus objects, error - {ERROR}",
+                    "ERROR", e);
             }
         }
+        return paths->contains(path);
+    }
+
+  private:
+    std::optional<std::unordered_set<std::string>> paths;
+};
+
+Entities getParentEntites(const EntityAssociations& entityAssoc)
+{
+    std::unordered_set<EntityKey> children{};
+    for (const auto& evs : entityAssoc)
+    {
+        for (size_t i = 1; i < evs.size(); i++)
+        {
+            children.emplace(getEntityKey(evs[i]));
+        }
+    }
+
+    Entities parents{};
+    for (const auto& et : entityAssoc)
+    {
+        if (!children.contains(getEntityKey(et[0])))
+        {
+            parents.push_back(et[0]);
+        }
     }
 
     return parents;
 }
 
-void addObjectPathEntityAssociations(
-    const EntityAssociations& entityAssoc, pldm_entity_node* entity,
-    const fs::path& path, ObjectPathMaps& objPathMap, EntityMaps entityMaps,
+static void addObjectPathEntityAssociations(
+    const EntityAssociations& entityAssoc, const AssociationIndex& assocIndex,
+    pldm_entity_node* entity, const fs::path& path, ObjectPathMaps& objPathMap,
+    const EntityMaps& entityMaps, InventoryPaths& inventoryPaths,
     pldm::responder::oem_platform::Handler* oemPlatformHandler)
 {
     if (entity == nullptr)
@@ -66,9 +163,9 @@ void addObjectPathEntityAssociations(
         return;
     }
 
-    bool found = false;
     pldm_entity node_entity = pldm_entity_extract(entity);
-    if (!entityMaps.contains(node_entity.entity_type))
+    auto entityName = entityMaps.find(node_entity.entity_type);
+    if (entityName == entityMaps.end())
     {
         lg2::info(
             "{ENTITY_TYPE} Entity fetched from remote PLDM terminal does not exist.",
@@ -76,78 +173,47 @@ void addObjectPathEntityAssociations(
         return;
     }
 
-    std::string entityName = entityMaps.at(node_entity.entity_type);
-    for (const auto& ev : entityAssoc)
+    fs::path p = path /
+                 fs::path{entityName->second +
+                          std::to_string(node_entity.entity_instance_num)};
+    auto associations = assocIndex.find(getEntityKey(entity));
+    if (associations == assocIndex.end())
     {
-        pldm_entity ev_entity = pldm_entity_extract(ev[0]);
-        if (ev_entity.entity_instance_num == node_entity.entity_instance_num &&
-            ev_entity.entity_type == node_entity.entity_type)
+        std::string dbusPath = p.string();
+        if (oemPlatformHandler)
         {
-            uint16_t node_contained_id =
-                pldm_entity_node_get_remote_container_id(ev[0]);
-            uint16_t entity_contained_id =
-                pldm_entity_node_get_remote_container_id(entity);
-
-            if (node_contained_id != entity_contained_id)
-            {
-                continue;
-            }
-
-            fs::path p = path / fs::path{entityName +
-                                         std::to_string(
-                                             node_entity.entity_instance_num)};
-            std::string entity_path = p.string();
-            if (oemPlatformHandler)
-            {
-                oemPlatformHandler->updateOemDbusPaths(entity_path);
-            }
-            // If the entity obtained from the remote PLDM terminal is not in
-            // the MAP, or there is no auxiliary name PDR, add it directly.
-            // Otherwise, check whether the DBus service of entity_path exists,
-            // and overwrite the entity if it does not exist.
-            if (!objPathMap.contains(entity_path))
-            {
-                objPathMap[entity_path] = entity;
-            }
-            else
-            {
-                try
-                {
-                    pldm::utils::DBusHandler().getService(entity_path.c_str(),
-                                                          nullptr);
-                }
-                catch (const std::exception& e)
-                {
-                    objPathMap[entity_path] = entity;
-                }
-            }
-
-            for (size_t i = 1; i < ev.size(); i++)
-            {
-                addObjectPathEntityAssociations(entityAssoc, ev[i], p,
-                                                objPathMap, entityMaps,
-                                                oemPlatformHandler);
-            }
-            found = true;
+            oemPlatformHandler->updateOemDbusPaths(dbusPath);
+        }
+        if (!inventoryPaths.contains(dbusPath))
+        {
+            objPathMap[dbusPath] = entity;
         }
+        return;
     }
 
-    if (!found)
+    for (auto index : associations->second)
     {
-        std::string dbusPath =
-            path / fs::path{entityName +
-                            std::to_string(node_entity.entity_instance_num)};
+        const auto& ev = entityAssoc[index];
+        std::string entity_path = p.string();
         if (oemPlatformHandler)
         {
-            oemPlatformHandler->updateOemDbusPaths(dbusPath);
+            oemPlatformHandler->updateOemDbusPaths(entity_path);
         }
-        try
+        // If the entity obtained from the remote PLDM terminal is not in
+        // the MAP, or there is no auxiliary name PDR, add it directly.
+        // Otherwise, check whether the DBus service of entity_path exists,
+        // and overwrite the entity if it does not exist.
+        if (!objPathMap.contains(entity_path) ||
+            !inventoryPaths.contains(entity_path))
         {
-            pldm::utils::DBusHandler().getService(dbusPath.c_str(), nullptr);
+            objPathMap[entity_path] = entity;
         }
-        catch (const std::exception& e)
+
+        for (size_t i = 1; i < ev.size(); i++)
         {
-            objPathMap[dbusPath] = entity;
+            addObjectPathEntityAssociations(entityAssoc, assocIndex, ev[i], p,
+                                            objPathMap, entityMaps,
+                                            inventoryPaths, oemPlatformHandler);
         }
     }
 }
@@ -155,9 +221,17 @@ void addObjectPathEntityAssociations(
 void updateEntityAssociation(
     const EntityAssociations& entityAssoc,
     pldm_entity_association_tree* entityTree, ObjectPathMaps& objPathMap,
-    EntityMaps entityMaps,
+    const EntityMaps& entityMaps,
     pldm::responder::oem_platform::Handler* oemPlatformHandler)
 {
+    AssociationIndex assocIndex{};
+    for (size_t index = 0; index < entityAssoc.size(); index++)
+    {
+        assocIndex[getEntityKey(entityAssoc[index][0])].push_back(index);
+    }
+
+    EntityTreeIndex treeIndex(entityTree);
+    InventoryPaths inventoryPaths{};
     std::vector<pldm_entity_node*> parentsEntity =
         getParentEntites(entityAssoc);
     for (const auto& entity : parentsEntity)
@@ -165,8 +239,7 @@ void updateEntityAssociation(
         fs::path path{"/xyz/openbmc_project/inventory"};
         std::deque<std::string> paths{};
         pldm_entity node_entity = pldm_entity_extract(entity);
-        auto node = pldm_entity_association_tree_find_with_locality(
-            entityTree, &node_entity, false);
+        auto node = treeIndex.find(node_entity, false);
         if (!node)
         {
             continue;
@@ -196,8 +269,7 @@ void updateEntityAssociation(
                 break;
             }
 
-            node = pldm_entity_association_tree_find_with_locality(
-                entityTree, &parent, false);
+            node = treeIndex.find(parent, false);
         }
 
         if (!found)
@@ -211,11 +283,56 @@ void updateEntityAssociation(
             paths.pop_back();
         }
 
-        addObjectPathEntityAssociations(entityAssoc, entity, path, objPathMap,
-                                        entityMaps, oemPlatformHandler);
+        addObjectPathEntityAssociations(entityAssoc, assocIndex, entity, path,
+                                        objPathMap, entityMaps, inventoryPaths,
+                                        oemPlatformHandler);
     }
 }
 
+MultipartTable::MultipartTable(uint32_t tableLength, uint32_t checksum) :
+    tableLength(tableLength), checksum(checksum)
+{
+    table.reserve(tableLength + 3 + sizeof(checksum));
+}
+
+bool MultipartTable::append(std::span<const uint8_t> part)
+{
+    if (table.size() + part.size() > tableLength + 3 + sizeof(checksum))
+    {
+        return false;
+    }
+    table.insert(table.end(), part.begin(), part.end());
+    return true;
+}
+
+std::optional<std::span<const uint8_t>> MultipartTable::verify() const
+{
+    uint32_t trailingChecksum = 0;
+    if (table.size() < sizeof(trailingChecksum))
+    {
+        lg2::error("Remote table of {SIZE} bytes has no checksum", "SIZE",
+                   table.size());
+        return std::nullopt;
+    }
+
+    auto dataSize = table.size() - sizeof(trailingChecksum);
+    memcpy(&trailingChecksum, table.data() + dataSize,
+           sizeof(trailingChecksum));
+    trailingChecksum = le32toh(trailingChecksum);
+    auto calculated = pldm::utils::calcCrc32(table.data(), dataSize);
+    if (calculated != trailingChecksum || calculated != checksum)
+    {
+        lg2::error(
+            "Remote table failed the integrity check, checksum '{CHECKSUM}', reported checksum '{REPORTED_CHECKSUM}' and calculated checksum '{CALCULATED}'",
+            "CHECKSUM", lg2::hex, trailingChecksum, "REPORTED_CHECKSUM",
+            lg2::hex, checksum, "CALCULATED", lg2::hex, calculated);
+        return std::nullopt;
+    }
+
+    return std::span<const uint8_t>(
+        table.data(), std::min<size_t>(tableLength, dataSize));
+}
+
 EntityMaps parseEntityMap(const fs::path& filePath)
 {
     const Json emptyJson{};
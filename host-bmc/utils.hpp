@@ -8,7 +8,11 @@
 #include <filesystem>
 #include <fstream>
 #include <map>
+#include <optional>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 PHOSPHOR_LOG2_USING;
@@ -28,6 +32,140 @@ namespace hostbmc
 namespace utils
 {
 
+/** @class EntityTreeIndex
+ *
+ *  Hash index over the nodes of an entity association tree, keyed on the
+ *  entity type, instance number, container ID and locality, so looking up a
+ *  node does not walk the whole tree. The index is filled on every node found
+ *  or added through it. Entities not found in the tree are recorded too, until
+ *  the next node is added through the index or clearMisses() is called, so
+ *  the PDRs of entities the tree lacks do not walk it again and again. Nodes
+ *  added to the tree behind the index's back are found once the misses are
+ *  cleared.
+ */
+class EntityTreeIndex
+{
+  public:
+    EntityTreeIndex() = delete;
+    EntityTreeIndex(const EntityTreeIndex&) = delete;
+    EntityTreeIndex& operator=(const EntityTreeIndex&) = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] tree - entity association tree to index
+     */
+    explicit EntityTreeIndex(pldm_entity_association_tree* tree) : tree(tree)
+    {}
+
+    /** @brief Find an entity in the tree, same as
+     *         pldm_entity_association_tree_find_with_locality
+     *
+     *  @param[in] entity - entity to look up
+     *  @param[in] isRemote - look up by the remote container ID
+     *
+     *  @return pldm_entity_node* - the node, nullptr if not found
+     */
+    pldm_entity_node* find(const pldm_entity& entity, bool isRemote);
+
+    /** @brief Add an entity to the tree and to the index, same as
+     *         pldm_entity_association_tree_add_entity
+     *
+     *  @return pldm_entity_node* - the added node, nullptr on failure
+     */
+    pldm_entity_node* addEntity(pldm_entity* entity, uint16_t entityInstanceNum,
+                                pldm_entity_node* parent,
+                                uint8_t associationType, bool isRemote,
+                                bool isUpdateContainerId,
+                                uint16_t containerId);
+
+    /** @brief Drop all the indexed nodes, this has to be called whenever
+     *         nodes are removed from the tree
+     */
+    void clear()
+    {
+        nodes.clear();
+        misses.clear();
+    }
+
+    /** @brief Drop the entities recorded as not found, this has to be called
+     *         once nodes may have been added to the tree behind the index's
+     *         back
+     */
+    void clearMisses()
+    {
+        misses.clear();
+    }
+
+    /** @brief Drop an indexed node, this has to be called before the node is
+     *         removed from the tree
+     *
+     *  @param[in] node - node about to be removed from the tree
+     */
+    void erase(const pldm_entity_node* node)
+    {
+        std::erase_if(nodes,
+                      [node](const auto& item) { return item.second == node; });
+    }
+
+  private:
+    /** @brief Index key of the entity
+     */
+    static uint64_t key(const pldm_entity& entity, bool isRemote)
+    {
+        return (static_cast<uint64_t>(isRemote) << 48) |
+               (static_cast<uint64_t>(entity.entity_type) << 32) |
+               (static_cast<uint64_t>(entity.entity_instance_num) << 16) |
+               entity.entity_container_id;
+    }
+
+    pldm_entity_association_tree* tree;
+    std::unordered_map<uint64_t, pldm_entity_node*> nodes;
+
+    /** @brief Keys of the entities not found in the tree */
+    std::unordered_set<uint64_t> misses;
+};
+
+/** @class MultipartTable
+ *
+ *  Reassembles a table received from a remote terminus in the parts of a
+ *  multipart transfer. The table is followed by up to 3 pad bytes and the
+ *  CRC32 checksum of the table and the pad bytes.
+ */
+class MultipartTable
+{
+  public:
+    /** @brief Constructor
+     *
+     *  @param[in] tableLength - length of the table without the pad bytes and
+     *                           the checksum, as reported by the terminus
+     *  @param[in] checksum - checksum of the table, as reported by the
+     *                        terminus
+     */
+    MultipartTable(uint32_t tableLength, uint32_t checksum);
+
+    /** @brief Append a part of the table
+     *
+     *  @param[in] part - the part
+     *
+     *  @return bool - false if the table would exceed the length reported by
+     *          the terminus, the part is not appended then
+     */
+    bool append(std::span<const uint8_t> part);
+
+    /** @brief Check the reassembled table against both its trailing checksum
+     *         and the checksum reported by the terminus
+     *
+     *  @return the table without the pad bytes and the checksum, std::nullopt
+     *          if it fails the integrity check
+     */
+    std::optional<std::span<const uint8_t>> verify() const;
+
+  private:
+    uint32_t tableLength;
+    uint32_t checksum;
+    std::vector<uint8_t> table;
+};
+
 /** @brief Vector a entity name to pldm_entity from entity association tree
  *  @param[in]  entityAssoc    - Vector of associated pldm entities
  *  @param[in]  entityTree     - entity association tree
@@ -38,7 +176,7 @@ namespace utils
 void updateEntityAssociation(
     const EntityAssociations& entityAssoc,
     pldm_entity_association_tree* entityTree, ObjectPathMaps& objPathMap,
-    EntityMaps entityMaps,
+    const EntityMaps& entityMaps,
     pldm::responder::oem_platform::Handler* oemPlatformHandler);
 
 /** @brief Parsing entity to DBus string mapping from json file
@@ -6,6 +6,7 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <ctime>
@@ -72,10 +73,10 @@ Handler::Handler(
     int fd, uint8_t eid, pldm::InstanceIdDb* instanceIdDb,
     pldm::requester::Handler<pldm::requester::Request>* handler,
     pldm::responder::platform_config::Handler* platformConfigHandler,
-    pldm::responder::bios::Callback requestPLDMServiceName) :
-    biosConfig(BIOS_JSONS_DIR, BIOS_TABLES_DIR, &dbusHandler, fd, eid,
-               instanceIdDb, handler, platformConfigHandler,
-               requestPLDMServiceName)
+    pldm::responder::bios::Callback requestPLDMServiceName,
+    const char* jsonDir, const char* tableDir) :
+    biosConfig(jsonDir, tableDir, &dbusHandler, fd, eid, instanceIdDb, handler,
+               platformConfigHandler, requestPLDMServiceName)
 {
     handlers.emplace(
         PLDM_SET_DATE_TIME,
@@ -89,13 +90,13 @@ Handler::Handler(
     });
     handlers.emplace(
         PLDM_GET_BIOS_TABLE,
-        [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
-        return this->getBIOSTable(request, payloadLength);
+        [this](pldm_tid_t tid, const pldm_msg* request, size_t payloadLength) {
+        return this->getBIOSTable(tid, request, payloadLength);
     });
     handlers.emplace(
         PLDM_SET_BIOS_TABLE,
-        [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
-        return this->setBIOSTable(request, payloadLength);
+        [this](pldm_tid_t tid, const pldm_msg* request, size_t payloadLength) {
+        return this->setBIOSTable(tid, request, payloadLength);
     });
     handlers.emplace(
         PLDM_GET_BIOS_ATTRIBUTE_CURRENT_VALUE_BY_HANDLE,
@@ -226,7 +227,8 @@ Response Handler::setDateTime(const pldm_msg* request, size_t payloadLength)
     return ccOnlyResponse(request, PLDM_SUCCESS);
 }
 
-Response Handler::getBIOSTable(const pldm_msg* request, size_t payloadLength)
+Response Handler::getBIOSTable(pldm_tid_t tid, const pldm_msg* request,
+                               size_t payloadLength)
 {
     uint32_t transferHandle{};
     uint8_t transferOpFlag{};
@@ -239,44 +241,157 @@ Response Handler::getBIOSTable(const pldm_msg* request, size_t payloadLength)
         return ccOnlyResponse(request, rc);
     }
 
-    auto table =
-        biosConfig.getBIOSTable(static_cast<pldm_bios_table_types>(tableType));
-    if (!table)
+    std::shared_ptr<const Table> table;
+    if (transferOpFlag == PLDM_GET_FIRSTPART)
     {
-        return ccOnlyResponse(request, PLDM_BIOS_TABLE_UNAVAILABLE);
+        // Serve the whole transfer from the version of the table at the
+        // first part, even if the table is updated in the meantime
+        table = biosConfig.getSharedBIOSTable(
+            static_cast<pldm_bios_table_types>(tableType));
+        if (!table)
+        {
+            return ccOnlyResponse(request, PLDM_BIOS_TABLE_UNAVAILABLE);
+        }
+        transferHandle = 0;
+    }
+    else if (transferOpFlag == PLDM_GET_NEXTPART)
+    {
+        auto transfer = getTableTransfers.find(tid);
+        if (transfer == getTableTransfers.end() ||
+            transfer->second.tableType != tableType)
+        {
+            return ccOnlyResponse(request, PLDM_ERROR_INVALID_DATA);
+        }
+        table = transfer->second.table;
+        // A part may be requested again when its response got lost
+        if (!transferSize || transferHandle == 0 ||
+            transferHandle >= table->size() || transferHandle % transferSize)
+        {
+            return ccOnlyResponse(request, PLDM_ERROR_INVALID_DATA);
+        }
+    }
+    else
+    {
+        return ccOnlyResponse(request, PLDM_INVALID_TRANSFER_OPERATION_FLAG);
     }
 
+    size_t partSize = table->size() - transferHandle;
+    if (transferSize)
+    {
+        partSize = std::min(partSize, transferSize);
+    }
+    bool lastPart = transferHandle + partSize == table->size();
+    uint8_t transferFlag{};
+    if (transferHandle == 0)
+    {
+        transferFlag = lastPart ? PLDM_START_AND_END : PLDM_START;
+    }
+    else
+    {
+        transferFlag = lastPart ? PLDM_END : PLDM_MIDDLE;
+    }
+    uint32_t nextTransferHandle = lastPart ? 0 : transferHandle + partSize;
+
     Response response(sizeof(pldm_msg_hdr) +
-                      PLDM_GET_BIOS_TABLE_MIN_RESP_BYTES + table->size());
+                      PLDM_GET_BIOS_TABLE_MIN_RESP_BYTES + partSize);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
     rc = encode_get_bios_table_resp(
-        request->hdr.instance_id, PLDM_SUCCESS, 0 /* nxtTransferHandle */,
-        PLDM_START_AND_END, table->data(), response.size(), responsePtr);
+        request->hdr.instance_id, PLDM_SUCCESS, nextTransferHandle,
+        transferFlag, table->data() + transferHandle, response.size(),
+        responsePtr);
     if (rc != PLDM_SUCCESS)
     {
         return ccOnlyResponse(request, rc);
     }
 
+    if (transferOpFlag == PLDM_GET_FIRSTPART)
+    {
+        // Kept after the last part too, so that it can be requested again
+        getTableTransfers.insert_or_assign(
+            tid, GetTableTransfer{tableType, std::move(table)});
+    }
+
     return response;
 }
 
-Response Handler::setBIOSTable(const pldm_msg* request, size_t payloadLength)
+Response Handler::setBIOSTable(pldm_tid_t tid, const pldm_msg* request,
+                               size_t payloadLength)
 {
     uint32_t transferHandle{};
-    uint8_t transferOpFlag{};
+    uint8_t transferFlag{};
     uint8_t tableType{};
     struct variable_field field;
 
     auto rc = decode_set_bios_table_req(request, payloadLength, &transferHandle,
-                                        &transferOpFlag, &tableType, &field);
+                                        &transferFlag, &tableType, &field);
     if (rc != PLDM_SUCCESS)
     {
         return ccOnlyResponse(request, rc);
     }
 
-    Table table(field.ptr, field.ptr + field.length);
-    rc = biosConfig.setBIOSTable(tableType, table);
+    uint32_t nextTransferHandle = 0;
+    if (transferFlag == PLDM_START_AND_END)
+    {
+        setTableTransfers.erase(tid);
+        Table table(field.ptr, field.ptr + field.length);
+        rc = biosConfig.setBIOSTable(tableType, table);
+    }
+    else if (transferFlag == PLDM_START)
+    {
+        // A new transfer discards an unfinished one from the same requester
+        auto current = biosConfig.getSharedBIOSTable(
+            static_cast<pldm_bios_table_types>(tableType));
+        auto maxSize = (current ? current->size() : 0) + setTableSizeMargin;
+        if (field.length > maxSize)
+        {
+            setTableTransfers.erase(tid);
+            return ccOnlyResponse(request, PLDM_ERROR_INVALID_LENGTH);
+        }
+
+        auto& transfer = setTableTransfers[tid];
+        transfer.tableType = tableType;
+        transfer.maxSize = maxSize;
+        transfer.table.assign(field.ptr, field.ptr + field.length);
+        transfer.nextTransferHandle = transfer.table.size();
+        nextTransferHandle = transfer.nextTransferHandle;
+    }
+    else if (transferFlag == PLDM_MIDDLE || transferFlag == PLDM_END)
+    {
+        auto transfer = setTableTransfers.find(tid);
+        if (transfer == setTableTransfers.end() ||
+            transfer->second.tableType != tableType ||
+            transfer->second.nextTransferHandle != transferHandle)
+        {
+            return ccOnlyResponse(request, PLDM_ERROR_INVALID_DATA);
+        }
+
+        auto& table = transfer->second.table;
+        if (field.length > transfer->second.maxSize - table.size())
+        {
+            error(
+                "SetBIOSTable transfer of table type '{TYPE}' exceeds {SIZE} bytes",
+                "TYPE", tableType, "SIZE", transfer->second.maxSize);
+            setTableTransfers.erase(transfer);
+            return ccOnlyResponse(request, PLDM_ERROR_INVALID_LENGTH);
+        }
+        table.insert(table.end(), field.ptr, field.ptr + field.length);
+        if (transferFlag == PLDM_END)
+        {
+            rc = biosConfig.setBIOSTable(tableType, table);
+            setTableTransfers.erase(transfer);
+        }
+        else
+        {
+            transfer->second.nextTransferHandle = table.size();
+            nextTransferHandle = table.size();
+        }
+    }
+    else
+    {
+        return ccOnlyResponse(request, PLDM_ERROR_INVALID_DATA);
+    }
+
     if (rc != PLDM_SUCCESS)
     {
         return ccOnlyResponse(request, rc);
@@ -286,7 +401,7 @@ Response Handler::setBIOSTable(const pldm_msg* request, size_t payloadLength)
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
     rc = encode_set_bios_table_resp(request->hdr.instance_id, PLDM_SUCCESS,
-                                    0 /* nxtTransferHandle */, responsePtr);
+                                    nextTransferHandle, responsePtr);
     if (rc != PLDM_SUCCESS)
     {
         return ccOnlyResponse(request, rc);
@@ -14,6 +14,7 @@
 #include <ctime>
 #include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace pldm
@@ -25,6 +26,29 @@ namespace responder
 namespace bios
 {
 
+/** @struct GetTableTransfer
+ *
+ *  State of a multipart GetBIOSTable transfer to a requester. The data
+ *  transfer handle of a part is the offset of the part in the table.
+ */
+struct GetTableTransfer
+{
+    uint8_t tableType;
+    std::shared_ptr<const Table> table; //!< version of the table served
+};
+
+/** @struct SetTableTransfer
+ *
+ *  State of a multipart SetBIOSTable transfer from a requester
+ */
+struct SetTableTransfer
+{
+    uint8_t tableType;
+    uint32_t nextTransferHandle;
+    size_t maxSize; //!< the transfer is rejected past this table size
+    Table table;    //!< parts of the table received so far
+};
+
 class Handler : public CmdHandler
 {
   public:
@@ -37,11 +61,15 @@ class Handler : public CmdHandler
      *  @param[in] platformConfigHandler - pointer to platform config object
      *  @param[in] requestPLDMServiceName - Callback for registering the PLDM
      *                                      service
+     *  @param[in] jsonDir - path to BIOS attribute JSON files
+     *  @param[in] tableDir - path to persist the BIOS tables
      */
     Handler(int fd, uint8_t eid, pldm::InstanceIdDb* instanceIdDb,
             pldm::requester::Handler<pldm::requester::Request>* handler,
             pldm::responder::platform_config::Handler* platformConfigHandler,
-            pldm::responder::bios::Callback requestPLDMServiceName);
+            pldm::responder::bios::Callback requestPLDMServiceName,
+            const char* jsonDir = BIOS_JSONS_DIR,
+            const char* tableDir = BIOS_TABLES_DIR);
 
     /** @brief Handler for GetDateTime
      *
@@ -50,21 +78,38 @@ class Handler : public CmdHandler
      */
     Response getDateTime(const pldm_msg* request, size_t payloadLength);
 
-    /** @brief Handler for GetBIOSTable
+    /** @brief Set the maximum size of a part of a GetBIOSTable transfer
      *
+     *  @param[in] size - maximum size of the BIOS table data in a part, 0 to
+     *                    send the whole table in a single part
+     */
+    void setTransferSize(size_t size)
+    {
+        transferSize = size;
+    }
+
+    /** @brief Handler for GetBIOSTable, the table is transferred in parts of
+     *         at most transferSize bytes
+     *
+     *  @param[in] tid - TID of the requester
      *  @param[in] request - Request message
      *  @param[in] payload_length - Request message payload length
      *  @return Response - PLDM Response message
      */
-    Response getBIOSTable(const pldm_msg* request, size_t payloadLength);
+    Response getBIOSTable(pldm_tid_t tid, const pldm_msg* request,
+                          size_t payloadLength);
 
-    /** @brief Handler for SetBIOSTable
+    /** @brief Handler for SetBIOSTable, the table is applied once its last
+     *         part is received. A multipart transfer may grow the table by at
+     *         most setTableSizeMargin bytes over its current size
      *
+     *  @param[in] tid - TID of the requester
      *  @param[in] request - Request message
      *  @param[in] payload_length - Request message payload length
      *  @return Response - PLDM Response message
      */
-    Response setBIOSTable(const pldm_msg* request, size_t payloadLength);
+    Response setBIOSTable(pldm_tid_t tid, const pldm_msg* request,
+                          size_t payloadLength);
 
     /** @brief Handler for GetBIOSAttributeCurrentValueByHandle
      *
@@ -94,6 +139,19 @@ class Handler : public CmdHandler
 
   private:
     BIOSConfig biosConfig;
+
+    /** @brief Maximum size of the BIOS table data in a part of a GetBIOSTable
+     *         transfer, 0 for no limit
+     */
+    size_t transferSize = BIOS_TABLE_TRANSFER_SIZE;
+
+    static constexpr size_t setTableSizeMargin = 64 * 1024;
+
+    /** @brief Multipart GetBIOSTable transfers in progress, by requester */
+    std::map<pldm_tid_t, GetTableTransfer> getTableTransfers;
+
+    /** @brief Multipart SetBIOSTable transfers in progress, by requester */
+    std::map<pldm_tid_t, SetTableTransfer> setTableTransfers;
 };
 
 } // namespace bios
@@ -9,8 +9,10 @@
 #include <phosphor-logging/lg2.hpp>
 #include <xyz/openbmc_project/BIOSConfig/Manager/server.hpp>
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <type_traits>
 
 #ifdef OEM_IBM
 #include "oem/ibm/libpldmresponder/platform_oem_ibm.hpp"
@@ -39,6 +41,52 @@ constexpr auto stringTableFile = "stringTable";
 constexpr auto attrTableFile = "attributeTable";
 constexpr auto attrValueTableFile = "attributeValueTable";
 
+constexpr std::array<const char*, PLDM_BIOS_ATTR_VAL_TABLE + 1> tableFiles{
+    stringTableFile, attrTableFile, attrValueTableFile};
+
+/** @brief Window over which the updates of the BaseBIOSTable property are
+ *         coalesced into a single publication
+ */
+constexpr auto baseBIOSTableUpdateWindow = std::chrono::milliseconds(100);
+
+/** @brief Approximate size of the BaseBIOSTable property on the bus, only
+ *         the variable length data is accounted for
+ */
+size_t baseBIOSTableSize(const BaseBIOSTable& baseBIOSTable)
+{
+    auto valueSize = [](const auto& value) {
+        return std::visit(
+            [](const auto& v) -> size_t {
+            if constexpr (std::is_same_v<std::decay_t<decltype(v)>,
+                                         std::string>)
+            {
+                return v.size();
+            }
+            else
+            {
+                return sizeof(v);
+            }
+        },
+            value);
+    };
+
+    size_t size = 0;
+    for (const auto& [name, attr] : baseBIOSTable)
+    {
+        const auto& [type, readOnly, displayName, description, menuPath,
+                     currentValue, defaultValue, options] = attr;
+        size += name.size() + type.size() + sizeof(readOnly) +
+                displayName.size() + description.size() + menuPath.size() +
+                valueSize(currentValue) + valueSize(defaultValue);
+        for (const auto& [optionString, optionValue, valueName] : options)
+        {
+            size += optionString.size() + valueSize(optionValue) +
+                    valueName.size();
+        }
+    }
+    return size;
+}
+
 } // namespace
 
 BIOSConfig::BIOSConfig(
@@ -65,6 +113,11 @@ BIOSConfig::BIOSConfig(
     listenPendingAttributes();
 }
 
+BIOSConfig::~BIOSConfig()
+{
+    persistTables();
+}
+
 void BIOSConfig::checkSystemTypeAvailability()
 {
     if (platformConfigHandler)
@@ -115,42 +168,39 @@ void BIOSConfig::buildTables()
 
 std::optional<Table> BIOSConfig::getBIOSTable(pldm_bios_table_types tableType)
 {
-    fs::path tablePath;
-    switch (tableType)
+    if (tableType >= tables.size() || !tables[tableType])
     {
-        case PLDM_BIOS_STRING_TABLE:
-            tablePath = tableDir / stringTableFile;
-            break;
-        case PLDM_BIOS_ATTR_TABLE:
-            tablePath = tableDir / attrTableFile;
-            break;
-        case PLDM_BIOS_ATTR_VAL_TABLE:
-            tablePath = tableDir / attrValueTableFile;
-            break;
+        return std::nullopt;
     }
-    return loadTable(tablePath);
+    return *tables[tableType];
+}
+
+std::shared_ptr<const Table>
+    BIOSConfig::getSharedBIOSTable(pldm_bios_table_types tableType) const
+{
+    if (tableType >= tables.size())
+    {
+        return nullptr;
+    }
+    return tables[tableType];
 }
 
 int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
                              bool updateBaseBIOSTable)
 {
-    fs::path stringTablePath(tableDir / stringTableFile);
-    fs::path attrTablePath(tableDir / attrTableFile);
-    fs::path attrValueTablePath(tableDir / attrValueTableFile);
-
     if (!pldm_bios_table_checksum(table.data(), table.size()))
     {
         return PLDM_INVALID_BIOS_TABLE_DATA_INTEGRITY_CHECK;
     }
 
+    bool baseBIOSTableChanged = false;
     if (tableType == PLDM_BIOS_STRING_TABLE)
     {
-        storeTable(stringTablePath, table);
+        storeTable(PLDM_BIOS_STRING_TABLE, table);
     }
     else if (tableType == PLDM_BIOS_ATTR_TABLE)
     {
-        BIOSTable biosStringTable(stringTablePath.c_str());
-        if (biosStringTable.isEmpty())
+        if (!tables[PLDM_BIOS_STRING_TABLE])
         {
             return PLDM_INVALID_BIOS_TABLE_TYPE;
         }
@@ -161,24 +211,26 @@ int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
             return rc;
         }
 
-        storeTable(attrTablePath, table);
+        storeTable(PLDM_BIOS_ATTR_TABLE, table);
     }
     else if (tableType == PLDM_BIOS_ATTR_VAL_TABLE)
     {
-        BIOSTable biosStringTable(stringTablePath.c_str());
-        BIOSTable biosStringValueTable(attrTablePath.c_str());
-        if (biosStringTable.isEmpty() || biosStringValueTable.isEmpty())
+        if (!tables[PLDM_BIOS_STRING_TABLE] || !tables[PLDM_BIOS_ATTR_TABLE])
         {
             return PLDM_INVALID_BIOS_TABLE_TYPE;
         }
 
+        BaseBIOSTable previous;
+        previous.swap(baseBIOSTableMaps);
         auto rc = checkAttributeValueTable(table);
         if (rc != PLDM_SUCCESS)
         {
+            baseBIOSTableMaps.swap(previous);
             return rc;
         }
+        baseBIOSTableChanged = baseBIOSTableMaps != previous;
 
-        storeTable(attrValueTablePath, table);
+        storeTable(PLDM_BIOS_ATTR_VAL_TABLE, table);
     }
     else
     {
@@ -187,7 +239,7 @@ int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
 
     if ((tableType == PLDM_BIOS_ATTR_VAL_TABLE) && updateBaseBIOSTable)
     {
-        updateBaseBIOSTableProperty();
+        updateBaseBIOSTableProperty(baseBIOSTableChanged);
     }
 
     return PLDM_SUCCESS;
@@ -196,15 +248,13 @@ int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
 int BIOSConfig::checkAttributeTable(const Table& table)
 {
     using namespace pldm::bios::utils;
-    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
     for (auto entry :
          BIOSTableIter<PLDM_BIOS_ATTR_TABLE>(table.data(), table.size()))
     {
         auto attrNameHandle =
             pldm_bios_table_attr_entry_decode_string_handle(entry);
 
-        auto stringEnty = pldm_bios_table_string_find_by_handle(
-            stringTable->data(), stringTable->size(), attrNameHandle);
+        auto stringEnty = biosStringTable->findEntry(attrNameHandle);
         if (stringEnty == nullptr)
         {
             return PLDM_INVALID_BIOS_ATTR_HANDLE;
@@ -235,8 +285,7 @@ int BIOSConfig::checkAttributeTable(const Table& table)
 
                 for (size_t i = 0; i < pvHandls.size(); i++)
                 {
-                    auto stringEntry = pldm_bios_table_string_find_by_handle(
-                        stringTable->data(), stringTable->size(), pvHandls[i]);
+                    auto stringEntry = biosStringTable->findEntry(pvHandls[i]);
                     if (stringEntry == nullptr)
                     {
                         return PLDM_INVALID_BIOS_ATTR_HANDLE;
@@ -245,9 +294,8 @@ int BIOSConfig::checkAttributeTable(const Table& table)
 
                 for (size_t i = 0; i < defIndices.size(); i++)
                 {
-                    auto stringEntry = pldm_bios_table_string_find_by_handle(
-                        stringTable->data(), stringTable->size(),
-                        pvHandls[defIndices[i]]);
+                    auto stringEntry =
+                        biosStringTable->findEntry(pvHandls[defIndices[i]]);
                     if (stringEntry == nullptr)
                     {
                         return PLDM_INVALID_BIOS_ATTR_HANDLE;
@@ -273,8 +321,6 @@ int BIOSConfig::checkAttributeTable(const Table& table)
 int BIOSConfig::checkAttributeValueTable(const Table& table)
 {
     using namespace pldm::bios::utils;
-    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
-    auto attrTable = getBIOSTable(PLDM_BIOS_ATTR_TABLE);
 
     baseBIOSTableMaps.clear();
 
@@ -299,8 +345,7 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
         auto attrType = static_cast<pldm_bios_attribute_type>(
             pldm_bios_table_attr_value_entry_decode_attribute_type(tableEntry));
 
-        auto attrEntry = pldm_bios_table_attr_find_by_handle(
-            attrTable->data(), attrTable->size(), attrValueHandle);
+        auto attrEntry = findAttrEntry(attrValueHandle);
         if (attrEntry == nullptr)
         {
             return PLDM_INVALID_BIOS_ATTR_HANDLE;
@@ -310,20 +355,12 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
         auto attrNameHandle =
             pldm_bios_table_attr_entry_decode_string_handle(attrEntry);
 
-        auto stringEntry = pldm_bios_table_string_find_by_handle(
-            stringTable->data(), stringTable->size(), attrNameHandle);
+        auto stringEntry = biosStringTable->findEntry(attrNameHandle);
         if (stringEntry == nullptr)
         {
             return PLDM_INVALID_BIOS_ATTR_HANDLE;
         }
-        auto strLength =
-            pldm_bios_table_string_entry_decode_string_length(stringEntry);
-        std::vector<char> buffer(strLength + 1 /* sizeof '\0' */);
-        // Preconditions are upheld therefore no error check necessary
-        pldm_bios_table_string_entry_decode_string_check(
-            stringEntry, buffer.data(), buffer.size());
-
-        attributeName = std::string(buffer.data(), buffer.data() + strLength);
+        attributeName = table::string::decodeString(stringEntry);
 
         if (!biosAttributes.empty())
         {
@@ -350,22 +387,9 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
                     valueDisplayNames.insert(valueDisplayNames.end(),
                                              vdn.begin(), vdn.end());
                 }
-                auto getValue = [](uint16_t handle,
-                                   const Table& table) -> std::string {
-                    auto stringEntry = pldm_bios_table_string_find_by_handle(
-                        table.data(), table.size(), handle);
-
-                    auto strLength =
-                        pldm_bios_table_string_entry_decode_string_length(
-                            stringEntry);
-                    std::vector<char> buffer(strLength + 1 /* sizeof '\0' */);
-                    // Preconditions are upheld therefore no error check
-                    // necessary
-                    pldm_bios_table_string_entry_decode_string_check(
-                        stringEntry, buffer.data(), buffer.size());
-
-                    return std::string(buffer.data(),
-                                       buffer.data() + strLength);
+                auto getValue = [this](uint16_t handle) -> std::string {
+                    return table::string::decodeString(
+                        biosStringTable->findEntry(handle));
                 };
 
                 attributeType = "xyz.openbmc_project.BIOSConfig.Manager."
@@ -386,7 +410,7 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
                     options.push_back(
                         std::make_tuple("xyz.openbmc_project.BIOSConfig."
                                         "Manager.BoundType.OneOf",
-                                        getValue(pvHandls[i], *stringTable),
+                                        getValue(pvHandls[i]),
                                         valueDisplayNames[i]));
                 }
 
@@ -400,7 +424,7 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
                 // get current_value
                 for (size_t i = 0; i < handles.size(); i++)
                 {
-                    currentValue = getValue(pvHandls[handles[i]], *stringTable);
+                    currentValue = getValue(pvHandls[handles[i]]);
                 }
 
                 uint8_t defNum;
@@ -414,8 +438,7 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
                 // get default_value
                 for (size_t i = 0; i < defIndices.size(); i++)
                 {
-                    defaultValue = getValue(pvHandls[defIndices[i]],
-                                            *stringTable);
+                    defaultValue = getValue(pvHandls[defIndices[i]]);
                 }
 
                 break;
@@ -501,7 +524,38 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
     return PLDM_SUCCESS;
 }
 
-void BIOSConfig::updateBaseBIOSTableProperty()
+void BIOSConfig::updateBaseBIOSTableProperty(bool changed)
+{
+    if (baseBIOSTableMaps.empty())
+    {
+        return;
+    }
+
+    auto size = baseBIOSTableSize(baseBIOSTableMaps);
+    baseBIOSTableStats.requests++;
+    baseBIOSTableStats.bytesRequested += size;
+    if (!changed)
+    {
+        baseBIOSTableStats.unchanged++;
+        return;
+    }
+
+    if (!baseBIOSTableTimer)
+    {
+        baseBIOSTableTimer = std::make_unique<
+            sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>(
+            sdeventplus::Event::get_default(),
+            [this](auto&) { publishBaseBIOSTable(); });
+    }
+    // The window is not extended by later updates, which bounds the delay of
+    // the publication
+    if (!baseBIOSTableTimer->isEnabled())
+    {
+        baseBIOSTableTimer->restartOnce(baseBIOSTableUpdateWindow);
+    }
+}
+
+void BIOSConfig::publishBaseBIOSTable()
 {
     constexpr static auto biosConfigPath =
         "/xyz/openbmc_project/bios_config/manager";
@@ -530,7 +584,16 @@ void BIOSConfig::updateBaseBIOSTableProperty()
     {
         error("failed to update BaseBIOSTable property, ERROR={ERR_EXCEP}",
               "ERR_EXCEP", e.what());
+        return;
     }
+
+    baseBIOSTableStats.publications++;
+    baseBIOSTableStats.bytesPublished += baseBIOSTableSize(baseBIOSTableMaps);
+    info(
+        "Published BaseBIOSTable, {PUBLICATIONS} publications for {REQUESTS} updates, {BYTES_SAVED} bytes saved",
+        "PUBLICATIONS", baseBIOSTableStats.publications, "REQUESTS",
+        baseBIOSTableStats.requests, "BYTES_SAVED",
+        baseBIOSTableStats.bytesSaved());
 }
 
 void BIOSConfig::constructAttributes()
@@ -649,23 +712,97 @@ std::optional<Table> BIOSConfig::buildAndStoreStringTable()
     return table;
 }
 
-void BIOSConfig::storeTable(const fs::path& path, const Table& table)
+void BIOSConfig::storeTable(pldm_bios_table_types tableType,
+                            const Table& table)
+{
+    tables[tableType] = std::make_shared<const Table>(table);
+    buildIndexes(tableType);
+    dirtyTables.emplace(tableType);
+    if (!persistTablesEvent)
+    {
+        persistTablesEvent = std::make_unique<sdeventplus::source::Defer>(
+            sdeventplus::Event::get_default(),
+            std::bind(std::mem_fn(&BIOSConfig::_persistTables), this,
+                      std::placeholders::_1));
+    }
+}
+
+void BIOSConfig::buildIndexes(pldm_bios_table_types tableType)
 {
-    BIOSTable biosTable(path.c_str());
-    biosTable.store(table);
+    const auto& table = tables[tableType];
+    if (tableType == PLDM_BIOS_STRING_TABLE)
+    {
+        biosStringTable.emplace(*table);
+    }
+    else if (tableType == PLDM_BIOS_ATTR_TABLE)
+    {
+        attrEntryOffsets.clear();
+        attrHandles.clear();
+        using namespace pldm::bios::utils;
+        for (auto entry : BIOSTableIter<PLDM_BIOS_ATTR_TABLE>(table->data(),
+                                                              table->size()))
+        {
+            auto header = table::attribute::decodeHeader(entry);
+            auto offset = reinterpret_cast<const uint8_t*>(entry) -
+                          table->data();
+            // Keep the first entry, as the lookup in the table would
+            attrEntryOffsets.emplace(header.attrHandle, offset);
+            attrHandles.emplace(header.stringHandle, header.attrHandle);
+        }
+    }
 }
 
-std::optional<Table> BIOSConfig::loadTable(const fs::path& path)
+const pldm_bios_attr_table_entry*
+    BIOSConfig::findAttrEntry(uint16_t attrHandle) const
 {
-    BIOSTable biosTable(path.c_str());
-    if (biosTable.isEmpty())
+    const auto& attrTable = tables[PLDM_BIOS_ATTR_TABLE];
+    auto it = attrEntryOffsets.find(attrHandle);
+    if (!attrTable || it == attrEntryOffsets.end())
     {
-        return std::nullopt;
+        return nullptr;
     }
+    return reinterpret_cast<const pldm_bios_attr_table_entry*>(
+        attrTable->data() + it->second);
+}
 
-    Table table;
-    biosTable.load(table);
-    return table;
+BIOSAttribute* BIOSConfig::findBIOSAttribute(const std::string& attrName) const
+{
+    auto it = biosAttributeIndex.find(attrName);
+    if (it == biosAttributeIndex.end())
+    {
+        return nullptr;
+    }
+    return biosAttributes[it->second].get();
+}
+
+void BIOSConfig::persistTables()
+{
+    for (auto tableType : dirtyTables)
+    {
+        const auto& table = tables[tableType];
+        if (!table)
+        {
+            continue;
+        }
+
+        try
+        {
+            BIOSTable biosTable((tableDir / tableFiles[tableType]).c_str());
+            biosTable.store(*table);
+        }
+        catch (const std::exception& e)
+        {
+            error("Failed to persist BIOS table {TABLE_TYPE}: {ERROR}",
+                  "TABLE_TYPE", static_cast<unsigned>(tableType), "ERROR", e);
+        }
+    }
+    dirtyTables.clear();
+}
+
+void BIOSConfig::_persistTables(sdeventplus::source::EventBase& /*source */)
+{
+    persistTablesEvent.reset();
+    persistTables();
 }
 
 void BIOSConfig::load(const fs::path& filePath, ParseHandler handler)
@@ -713,13 +850,9 @@ std::string BIOSConfig::decodeStringFromStringEntry(
     return std::string(buffer.data(), buffer.data() + strLength);
 }
 
-std::string
-    BIOSConfig::displayStringHandle(uint16_t handle, uint8_t index,
-                                    const std::optional<Table>& attrTable,
-                                    const std::optional<Table>& stringTable)
+std::string BIOSConfig::displayStringHandle(uint16_t handle, uint8_t index)
 {
-    auto attrEntry = pldm_bios_table_attr_find_by_handle(
-        attrTable->data(), attrTable->size(), handle);
+    auto attrEntry = findAttrEntry(handle);
     uint8_t pvNum;
     int rc = pldm_bios_table_attr_entry_enum_decode_pv_num_check(attrEntry,
                                                                  &pvNum);
@@ -739,8 +872,7 @@ std::string
 
     std::string displayString = std::to_string(pvHandls[index]);
 
-    auto stringEntry = pldm_bios_table_string_find_by_handle(
-        stringTable->data(), stringTable->size(), pvHandls[index]);
+    auto stringEntry = biosStringTable->findEntry(pvHandls[index]);
 
     auto decodedStr = decodeStringFromStringEntry(stringEntry);
 
@@ -751,15 +883,11 @@ void BIOSConfig::traceBIOSUpdate(
     const pldm_bios_attr_val_table_entry* attrValueEntry,
     const pldm_bios_attr_table_entry* attrEntry, bool isBMC)
 {
-    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
-    auto attrTable = getBIOSTable(PLDM_BIOS_ATTR_TABLE);
-
     auto [attrHandle,
           attrType] = table::attribute_value::decodeHeader(attrValueEntry);
 
     auto attrHeader = table::attribute::decodeHeader(attrEntry);
-    BIOSStringTable biosStringTable(*stringTable);
-    auto attrName = biosStringTable.findString(attrHeader.stringHandle);
+    auto attrName = biosStringTable->findString(attrHeader.stringHandle);
 
     switch (attrType)
     {
@@ -774,8 +902,7 @@ void BIOSConfig::traceBIOSUpdate(
 
             for (uint8_t handle : handles)
             {
-                auto nwVal = displayStringHandle(attrHandle, handle, attrTable,
-                                                 stringTable);
+                auto nwVal = displayStringHandle(attrHandle, handle);
                 auto chkBMC = isBMC ? "true" : "false";
                 info(
                     "BIOS: {ATTR_NAME}, updated to value: {NEW_VAL}, by BMC: {CHK_BMC} ",
@@ -812,7 +939,7 @@ void BIOSConfig::traceBIOSUpdate(
 
 int BIOSConfig::checkAttrValueToUpdate(
     const pldm_bios_attr_val_table_entry* attrValueEntry,
-    const pldm_bios_attr_table_entry* attrEntry, Table&)
+    const pldm_bios_attr_table_entry* attrEntry, const Table&)
 
 {
     auto [attrHandle,
@@ -881,75 +1008,133 @@ int BIOSConfig::checkAttrValueToUpdate(
 int BIOSConfig::setAttrValue(const void* entry, size_t size, bool isBMC,
                              bool updateDBus, bool updateBaseBIOSTable)
 {
-    auto attrValueTable = getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
-    auto attrTable = getBIOSTable(PLDM_BIOS_ATTR_TABLE);
-    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
+    auto begin = static_cast<const uint8_t*>(entry);
+    return setAttrValues({Table(begin, begin + size)}, isBMC, updateDBus,
+                         updateBaseBIOSTable);
+}
+
+int BIOSConfig::setAttrValues(const std::vector<Table>& entries, bool isBMC,
+                              bool updateDBus, bool updateBaseBIOSTable)
+{
+    const auto& attrValueTable = tables[PLDM_BIOS_ATTR_VAL_TABLE];
+    const auto& attrTable = tables[PLDM_BIOS_ATTR_TABLE];
+    const auto& stringTable = tables[PLDM_BIOS_STRING_TABLE];
     if (!attrValueTable || !attrTable || !stringTable)
     {
         return PLDM_BIOS_TABLE_UNAVAILABLE;
     }
 
-    auto attrValueEntry =
-        reinterpret_cast<const pldm_bios_attr_val_table_entry*>(entry);
+    int rc = PLDM_SUCCESS;
+    std::map<uint16_t, Table> updates{};
+    for (const auto& entry : entries)
+    {
+        auto attrValueEntry =
+            reinterpret_cast<const pldm_bios_attr_val_table_entry*>(
+                entry.data());
+        auto attrValHeader =
+            table::attribute_value::decodeHeader(attrValueEntry);
+
+        auto attrEntry = findAttrEntry(attrValHeader.attrHandle);
+        if (!attrEntry)
+        {
+            rc = rc == PLDM_SUCCESS ? PLDM_ERROR : rc;
+            continue;
+        }
 
-    auto attrValHeader = table::attribute_value::decodeHeader(attrValueEntry);
+        auto checkRc = checkAttrValueToUpdate(attrValueEntry, attrEntry,
+                                              *stringTable);
+        if (checkRc != PLDM_SUCCESS)
+        {
+            rc = rc == PLDM_SUCCESS ? checkRc : rc;
+            continue;
+        }
 
-    auto attrEntry = table::attribute::findByHandle(*attrTable,
-                                                    attrValHeader.attrHandle);
-    if (!attrEntry)
-    {
-        return PLDM_ERROR;
+        updates.insert_or_assign(attrValHeader.attrHandle, entry);
     }
 
-    auto rc = checkAttrValueToUpdate(attrValueEntry, attrEntry, *stringTable);
-    if (rc != PLDM_SUCCESS)
+    if (updates.empty())
     {
         return rc;
     }
 
-    auto destTable = table::attribute_value::updateTable(*attrValueTable, entry,
-                                                         size);
-
+    auto destTable = table::attribute_value::updateTable(*attrValueTable,
+                                                         updates);
     if (!destTable)
     {
         return PLDM_ERROR;
     }
 
-    try
+    bool dropped = false;
+    for (auto it = updates.begin(); it != updates.end();)
     {
-        auto attrHeader = table::attribute::decodeHeader(attrEntry);
-
-        BIOSStringTable biosStringTable(*stringTable);
-        auto attrName = biosStringTable.findString(attrHeader.stringHandle);
-        auto iter = std::find_if(
-            biosAttributes.begin(), biosAttributes.end(),
-            [&attrName](const auto& attr) { return attr->name == attrName; });
-
-        if (iter == biosAttributes.end())
+        auto attrValueEntry =
+            reinterpret_cast<const pldm_bios_attr_val_table_entry*>(
+                it->second.data());
+        auto attrEntry = findAttrEntry(it->first);
+        try
         {
-            return PLDM_ERROR;
+            auto attrHeader = table::attribute::decodeHeader(attrEntry);
+
+            auto attrName =
+                biosStringTable->findString(attrHeader.stringHandle);
+            auto attribute = findBIOSAttribute(attrName);
+            if (attribute == nullptr)
+            {
+                throw std::invalid_argument("Unknown attribute " + attrName);
+            }
+            if (updateDBus)
+            {
+                attribute->setAttrValueOnDbus(attrValueEntry, attrEntry,
+                                              *biosStringTable);
+            }
+            ++it;
         }
-        if (updateDBus)
+        catch (const std::exception& e)
         {
-            (*iter)->setAttrValueOnDbus(attrValueEntry, attrEntry,
-                                        biosStringTable);
+            error("Set attribute value error: {ERR_EXCEP}", "ERR_EXCEP",
+                  e.what());
+            rc = rc == PLDM_SUCCESS ? PLDM_ERROR : rc;
+            it = updates.erase(it);
+            dropped = true;
         }
     }
-    catch (const std::exception& e)
+
+    if (updates.empty())
     {
-        error("Set attribute value error: {ERR_EXCEP}", "ERR_EXCEP", e.what());
-        return PLDM_ERROR;
+        return rc;
+    }
+    if (dropped)
+    {
+        // Leave the old values of the dropped entries in the table
+        destTable = table::attribute_value::updateTable(*attrValueTable,
+                                                        updates);
+        if (!destTable)
+        {
+            return PLDM_ERROR;
+        }
     }
 
     setBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE, *destTable, updateBaseBIOSTable);
 
-    traceBIOSUpdate(attrValueEntry, attrEntry, isBMC);
+    for (const auto& [attrHandle, entry] : updates)
+    {
+        traceBIOSUpdate(
+            reinterpret_cast<const pldm_bios_attr_val_table_entry*>(
+                entry.data()),
+            findAttrEntry(attrHandle), isBMC);
+    }
 
-    return PLDM_SUCCESS;
+    return rc;
 }
 
 void BIOSConfig::removeTables()
 {
+    tables = {};
+    biosStringTable.reset();
+    attrEntryOffsets.clear();
+    attrHandles.clear();
+    dirtyTables.clear();
+    persistTablesEvent.reset();
     try
     {
         fs::remove(tableDir / stringTableFile);
@@ -976,17 +1161,15 @@ void BIOSConfig::processBiosAttrChangeNotification(
     }
 
     PropertyValue newPropVal = it->second;
-    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
-    if (!stringTable.has_value())
+    if (!biosStringTable)
     {
         error("BIOS string table unavailable");
         return;
     }
-    BIOSStringTable biosStringTable(*stringTable);
     uint16_t attrNameHdl{};
     try
     {
-        attrNameHdl = biosStringTable.findHandle(attrName);
+        attrNameHdl = biosStringTable->findHandle(attrName);
     }
     catch (const std::invalid_argument& e)
     {
@@ -995,14 +1178,16 @@ void BIOSConfig::processBiosAttrChangeNotification(
         return;
     }
 
-    auto attrTable = getBIOSTable(PLDM_BIOS_ATTR_TABLE);
-    if (!attrTable.has_value())
+    const auto& attrTable = tables[PLDM_BIOS_ATTR_TABLE];
+    if (!attrTable)
     {
         error("Attribute table not present");
         return;
     }
+    auto attrHandle = attrHandles.find(attrNameHdl);
     const struct pldm_bios_attr_table_entry* tableEntry =
-        table::attribute::findByStringHandle(*attrTable, attrNameHdl);
+        attrHandle == attrHandles.end() ? nullptr
+                                        : findAttrEntry(attrHandle->second);
     if (tableEntry == nullptr)
     {
         error(
@@ -1014,9 +1199,9 @@ void BIOSConfig::processBiosAttrChangeNotification(
     auto [attrHdl, attrType,
           stringHdl] = table::attribute::decodeHeader(tableEntry);
 
-    auto attrValueSrcTable = getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+    const auto& attrValueSrcTable = tables[PLDM_BIOS_ATTR_VAL_TABLE];
 
-    if (!attrValueSrcTable.has_value())
+    if (!attrValueSrcTable)
     {
         error("Attribute value table not present");
         return;
@@ -1036,7 +1221,7 @@ void BIOSConfig::processBiosAttrChangeNotification(
         *attrValueSrcTable, newValue.data(), newValue.size());
     if (destTable.has_value())
     {
-        storeTable(tableDir / attrValueTableFile, *destTable);
+        storeTable(PLDM_BIOS_ATTR_VAL_TABLE, *destTable);
     }
 
     rc = setAttrValue(newValue.data(), newValue.size(), true, false);
@@ -1049,22 +1234,16 @@ void BIOSConfig::processBiosAttrChangeNotification(
 
 uint16_t BIOSConfig::findAttrHandle(const std::string& attrName)
 {
-    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
-    auto attrTable = getBIOSTable(PLDM_BIOS_ATTR_TABLE);
-
-    BIOSStringTable biosStringTable(*stringTable);
-    pldm::bios::utils::BIOSTableIter<PLDM_BIOS_ATTR_TABLE> attrTableIter(
-        attrTable->data(), attrTable->size());
-    auto stringHandle = biosStringTable.findHandle(attrName);
+    if (!biosStringTable)
+    {
+        throw std::invalid_argument("BIOS string table unavailable");
+    }
 
-    for (auto entry : pldm::bios::utils::BIOSTableIter<PLDM_BIOS_ATTR_TABLE>(
-             attrTable->data(), attrTable->size()))
+    auto stringHandle = biosStringTable->findHandle(attrName);
+    auto it = attrHandles.find(stringHandle);
+    if (it != attrHandles.end())
     {
-        auto header = table::attribute::decodeHeader(entry);
-        if (header.stringHandle == stringHandle)
-        {
-            return header.attrHandle;
-        }
+        return it->second;
     }
 
     throw std::invalid_argument("Unknow attribute Name");
@@ -1074,18 +1253,15 @@ void BIOSConfig::constructPendingAttribute(
     const PendingAttributes& pendingAttributes)
 {
     std::vector<uint16_t> listOfHandles{};
+    std::vector<Table> attrValueEntries{};
 
     for (auto& attribute : pendingAttributes)
     {
         std::string attributeName = attribute.first;
         auto& [attributeType, attributevalue] = attribute.second;
 
-        auto iter = std::find_if(biosAttributes.begin(), biosAttributes.end(),
-                                 [&attributeName](const auto& attr) {
-            return attr->name == attributeName;
-        });
-
-        if (iter == biosAttributes.end())
+        auto biosAttribute = findBIOSAttribute(attributeName);
+        if (biosAttribute == nullptr)
         {
             error("Wrong attribute name, attributeName = {ATTR_NAME}",
                   "ATTR_NAME", attributeName);
@@ -1121,9 +1297,21 @@ void BIOSConfig::constructPendingAttribute(
             listOfHandles.emplace_back(htole16(handler));
         }
 
-        (*iter)->generateAttributeEntry(attributevalue, attrValueEntry);
+        biosAttribute->generateAttributeEntry(attributevalue, attrValueEntry);
+        attrValueEntries.emplace_back(std::move(attrValueEntry));
+    }
 
-        setAttrValue(attrValueEntry.data(), attrValueEntry.size(), true);
+    // Apply all the pending attributes in a single update of the attribute
+    // value table
+    if (!attrValueEntries.empty())
+    {
+        auto rc = setAttrValues(attrValueEntries, true);
+        if (rc != PLDM_SUCCESS)
+        {
+            error(
+                "Failed to apply some of the pending BIOS attributes, response code '{RC}'",
+                "RC", rc);
+        }
     }
 
     if (listOfHandles.size())
@@ -11,13 +11,18 @@
 
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
 
+#include <array>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 PHOSPHOR_LOG2_USING;
@@ -60,6 +65,28 @@ using PendingObj = std::tuple<AttributeType, CurrentValue>;
 using PendingAttributes = std::map<AttributeName, PendingObj>;
 using Callback = std::function<void()>;
 
+/** @struct BaseBIOSTableStats
+ *
+ *  Counters of the updates of the BaseBIOSTable property. The sizes are the
+ *  approximate size of the property on the bus.
+ */
+struct BaseBIOSTableStats
+{
+    uint64_t requests = 0;  //!< updates of the attribute value table
+    uint64_t unchanged = 0; //!< updates which left the property unchanged
+    uint64_t publications = 0;
+    uint64_t bytesRequested = 0; //!< had each update been published
+    uint64_t bytesPublished = 0;
+
+    /** @brief Bytes not sent over the bus thanks to coalescing the updates
+     *         and skipping the unchanged ones
+     */
+    uint64_t bytesSaved() const
+    {
+        return bytesRequested - bytesPublished;
+    }
+};
+
 /** @class BIOSConfig
  *  @brief Manager BIOS Attributes
  */
@@ -71,7 +98,7 @@ class BIOSConfig
     BIOSConfig(BIOSConfig&&) = delete;
     BIOSConfig& operator=(const BIOSConfig&) = delete;
     BIOSConfig& operator=(BIOSConfig&&) = delete;
-    ~BIOSConfig() = default;
+    ~BIOSConfig();
 
     /** @brief Construct BIOSConfig
      *  @param[in] jsonDir - The directory where json file exists
@@ -106,18 +133,44 @@ class BIOSConfig
     int setAttrValue(const void* entry, size_t size, bool isBMC,
                      bool updateDBus = true, bool updateBaseBIOSTable = true);
 
-    /** @brief Remove the persistent tables */
+    /** @brief Set the values of several attributes on dbus and in the
+     *         attribute value table. The entries which are valid are applied
+     *         in a single update of the attribute value table, which is then
+     *         persisted and published on D-Bus once.
+     *  @param[in] entries - attribute value entries
+     *  @param[in] isBMC - indicates if the attributes are set by BMC
+     *  @param[in] updateDBus          - update Attr value D-Bus property
+     *                                   if this is set to true
+     *  @param[in] updateBaseBIOSTable - update BaseBIOSTable D-Bus property
+     *                                   if this is set to true
+     *  @return pldm_completion_codes, the error of the first entry which
+     *          could not be applied
+     */
+    int setAttrValues(const std::vector<Table>& entries, bool isBMC,
+                      bool updateDBus = true, bool updateBaseBIOSTable = true);
+
+    /** @brief Remove the tables and the persistent tables */
     void removeTables();
 
     /** @brief Build bios tables(string,attribute,attribute value table)*/
     void buildTables();
 
-    /** @brief Get BIOS table of specified type
+    /** @brief Get BIOS table of specified type, from memory
      *  @param[in] tableType - The table type
      *  @return The bios table, std::nullopt if the table is unaviliable
      */
     std::optional<Table> getBIOSTable(pldm_bios_table_types tableType);
 
+    /** @brief Get BIOS table of specified type without copying it. The table
+     *         is immutable, a later update of the table replaces it instead
+     *         of modifying it, so the caller can keep serving a consistent
+     *         version of the table across a multipart transfer.
+     *  @param[in] tableType - The table type
+     *  @return The bios table, nullptr if the table is unavailable
+     */
+    std::shared_ptr<const Table>
+        getSharedBIOSTable(pldm_bios_table_types tableType) const;
+
     /** @brief set BIOS table
      *  @param[in] tableType - Indicates what table is being transferred
      *             {BIOSStringTable=0x0, BIOSAttributeTable=0x1,
@@ -130,6 +183,14 @@ class BIOSConfig
     int setBIOSTable(uint8_t tableType, const Table& table,
                      bool updateBaseBIOSTable = true);
 
+    /** @brief Get the counters of the updates of the BaseBIOSTable property
+     *  @return The counters
+     */
+    const BaseBIOSTableStats& getBaseBIOSTableStats() const
+    {
+        return baseBIOSTableStats;
+    }
+
     /** @brief Construct the BIOS Attributes and build the tables
      *         after receiving system type from entity manager.
      *         Also register the Service Name only if
@@ -160,6 +221,43 @@ class BIOSConfig
     pldm::utils::DBusHandler* const dbusHandler;
     BaseBIOSTable baseBIOSTableMaps;
 
+    /** @brief The string, attribute and attribute value tables, indexed by
+     *         pldm_bios_table_types. These are the source of truth, the
+     *         persistent tables are written behind them. A table is never
+     *         modified in place, storing a table replaces it.
+     */
+    std::array<std::shared_ptr<const Table>, PLDM_BIOS_ATTR_VAL_TABLE + 1>
+        tables;
+
+    /** @brief Timer coalescing the updates of the BaseBIOSTable property */
+    std::unique_ptr<
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
+        baseBIOSTableTimer;
+
+    /** @brief Counters of the updates of the BaseBIOSTable property */
+    BaseBIOSTableStats baseBIOSTableStats;
+
+    /** @brief Tables modified since they were last persisted */
+    std::set<pldm_bios_table_types> dirtyTables;
+
+    /** @brief sdeventplus event source to persist the modified tables */
+    std::unique_ptr<sdeventplus::source::Defer> persistTablesEvent;
+
+    /** @brief Indexed string table, rebuilt whenever the string table is
+     *         stored
+     */
+    std::optional<BIOSStringTable> biosStringTable;
+
+    /** @brief Maps an attribute handle to the offset of its entry in the
+     *         attribute table, rebuilt whenever the attribute table is stored
+     */
+    std::unordered_map<uint16_t, size_t> attrEntryOffsets;
+
+    /** @brief Maps the string handle of an attribute name to the attribute
+     *         handle, rebuilt whenever the attribute table is stored
+     */
+    std::unordered_map<uint16_t, uint16_t> attrHandles;
+
     /** @brief socket descriptor to communicate to host */
     int fd;
 
@@ -184,6 +282,9 @@ class BIOSConfig
     using BIOSAttributes = std::vector<std::unique_ptr<BIOSAttribute>>;
     BIOSAttributes biosAttributes;
 
+    /** @brief Maps an attribute name to its index in biosAttributes */
+    std::unordered_map<std::string, size_t> biosAttributeIndex;
+
     using propName = std::string;
     using DbusChObjProperties = std::map<propName, pldm::utils::PropertyValue>;
 
@@ -224,6 +325,8 @@ class BIOSConfig
         {
             biosAttributes.push_back(std::make_unique<T>(entry, dbusHandler));
             auto biosAttrIndex = biosAttributes.size() - 1;
+            biosAttributeIndex.emplace(biosAttributes[biosAttrIndex]->name,
+                                       biosAttrIndex);
             auto dBusMap = biosAttributes[biosAttrIndex]->getDBusMap();
 
             if (dBusMap.has_value())
@@ -291,17 +394,39 @@ class BIOSConfig
      */
     void buildAndStoreAttrTables(const Table& stringTable);
 
-    /** @brief Persist the table
-     *  @param[in] path - Path to persist the table
+    /** @brief Update the table in memory and schedule persisting it, the
+     *         updates made in the same event loop iteration are persisted
+     *         together
+     *  @param[in] tableType - The table type
      *  @param[in] table - The table
      */
-    void storeTable(const fs::path& path, const Table& table);
+    void storeTable(pldm_bios_table_types tableType, const Table& table);
 
-    /** @brief Load bios table to ram
-     *  @param[in] path - Path of the table
-     *  @return The table, std::nullopt if loading fails
+    /** @brief Persist the tables modified since they were last persisted
      */
-    std::optional<Table> loadTable(const fs::path& path);
+    void persistTables();
+
+    /** @brief Rebuild the indexes of a table after it is stored
+     *  @param[in] tableType - The table type
+     */
+    void buildIndexes(pldm_bios_table_types tableType);
+
+    /** @brief Find attribute entry by handle in the attribute table
+     *  @param[in] attrHandle - attribute handle
+     *  @return Pointer to the attribute table entry, nullptr if not found
+     */
+    const pldm_bios_attr_table_entry* findAttrEntry(uint16_t attrHandle) const;
+
+    /** @brief Find the attribute by name
+     *  @param[in] attrName - attribute name
+     *  @return Pointer to the attribute, nullptr if not found
+     */
+    BIOSAttribute* findBIOSAttribute(const std::string& attrName) const;
+
+    /** @brief Callback of the event source persisting the tables
+     *  @param[in] source - sdeventplus event source
+     */
+    void _persistTables(sdeventplus::source::EventBase& source);
 
     /** @brief Method to decode the attribute name from the string handle
      *
@@ -316,14 +441,10 @@ class BIOSConfig
      *
      *  @param[in] handle - the Attribute handle of the bios attribute
      *  @param[in] index - index to the possible value handles
-     *  @param[in] attrTable - the attribute table
-     *  @param[in] stringTable - the string table
      *  @return string handle from the string table and decoded string to the
      * name handle
      */
-    std::string displayStringHandle(uint16_t handle, uint8_t index,
-                                    const std::optional<Table>& attrTable,
-                                    const std::optional<Table>& stringTable);
+    std::string displayStringHandle(uint16_t handle, uint8_t index);
 
     /** @brief Method to trace the bios attribute which got changed
      *
@@ -343,7 +464,7 @@ class BIOSConfig
      */
     int checkAttrValueToUpdate(
         const pldm_bios_attr_val_table_entry* attrValueEntry,
-        const pldm_bios_attr_table_entry* attrEntry, Table& stringTable);
+        const pldm_bios_attr_table_entry* attrEntry, const Table& stringTable);
 
     /** @brief Check the attribute table
      *  @param[in] table - The table
@@ -357,9 +478,17 @@ class BIOSConfig
      */
     int checkAttributeValueTable(const Table& table);
 
-    /** @brief Update the BaseBIOSTable property of the D-Bus interface
+    /** @brief Schedule an update of the BaseBIOSTable property of the D-Bus
+     *         interface, the updates within baseBIOSTableUpdateWindow are
+     *         coalesced into a single publication
+     *  @param[in] changed - false if the update left BaseBIOSTable unchanged,
+     *                       in which case nothing is published
+     */
+    void updateBaseBIOSTableProperty(bool changed = true);
+
+    /** @brief Set the BaseBIOSTable property of the D-Bus interface
      */
-    void updateBaseBIOSTableProperty();
+    void publishBaseBIOSTable();
 
     /** @brief Listen the PendingAttributes property of the D-Bus interface and
      *         update BaseBIOSTable
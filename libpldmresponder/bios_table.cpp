@@ -1,5 +1,7 @@
 #include "bios_table.hpp"
 
+#include "common/bios_utils.hpp"
+
 #include <libpldm/base.h>
 #include <libpldm/bios_table.h>
 #include <libpldm/utils.h>
@@ -32,8 +34,19 @@ bool BIOSTable::isEmpty() const noexcept
 
 void BIOSTable::store(const Table& table)
 {
-    std::ofstream stream(filePath.string(), std::ios::out | std::ios::binary);
+    // Write to a temporary file and rename it in place, so that a crash never
+    // leaves a partially written table behind
+    auto tmpPath = filePath;
+    tmpPath += ".tmp";
+    std::ofstream stream(tmpPath.string(), std::ios::out | std::ios::binary |
+                                               std::ios::trunc);
     stream.write(reinterpret_cast<const char*>(table.data()), table.size());
+    stream.close();
+    if (!stream)
+    {
+        throw std::runtime_error("Failed to write BIOS table");
+    }
+    fs::rename(tmpPath, filePath);
 }
 
 void BIOSTable::load(Response& response) const
@@ -47,17 +60,50 @@ void BIOSTable::load(Response& response) const
 
 BIOSStringTable::BIOSStringTable(const Table& stringTable) :
     stringTable(stringTable)
-{}
+{
+    buildIndex();
+}
 
 BIOSStringTable::BIOSStringTable(const BIOSTable& biosTable)
 {
     biosTable.load(stringTable);
+    buildIndex();
+}
+
+void BIOSStringTable::buildIndex()
+{
+    if (stringTable.empty())
+    {
+        return;
+    }
+
+    for (auto entry : pldm::bios::utils::BIOSTableIter<PLDM_BIOS_STRING_TABLE>(
+             stringTable.data(), stringTable.size()))
+    {
+        auto handle = table::string::decodeHandle(entry);
+        auto offset = reinterpret_cast<const uint8_t*>(entry) -
+                      stringTable.data();
+        // Keep the first entry, as the lookup in the table would
+        entryOffsets.emplace(handle, offset);
+        handles.emplace(table::string::decodeString(entry), handle);
+    }
+}
+
+const pldm_bios_string_table_entry*
+    BIOSStringTable::findEntry(uint16_t handle) const
+{
+    auto it = entryOffsets.find(handle);
+    if (it == entryOffsets.end())
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const pldm_bios_string_table_entry*>(
+        stringTable.data() + it->second);
 }
 
 std::string BIOSStringTable::findString(uint16_t handle) const
 {
-    auto stringEntry = pldm_bios_table_string_find_by_handle(
-        stringTable.data(), stringTable.size(), handle);
+    auto stringEntry = findEntry(handle);
     if (stringEntry == nullptr)
     {
         throw std::invalid_argument("Invalid String Handle");
@@ -67,14 +113,13 @@ std::string BIOSStringTable::findString(uint16_t handle) const
 
 uint16_t BIOSStringTable::findHandle(const std::string& name) const
 {
-    auto stringEntry = pldm_bios_table_string_find_by_string(
-        stringTable.data(), stringTable.size(), name.c_str());
-    if (stringEntry == nullptr)
+    auto it = handles.find(name);
+    if (it == handles.end())
     {
         throw std::invalid_argument("Invalid String Name");
     }
 
-    return table::string::decodeHandle(stringEntry);
+    return it->second;
 }
 
 namespace table
@@ -391,6 +436,40 @@ std::optional<Table> updateTable(const Table& table, const void* entry,
     return destTable;
 }
 
+std::optional<Table> updateTable(const Table& table,
+                                 const std::map<uint16_t, Table>& entries)
+{
+    Table destTable;
+    destTable.reserve(table.size());
+    size_t updated = 0;
+    using namespace pldm::bios::utils;
+    for (auto entry : BIOSTableIter<PLDM_BIOS_ATTR_VAL_TABLE>(table.data(),
+                                                              table.size()))
+    {
+        auto header = decodeHeader(entry);
+        auto it = entries.find(header.attrHandle);
+        if (it != entries.end())
+        {
+            destTable.insert(destTable.end(), it->second.begin(),
+                             it->second.end());
+            updated++;
+            continue;
+        }
+
+        auto begin = reinterpret_cast<const uint8_t*>(entry);
+        auto length = pldm_bios_table_attr_value_entry_length(entry);
+        destTable.insert(destTable.end(), begin, begin + length);
+    }
+
+    if (updated != entries.size())
+    {
+        return std::nullopt;
+    }
+
+    appendPadAndChecksum(destTable);
+    return destTable;
+}
+
 } // namespace attribute_value
 
 } // namespace table
@@ -5,8 +5,10 @@
 #include <stdint.h>
 
 #include <filesystem>
+#include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace pldm
@@ -58,6 +60,8 @@ class BIOSTable
     /** @brief Persist a BIOS table(string/attribute/attribute value)
      *
      *  @param[in] table - BIOS table
+     *
+     *  @throw std::exception if the table could not be written
      */
     void store(const Table& table);
 
@@ -97,7 +101,9 @@ class BIOSStringTableInterface
 };
 
 /** @class BIOSStringTable
- *  @brief Collection of BIOS string table operations.
+ *  @brief Collection of BIOS string table operations. The string handles and
+ *         names are indexed on construction, so the lookups do not walk the
+ *         table.
  */
 class BIOSStringTable : public BIOSStringTableInterface
 {
@@ -130,8 +136,23 @@ class BIOSStringTable : public BIOSStringTableInterface
      */
     uint16_t findHandle(const std::string& name) const override;
 
+    /** @brief Find the string table entry for a string handle
+     *  @param[in] handle - string handle
+     *  @return Pointer to the string table entry, nullptr if not found
+     */
+    const pldm_bios_string_table_entry* findEntry(uint16_t handle) const;
+
   private:
+    /** @brief Index the entries of the string table */
+    void buildIndex();
+
     Table stringTable;
+
+    /** @brief Maps a string handle to the offset of its entry in the table */
+    std::unordered_map<uint16_t, size_t> entryOffsets;
+
+    /** @brief Maps a string to its handle */
+    std::unordered_map<std::string, uint16_t> handles;
 };
 
 namespace table
@@ -369,6 +390,17 @@ const pldm_bios_attr_val_table_entry*
 std::optional<Table> updateTable(const Table& table, const void* entry,
                                  size_t size);
 
+/** @brief construct a table with several new entries, in a single pass over
+ *         the table
+ *  @param[in] table - the table need to be updated
+ *  @param[in] entries - the new attribute value entries, keyed by attribute
+ *                       handle
+ *  @return newly constructed table, std::nullopt if an attribute handle is
+ *          not in the table
+ */
+std::optional<Table> updateTable(const Table& table,
+                                 const std::map<uint16_t, Table>& entries);
+
 } // namespace attribute_value
 
 } // namespace table
@@ -2,13 +2,15 @@
 
 #include "common/utils.hpp"
 
+#include <endian.h>
 #include <libpldm/entity.h>
-#include <libpldm/utils.h>
 #include <systemd/sd-journal.h>
 
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/bus.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <optional>
 #include <set>
 #include <stack>
@@ -144,68 +146,95 @@ void FruImpl::buildFRUTable()
         return;
     }
 
-    fru_parser::DBusLookupInfo dbusInfo;
+    // Complete a build started by startFRUTableBuild() in one go
+    if (!nextObject && !startFRUTableBuild())
+    {
+        return;
+    }
+
+    buildFRUTableSlice(objects.size());
+}
+
+bool FruImpl::startFRUTableBuild()
+{
+    if (isBuilt || nextObject)
+    {
+        return !isBuilt;
+    }
 
+    dbus::ObjectValueTree inventory;
     try
     {
-        dbusInfo = parser.inventoryLookup();
-        objects = pldm::utils::DBusHandler::getInventoryObjects<
+        // Subscribe before looking up the inventory so that no change is lost
+        watchInventory();
+        inventory = pldm::utils::DBusHandler::getInventoryObjects<
             pldm::utils::DBusHandler>();
     }
     catch (const std::exception& e)
     {
         error("Failed building FRU table due to inventory lookup: {ERROR}",
               "ERROR", e);
-        return;
+        return false;
     }
 
-    auto itemIntfsLookup = std::get<2>(dbusInfo);
+    startFRUTableBuild(std::move(inventory));
+    return true;
+}
 
-    for (const auto& object : objects)
+void FruImpl::startFRUTableBuild(dbus::ObjectValueTree&& inventory)
+{
+    itemIntfsLookup = std::get<2>(parser.inventoryLookup());
+    fruIntfs = itemIntfsLookup;
+    fruIntfs.emplace("xyz.openbmc_project.Inventory.Item");
+    for (const auto& itemIntf : itemIntfsLookup)
     {
-        const auto& interfaces = object.second;
-        for (const auto& interface : interfaces)
+        try
         {
-            if (itemIntfsLookup.contains(interface.first))
+            for (const auto& [recType, encType, fieldInfos] :
+                 parser.getRecordInfo(itemIntf))
             {
-                // checking fru present property is available or not.
-                if (!pldm::utils::checkForFruPresence(object.first.str))
+                for (const auto& fieldInfo : fieldInfos)
                 {
-                    continue;
+                    fruIntfs.emplace(std::get<0>(fieldInfo));
                 }
+            }
+        }
+        catch (const std::out_of_range&)
+        {
+            // The item has no FRU records
+        }
+    }
 
-                // An exception will be thrown by getRecordInfo, if the item
-                // D-Bus interface name specified in FRU_Master.json does
-                // not have corresponding config jsons
-                try
-                {
-                    updateAssociationTree(objects, object.first.str);
-                    pldm_entity entity{};
-                    if (objToEntityNode.contains(object.first.str))
-                    {
-                        pldm_entity_node* node =
-                            objToEntityNode.at(object.first.str);
-
-                        entity = pldm_entity_extract(node);
-                    }
+    objects = std::move(inventory);
+    nextObject = objects.cbegin();
+}
 
-                    auto recordInfos = parser.getRecordInfo(interface.first);
-                    populateRecords(interfaces, recordInfos, entity);
+bool FruImpl::buildFRUTableSlice(size_t maxObjects)
+{
+    if (isBuilt || !nextObject)
+    {
+        return true;
+    }
 
-                    associatedEntityMap.emplace(object.first, entity);
-                    break;
-                }
-                catch (const std::exception& e)
-                {
-                    error(
-                        "Config JSONs missing for the item interface type, interface = {INTF}",
-                        "INTF", interface.first);
-                    break;
-                }
-            }
+    auto& it = *nextObject;
+    for (size_t count = 0; it != objects.cend() && count < maxObjects;
+         ++it, ++count)
+    {
+        const auto& object = *it;
+        auto recordSet = buildRecordSet(object.first.str, object.second, {});
+        if (recordSet)
+        {
+            associatedEntityMap.emplace(object.first, recordSet->entity);
+            insertRecordSet(object.first.str, std::move(*recordSet));
         }
     }
 
+    if (it != objects.cend())
+    {
+        return false;
+    }
+    nextObject.reset();
+
     int rc = pldm_entity_association_pdr_add_check(entityTree, pdrRepo, false,
                                                    TERMINUS_HANDLE);
     if (rc < 0)
@@ -220,13 +249,441 @@ void FruImpl::buildFRUTable()
     pldm_entity_association_tree_copy_root(entityTree, bmcEntityTree);
 
     isBuilt = true;
+
+    // Catch up with the inventory objects which changed during the build
+    auto changedPaths = std::move(pendingUpdates);
+    for (const auto& path : changedPaths)
+    {
+        updateFRU(path);
+    }
+    refreshTableImage();
+    return true;
+}
+
+std::optional<FruRecordSet>
+    FruImpl::buildRecordSet(const std::string& path,
+                            const dbus::InterfaceMap& interfaces,
+                            FruRecordSet recordSet)
+{
+    for (const auto& interface : interfaces)
+    {
+        if (!itemIntfsLookup.contains(interface.first))
+        {
+            continue;
+        }
+
+        // checking fru present property is available or not.
+        if (!pldm::utils::checkForFruPresence(path, interfaces))
+        {
+            continue;
+        }
+
+        // An exception will be thrown by getRecordInfo, if the item
+        // D-Bus interface name specified in FRU_Master.json does
+        // not have corresponding config jsons
+        try
+        {
+            if (!recordSet.rsi)
+            {
+                updateAssociationTree(objects, path);
+                if (objToEntityNode.contains(path))
+                {
+                    recordSet.entity =
+                        pldm_entity_extract(objToEntityNode.at(path));
+                }
+            }
+
+            auto recordInfos = parser.getRecordInfo(interface.first);
+            recordSet.numRecords = 0;
+            recordSet.records.clear();
+            recordSet.recordOffsets.clear();
+            populateRecords(interfaces, recordInfos, recordSet);
+            return recordSet;
+        }
+        catch (const std::exception& e)
+        {
+            error(
+                "Config JSONs missing for the item interface type, interface = {INTF}",
+                "INTF", interface.first);
+            return std::nullopt;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void FruImpl::insertRecordSet(const std::string& path,
+                              FruRecordSet&& recordSet)
+{
+    // A FRU without records has no record set
+    if (!recordSet.rsi)
+    {
+        return;
+    }
+
+    recordSetPaths.insert_or_assign(recordSet.rsi, path);
+    auto it = recordSets.insert_or_assign(path, std::move(recordSet)).first;
+    size_t offset = 0;
+    if (std::next(it) == recordSets.end())
+    {
+        offset = table.size();
+    }
+    else
+    {
+        for (auto prev = recordSets.begin(); prev != it; ++prev)
+        {
+            offset += prev->second.records.size();
+        }
+    }
+
+    const auto& records = it->second.records;
+    table.insert(table.begin() + offset, records.begin(), records.end());
+    numRecs += it->second.numRecords;
+}
+
+void FruImpl::eraseRecordSet(const std::string& path)
+{
+    auto it = recordSets.find(path);
+    if (it == recordSets.end())
+    {
+        return;
+    }
+
+    size_t offset = 0;
+    for (auto prev = recordSets.begin(); prev != it; ++prev)
+    {
+        offset += prev->second.records.size();
+    }
+
+    auto size = it->second.records.size();
+    table.erase(table.begin() + offset, table.begin() + offset + size);
+    numRecs -= it->second.numRecords;
+    recordSetPaths.erase(it->second.rsi);
+    recordSets.erase(it);
 }
+
+void FruImpl::updateFRU(const std::string& path)
+{
+    if (!isBuilt)
+    {
+        // The build picks up the objects it has not reached yet, the others
+        // are updated once it completes
+        pendingUpdates.emplace(path);
+        return;
+    }
+
+    auto object = objects.find(sdbusplus::message::object_path(path));
+    if (object == objects.end())
+    {
+        removeFRU(path);
+        return;
+    }
+
+    FruRecordSet previous{};
+    if (auto it = recordSets.find(path); it != recordSets.end())
+    {
+        previous = it->second;
+    }
+    bool isNew = !previous.rsi;
+
+    // Inventory objects of the path which are not in the entity association
+    // tree yet, from the top most one
+    std::vector<std::string> newNodePaths;
+    if (isNew)
+    {
+        for (auto obj = path; (obj + '/') != root && obj.starts_with(root);
+             obj = pldm::utils::findParent(obj))
+        {
+            if (!objToEntityNode.contains(obj))
+            {
+                newNodePaths.insert(newNodePaths.begin(), obj);
+            }
+        }
+    }
+
+    auto recordSet = buildRecordSet(path, object->second, previous);
+    if (!recordSet)
+    {
+        removeFRU(path);
+        return;
+    }
+    if (!isNew && recordSet->records == previous.records)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> recordHandles;
+    for (const auto& nodePath : newNodePaths)
+    {
+        auto node = objToEntityNode.find(nodePath);
+        if (node == objToEntityNode.end())
+        {
+            continue;
+        }
+
+        // Keep the copy of bmc's entity association tree in sync
+        pldm_entity entity = pldm_entity_extract(node->second);
+        pldm_entity parent = pldm_entity_get_parent(node->second);
+        auto bmcParent = pldm_entity_association_tree_find_with_locality(
+            bmcEntityTree, &parent, false);
+        pldm_entity_association_tree_add_entity(
+            bmcEntityTree, &entity, entity.entity_instance_num, bmcParent,
+            PLDM_ENTITY_ASSOCIAION_PHYSICAL, false, true, 0xFFFF);
+
+        recordHandles.emplace_back(addEntityAssociationPDR(node->second));
+    }
+
+    eraseRecordSet(path);
+    associatedEntityMap.insert_or_assign(object->first, recordSet->entity);
+    auto recordHandle = recordSet->recordHandle;
+    insertRecordSet(path, std::move(*recordSet));
+    refreshTableImage();
+    tableChangeCount++;
+
+    if (recordHandle)
+    {
+        recordHandles.emplace_back(recordHandle);
+    }
+    notifyPDRChange(isNew ? PLDM_RECORDS_ADDED : PLDM_RECORDS_MODIFIED,
+                    std::move(recordHandles));
+}
+
+void FruImpl::removeFRU(const std::string& path)
+{
+    auto it = recordSets.find(path);
+    if (!isBuilt || it == recordSets.end())
+    {
+        return;
+    }
+
+    auto rsi = it->second.rsi;
+    auto entity = it->second.entity;
+    eraseRecordSet(path);
+    associatedEntityMap.erase(path);
+    refreshTableImage();
+    tableChangeCount++;
+
+    uint32_t recordHandle = 0;
+    if (!pldm_pdr_remove_fru_record_set_by_rsi(pdrRepo, rsi, false,
+                                               &recordHandle))
+    {
+        notifyPDRChange(PLDM_RECORDS_DELETED, {recordHandle});
+    }
+
+    // An entity containing other entities stays in the entity association
+    // tree, to keep the association of the entities it contains
+    auto node = pldm_entity_association_tree_find_with_locality(
+        entityTree, &entity, false);
+    if (node == nullptr || pldm_entity_is_node_parent(node))
+    {
+        return;
+    }
+
+    recordHandle = 0;
+    if (!pldm_entity_association_pdr_remove_contained_entity(
+            pdrRepo, &entity, false, &recordHandle))
+    {
+        notifyPDRChange(PLDM_RECORDS_MODIFIED, {recordHandle});
+    }
+    if (entityRemovalCallback)
+    {
+        entityRemovalCallback(node);
+    }
+    pldm_entity_association_tree_delete_node(entityTree, &entity);
+    pldm_entity_association_tree_delete_node(bmcEntityTree, &entity);
+    objToEntityNode.erase(path);
+}
+
+uint32_t FruImpl::addEntityAssociationPDR(pldm_entity_node* node)
+{
+    pldm_entity entity = pldm_entity_extract(node);
+    pldm_entity parent = pldm_entity_get_parent(node);
+
+    std::vector<uint8_t> pdr(sizeof(pldm_pdr_hdr) +
+                             sizeof(pldm_pdr_entity_association));
+    auto hdr = reinterpret_cast<pldm_pdr_hdr*>(pdr.data());
+    hdr->version = 1;
+    hdr->type = PLDM_PDR_ENTITY_ASSOCIATION;
+    hdr->record_change_num = 0;
+    hdr->length = htole16(pdr.size() - sizeof(pldm_pdr_hdr));
+
+    auto association = reinterpret_cast<pldm_pdr_entity_association*>(
+        pdr.data() + sizeof(pldm_pdr_hdr));
+    association->container_id = htole16(entity.entity_container_id);
+    association->association_type = PLDM_ENTITY_ASSOCIAION_PHYSICAL;
+    association->container.entity_type = htole16(parent.entity_type);
+    association->container.entity_instance_num =
+        htole16(parent.entity_instance_num);
+    association->container.entity_container_id =
+        htole16(parent.entity_container_id);
+    association->num_children = 1;
+    association->children[0].entity_type = htole16(entity.entity_type);
+    association->children[0].entity_instance_num =
+        htole16(entity.entity_instance_num);
+    association->children[0].entity_container_id =
+        htole16(entity.entity_container_id);
+
+    uint32_t recordHandle = 0;
+    int rc = pldm_pdr_add_check(pdrRepo, pdr.data(), pdr.size(), false,
+                                TERMINUS_HANDLE, &recordHandle);
+    if (rc)
+    {
+        // pldm_pdr_add() assert()ed on failure to add PDR
+        throw std::runtime_error("Failed to add entity association PDR");
+    }
+    return recordHandle;
+}
+
+void FruImpl::watchInventory()
+{
+    if (!inventoryMatches.empty())
+    {
+        return;
+    }
+
+    namespace rules = sdbusplus::bus::match::rules;
+    auto& bus = pldm::utils::DBusHandler::getBus();
+    inventoryMatches.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus, rules::interfacesAdded(pldm::utils::inventoryPath),
+        [this](sdbusplus::message_t& msg) {
+        inventoryInterfacesChanged(msg, true);
+    }));
+    inventoryMatches.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus, rules::interfacesRemoved(pldm::utils::inventoryPath),
+        [this](sdbusplus::message_t& msg) {
+        inventoryInterfacesChanged(msg, false);
+    }));
+    inventoryMatches.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        rules::type::signal() + rules::member("PropertiesChanged") +
+            rules::interface(pldm::utils::dbusProperties) +
+            rules::path_namespace(pldm::utils::inventoryPath),
+        [this](sdbusplus::message_t& msg) {
+        inventoryPropertiesChanged(msg);
+    }));
+}
+
+void FruImpl::inventoryInterfacesChanged(sdbusplus::message_t& msg,
+                                         bool added)
+{
+    sdbusplus::message::object_path path;
+    try
+    {
+        if (added)
+        {
+            dbus::InterfaceMap interfaces;
+            msg.read(path, interfaces);
+            interfacesAdded(path.str, std::move(interfaces));
+        }
+        else
+        {
+            std::vector<std::string> interfaces;
+            msg.read(path, interfaces);
+            interfacesRemoved(path.str, interfaces);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to read inventory interfaces signal: {ERROR}", "ERROR",
+              e);
+    }
+}
+
+void FruImpl::inventoryPropertiesChanged(sdbusplus::message_t& msg)
+{
+    try
+    {
+        std::string interface;
+        dbus::PropertyMap properties;
+        std::vector<std::string> invalidated;
+        msg.read(interface, properties, invalidated);
+        propertiesChanged(msg.get_path(), interface, std::move(properties));
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to read inventory properties signal: {ERROR}", "ERROR",
+              e);
+    }
+}
+
+void FruImpl::interfacesAdded(const std::string& path,
+                              dbus::InterfaceMap&& interfaces)
+{
+    auto& objectInterfaces = objects[sdbusplus::message::object_path(path)];
+    for (auto& [interface, properties] : interfaces)
+    {
+        objectInterfaces.insert_or_assign(interface, std::move(properties));
+    }
+
+    updateFRU(path);
+}
+
+void FruImpl::interfacesRemoved(const std::string& path,
+                                const std::vector<std::string>& interfaces)
+{
+    auto object = objects.find(sdbusplus::message::object_path(path));
+    if (object == objects.end())
+    {
+        return;
+    }
+    for (const auto& interface : interfaces)
+    {
+        object->second.erase(interface);
+    }
+    // The build in progress may be positioned on the object
+    if (object->second.empty() && isBuilt)
+    {
+        objects.erase(object);
+    }
+
+    updateFRU(path);
+}
+
+void FruImpl::propertiesChanged(const std::string& path,
+                                const std::string& interface,
+                                dbus::PropertyMap&& properties)
+{
+    auto object = objects.find(sdbusplus::message::object_path(path));
+    if (object == objects.end())
+    {
+        return;
+    }
+
+    auto& objectProperties = object->second[interface];
+    for (auto& [property, value] : properties)
+    {
+        objectProperties.insert_or_assign(property, std::move(value));
+    }
+
+    // Only the changes of the properties the FRU records or the FRU presence
+    // are built from can change the FRU table
+    if (fruIntfs.contains(interface))
+    {
+        updateFRU(path);
+    }
+}
+
+void FruImpl::notifyPDRChange(uint8_t eventDataOperation,
+                              std::vector<uint32_t>&& recordHandles)
+{
+    if (!pdrChangeCallback || recordHandles.empty())
+    {
+        return;
+    }
+    pdrChangeCallback(eventDataOperation, std::move(recordHandles));
+}
+
 std::string FruImpl::populatefwVersion()
 {
+    // The running BMC version does not change while pldmd runs
+    if (!currentBmcVersion.empty())
+    {
+        return currentBmcVersion;
+    }
+
     static constexpr auto fwFunctionalObjPath =
         "/xyz/openbmc_project/software/functional";
     auto& bus = pldm::utils::DBusHandler::getBus();
-    std::string currentBmcVersion;
     try
     {
         auto method = bus.new_method_call(pldm::utils::mapperService,
@@ -252,12 +709,9 @@ std::string FruImpl::populatefwVersion()
 }
 void FruImpl::populateRecords(
     const pldm::responder::dbus::InterfaceMap& interfaces,
-    const fru_parser::FruRecordInfos& recordInfos, const pldm_entity& entity)
+    const fru_parser::FruRecordInfos& recordInfos, FruRecordSet& recordSet)
 {
-    // recordSetIdentifier for the FRU will be set when the first record gets
-    // added for the FRU
-    uint16_t recordSetIdentifier = 0;
-    auto numRecsCount = numRecs;
+    const auto& entity = recordSet.entity;
     static uint32_t bmc_record_handle = 0;
 
     for (const auto& [recType, encType, fieldInfos] : recordInfos)
@@ -317,12 +771,14 @@ void FruImpl::populateRecords(
 
         if (tlvs.size())
         {
-            if (numRecs == numRecsCount)
+            // recordSetIdentifier for the FRU is set when the first record
+            // gets added for the FRU
+            if (!recordSet.rsi)
             {
-                recordSetIdentifier = nextRSI();
+                recordSet.rsi = nextRSI();
                 bmc_record_handle = nextRecordHandle();
                 int rc = pldm_pdr_add_fru_record_set_check(
-                    pdrRepo, TERMINUS_HANDLE, recordSetIdentifier,
+                    pdrRepo, TERMINUS_HANDLE, recordSet.rsi,
                     entity.entity_type, entity.entity_instance_num,
                     entity.entity_container_id, &bmc_record_handle);
                 if (rc)
@@ -331,57 +787,70 @@ void FruImpl::populateRecords(
                     throw std::runtime_error(
                         "Failed to add PDR FRU record set");
                 }
+                recordSet.recordHandle = bmc_record_handle;
             }
-            auto curSize = table.size();
-            table.resize(curSize + recHeaderSize + tlvs.size());
-            encode_fru_record(table.data(), table.size(), &curSize,
-                              recordSetIdentifier, recType, numFRUFields,
-                              encType, tlvs.data(), tlvs.size());
-            numRecs++;
+            auto& records = recordSet.records;
+            auto curSize = records.size();
+            recordSet.recordOffsets[recType].emplace_back(curSize);
+            records.resize(curSize + recHeaderSize + tlvs.size());
+            encode_fru_record(records.data(), records.size(), &curSize,
+                              recordSet.rsi, recType, numFRUFields, encType,
+                              tlvs.data(), tlvs.size());
+            recordSet.numRecords++;
         }
     }
 }
 
-std::vector<uint8_t> FruImpl::tableResize()
+void FruImpl::refreshTableImage()
 {
-    std::vector<uint8_t> tempTable;
+    auto padBytes = pldm::utils::getNumPadBytes(table.size());
+    auto image = std::make_shared<std::vector<uint8_t>>(
+        table.size() + padBytes + sizeof(checksum), 0);
+    std::copy(table.begin(), table.end(), image->begin());
 
-    if (table.size())
-    {
-        std::copy(table.begin(), table.end(), std::back_inserter(tempTable));
-        padBytes = pldm::utils::getNumPadBytes(table.size());
-        tempTable.resize(tempTable.size() + padBytes, 0);
-    }
-    return tempTable;
+    checksum = pldm::utils::calcCrc32(image->data(), table.size() + padBytes);
+    std::copy_n(reinterpret_cast<const uint8_t*>(&checksum), sizeof(checksum),
+                image->end() - sizeof(checksum));
+    tableImage = std::move(image);
 }
 
-void FruImpl::getFRUTable(Response& response)
+std::shared_ptr<const std::vector<uint8_t>> FruImpl::getFRUTable()
 {
-    auto hdrSize = response.size();
-    std::vector<uint8_t> tempTable;
-
-    if (table.size())
+    if (!tableImage)
     {
-        tempTable = tableResize();
-        checksum = crc32(tempTable.data(), tempTable.size());
+        refreshTableImage();
     }
-    response.resize(hdrSize + tempTable.size() + sizeof(checksum), 0);
-    std::copy(tempTable.begin(), tempTable.end(), response.begin() + hdrSize);
-
-    // Copy the checksum to response data
-    auto iter = response.begin() + hdrSize + tempTable.size();
-    std::copy_n(reinterpret_cast<const uint8_t*>(&checksum), sizeof(checksum),
-                iter);
+    return tableImage;
 }
 
-void FruImpl::getFRURecordTableMetadata()
+size_t FruImpl::appendRecord(const uint8_t* record, uint8_t fieldType,
+                             std::vector<uint8_t>& fruData)
 {
-    std::vector<uint8_t> tempTable;
-    if (table.size())
+    auto numFieldsOffset = fruData.size() +
+                           offsetof(pldm_fru_record_data_format,
+                                    num_fru_fields);
+    auto numFields = record[offsetof(pldm_fru_record_data_format,
+                                     num_fru_fields)];
+    fruData.insert(fruData.end(), record, record + recHeaderSize);
+
+    uint8_t numMatchingFields = 0;
+    size_t offset = recHeaderSize;
+    for (uint8_t field = 0; field < numFields; field++)
     {
-        tempTable = tableResize();
-        checksum = crc32(tempTable.data(), tempTable.size());
+        auto tlv = reinterpret_cast<const pldm_fru_record_tlv*>(record +
+                                                                 offset);
+        size_t tlvSize = sizeof(*tlv) - 1 + tlv->length;
+        if (!fieldType || tlv->type == fieldType)
+        {
+            fruData.insert(fruData.end(), record + offset,
+                           record + offset + tlvSize);
+            numMatchingFields++;
+        }
+        offset += tlvSize;
     }
+    fruData[numFieldsOffset] = numMatchingFields;
+
+    return offset;
 }
 
 int FruImpl::getFRURecordByOption(std::vector<uint8_t>& fruData,
@@ -394,30 +863,62 @@ int FruImpl::getFRURecordByOption(std::vector<uint8_t>& fruData,
     // FRU table is built lazily, build if not done.
     buildFRUTable();
 
-    /* 7 is sizeof(checksum,4) + padBytesMax(3)
-     * We can not know size of the record table got by options in advance, but
-     * it must be less than the source table. So it's safe to use sizeof the
-     * source table + 7 as the buffer length
-     */
-    size_t recordTableSize = table.size() - padBytes + 7;
-    fruData.resize(recordTableSize, 0);
+    // Look up the records through the index instead of scanning the table,
+    // a record set identifier or record type of 0 matches all of them
+    auto appendRecordSet = [&](const FruRecordSet& recordSet) {
+        auto records = recordSet.records.data();
+        if (recordType)
+        {
+            auto offsets = recordSet.recordOffsets.find(recordType);
+            if (offsets == recordSet.recordOffsets.end())
+            {
+                return;
+            }
+            for (auto offset : offsets->second)
+            {
+                appendRecord(records + offset, fieldType, fruData);
+            }
+            return;
+        }
+
+        size_t offset = 0;
+        for (uint16_t i = 0; i < recordSet.numRecords; i++)
+        {
+            offset += appendRecord(records + offset, fieldType, fruData);
+        }
+    };
 
-    int rc = get_fru_record_by_option_check(
-        table.data(), table.size() - padBytes, fruData.data(), &recordTableSize,
-        recordSetIdentifer, recordType, fieldType);
+    fruData.clear();
+    if (recordSetIdentifer)
+    {
+        auto path = recordSetPaths.find(recordSetIdentifer);
+        if (path != recordSetPaths.end())
+        {
+            appendRecordSet(recordSets.at(path->second));
+        }
+    }
+    else
+    {
+        for (const auto& [path, recordSet] : recordSets)
+        {
+            appendRecordSet(recordSet);
+        }
+    }
 
-    if (rc != PLDM_SUCCESS || recordTableSize == 0)
+    size_t recordTableSize = fruData.size();
+    if (recordTableSize == 0)
     {
         return PLDM_FRU_DATA_STRUCTURE_TABLE_UNAVAILABLE;
     }
 
     auto pads = pldm::utils::getNumPadBytes(recordTableSize);
-    crc32(fruData.data(), recordTableSize + pads);
+    fruData.resize(recordTableSize + pads + sizeof(sum), 0);
+    sum checksum = pldm::utils::calcCrc32(fruData.data(),
+                                          recordTableSize + pads);
 
     auto iter = fruData.begin() + recordTableSize + pads;
     std::copy_n(reinterpret_cast<const uint8_t*>(&checksum), sizeof(checksum),
                 iter);
-    fruData.resize(recordTableSize + pads + sizeof(sum));
 
     return PLDM_SUCCESS;
 }
@@ -445,6 +946,11 @@ namespace fru
 Response Handler::getFRURecordTableMetadata(const pldm_msg* request,
                                             size_t /*payloadLength*/)
 {
+    if (impl.isBuildInProgress())
+    {
+        return ccOnlyResponse(request, PLDM_ERROR_NOT_READY);
+    }
+
     // FRU table is built lazily, build if not done.
     buildFRUTable();
 
@@ -457,8 +963,6 @@ Response Handler::getFRURecordTableMetadata(const pldm_msg* request,
                       0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
-    impl.getFRURecordTableMetadata();
-
     auto rc = encode_get_fru_record_table_metadata_resp(
         request->hdr.instance_id, PLDM_SUCCESS, major, minor, maxSize,
         impl.size(), impl.numRSI(), impl.numRecords(), impl.checkSum(),
@@ -471,30 +975,92 @@ Response Handler::getFRURecordTableMetadata(const pldm_msg* request,
     return response;
 }
 
-Response Handler::getFRURecordTable(const pldm_msg* request,
+Response Handler::getFRURecordTable(pldm_tid_t tid, const pldm_msg* request,
                                     size_t payloadLength)
 {
+    if (impl.isBuildInProgress())
+    {
+        return ccOnlyResponse(request, PLDM_ERROR_NOT_READY);
+    }
+
     // FRU table is built lazily, build if not done.
     buildFRUTable();
 
-    if (payloadLength != PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES)
+    uint32_t transferHandle{};
+    uint8_t transferOpFlag{};
+    auto rc = decode_get_fru_record_table_req(request, payloadLength,
+                                              &transferHandle, &transferOpFlag);
+    if (rc != PLDM_SUCCESS)
     {
-        return ccOnlyResponse(request, PLDM_ERROR_INVALID_LENGTH);
+        return ccOnlyResponse(request, rc);
     }
 
+    std::shared_ptr<const Table> table;
+    if (transferOpFlag == PLDM_GET_FIRSTPART)
+    {
+        // Serve the whole transfer from the version of the table at the
+        // first part, even if the table is updated in the meantime
+        table = impl.getFRUTable();
+        transferHandle = 0;
+    }
+    else if (transferOpFlag == PLDM_GET_NEXTPART)
+    {
+        auto transfer = getTableTransfers.find(tid);
+        if (transfer == getTableTransfers.end())
+        {
+            return ccOnlyResponse(request,
+                                  PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+        }
+        table = transfer->second;
+        // A part may be requested again when its response got lost
+        if (transferHandle == 0 || transferHandle >= table->size() ||
+            !transferSize || transferHandle % transferSize)
+        {
+            return ccOnlyResponse(request,
+                                  PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+        }
+    }
+    else
+    {
+        return ccOnlyResponse(request, PLDM_INVALID_TRANSFER_OPERATION_FLAG);
+    }
+
+    size_t partSize = table->size() - transferHandle;
+    if (transferSize)
+    {
+        partSize = std::min(partSize, transferSize);
+    }
+    bool lastPart = transferHandle + partSize == table->size();
+    uint8_t transferFlag{};
+    if (transferHandle == 0)
+    {
+        transferFlag = lastPart ? PLDM_START_AND_END : PLDM_START;
+    }
+    else
+    {
+        transferFlag = lastPart ? PLDM_END : PLDM_MIDDLE;
+    }
+    uint32_t nextTransferHandle = lastPart ? 0 : transferHandle + partSize;
+
     Response response(
         sizeof(pldm_msg_hdr) + PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES, 0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
-    auto rc = encode_get_fru_record_table_resp(request->hdr.instance_id,
-                                               PLDM_SUCCESS, 0,
-                                               PLDM_START_AND_END, responsePtr);
+    rc = encode_get_fru_record_table_resp(request->hdr.instance_id,
+                                          PLDM_SUCCESS, nextTransferHandle,
+                                          transferFlag, responsePtr);
     if (rc != PLDM_SUCCESS)
     {
         return ccOnlyResponse(request, rc);
     }
+    response.insert(response.end(), table->begin() + transferHandle,
+                    table->begin() + transferHandle + partSize);
 
-    impl.getFRUTable(response);
+    if (transferOpFlag == PLDM_GET_FIRSTPART)
+    {
+        // Kept after the last part too, so that it can be requested again
+        getTableTransfers.insert_or_assign(tid, std::move(table));
+    }
 
     return response;
 }
@@ -507,6 +1073,11 @@ Response Handler::getFRURecordByOption(const pldm_msg* request,
         return ccOnlyResponse(request, PLDM_ERROR_INVALID_LENGTH);
     }
 
+    if (impl.isBuildInProgress())
+    {
+        return ccOnlyResponse(request, PLDM_ERROR_NOT_READY);
+    }
+
     uint32_t retDataTransferHandle{};
     uint16_t retFruTableHandle{};
     uint16_t retRecordSetIdentifier{};
@@ -8,9 +8,14 @@
 #include <libpldm/fru.h>
 #include <libpldm/pdr.h>
 
+#include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/message.hpp>
 
+#include <functional>
 #include <map>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
 #include <variant>
 #include <vector>
@@ -35,6 +40,32 @@ using AssociatedEntityMap = std::map<ObjectPath, pldm_entity>;
 
 } // namespace dbus
 
+/** @struct FruRecordSet
+ *
+ *  The FRU records of an inventory object in the FRU table
+ */
+struct FruRecordSet
+{
+    uint16_t rsi = 0; //!< 0 until the first record is added
+    uint32_t recordHandle = 0; //!< record handle of the FRU record set PDR
+    pldm_entity entity{};
+    uint16_t numRecords = 0;
+    std::vector<uint8_t> records;
+
+    /** @brief Offsets of the records in records, by FRU record type */
+    std::map<uint8_t, std::vector<uint32_t>> recordOffsets;
+};
+
+/** @brief Callback to notify the PDRs changed by an update of the FRU table,
+ *         with the event data operation and the record handles of the PDRs
+ */
+using PDRChangeCallback = std::function<void(uint8_t, std::vector<uint32_t>&&)>;
+
+/** @brief Callback called with a node of the BMC's entity association tree
+ *         before it is removed from the tree
+ */
+using EntityRemovalCallback = std::function<void(const pldm_entity_node*)>;
+
 /** @class FruImpl
  *
  *  @brief Builds the PLDM FRU table containing the FRU records
@@ -98,7 +129,7 @@ class FruImpl
      */
     uint16_t numRSI() const
     {
-        return rsi;
+        return recordSets.size();
     }
 
     /** @brief The number of FRU records in the table
@@ -110,16 +141,41 @@ class FruImpl
         return numRecs;
     }
 
-    /** @brief Get the FRU table
+    /** @brief Number of times the FRU table changed after it was built
+     *
+     *  @return the change count
+     */
+    uint32_t changeCount() const
+    {
+        return tableChangeCount;
+    }
+
+    /** @brief Set the callback notifying the PDRs changed by an update of the
+     *         FRU table, when the inventory changes after the table is built
+     *
+     *  @param[in] callback - the callback
+     */
+    void setPDRChangeCallback(PDRChangeCallback callback)
+    {
+        pdrChangeCallback = std::move(callback);
+    }
+
+    /** @brief Set the callback called before a node is removed from the
+     *         entity association tree, when a FRU is removed
      *
-     *  @param[out] - Populate response with the FRU table
+     *  @param[in] callback - the callback
      */
-    void getFRUTable(Response& response);
+    void setEntityRemovalCallback(EntityRemovalCallback callback)
+    {
+        entityRemovalCallback = std::move(callback);
+    }
 
-    /** @brief Get the Fru Table MetaData
+    /** @brief Get the FRU table, the image is replaced rather than modified
+     *         when the FRU table changes
      *
+     *  @return the FRU table followed by the pad bytes and the checksum
      */
-    void getFRURecordTableMetadata();
+    std::shared_ptr<const std::vector<uint8_t>> getFRUTable();
 
     /** @brief Get FRU Record Table By Option
      *  @param[out] response - Populate response with the FRU table got by
@@ -135,10 +191,44 @@ class FruImpl
 
     /** @brief FRU table is built by processing the D-Bus inventory namespace
      *         based on the config files for FRU. The table is populated based
-     *         on the isBuilt flag.
+     *         on the isBuilt flag. A build started with startFRUTableBuild()
+     *         is run to completion.
      */
     void buildFRUTable();
 
+    /** @brief Start building the FRU table incrementally. This looks up the
+     *         inventory objects, the FRU records are then built by calling
+     *         buildFRUTableSlice() until it returns true.
+     *
+     *  @return true if the build was started or is already in progress
+     */
+    bool startFRUTableBuild();
+
+    /** @brief Start building the FRU table incrementally from inventory
+     *         objects already looked up
+     *
+     *  @param[in] inventory - the inventory objects
+     */
+    void startFRUTableBuild(dbus::ObjectValueTree&& inventory);
+
+    /** @brief Build the FRU records for the next few inventory objects, and
+     *         add the entity association PDRs once all the objects are done.
+     *
+     *  @param[in] maxObjects - maximum number of inventory objects to process
+     *
+     *  @return true if the FRU table is built or no build is in progress
+     */
+    bool buildFRUTableSlice(size_t maxObjects);
+
+    /** @brief Check if an incremental FRU table build is in progress
+     *
+     *  @return true if the build is started and not yet complete
+     */
+    bool isBuildInProgress() const
+    {
+        return nextObject.has_value();
+    }
+
     /** @brief Get std::map associated with the entity
      *         key: object path
      *         value: pldm_entity
@@ -187,12 +277,6 @@ class FruImpl
      */
     std::string populatefwVersion();
 
-    /* @brief Method to resize the table
-     *
-     * @return resized table
-     */
-    std::vector<uint8_t> tableResize();
-
     /* @brief set FRU Record Table
      *
      * @param[in] fruData - the data of the fru
@@ -201,6 +285,51 @@ class FruImpl
      */
     int setFRUTable(const std::vector<uint8_t>& fruData);
 
+    /** @brief Rebuild the FRU records of an inventory object after it is
+     *         added or its properties change. A FRU which is new to the table
+     *         is added to the entity association tree and gets a FRU record
+     *         set PDR and an entity association PDR.
+     *
+     *  @param[in] path - object path of the inventory object
+     */
+    void updateFRU(const std::string& path);
+
+    /** @brief Remove the FRU records, the PDRs and the entity association
+     *         node of an inventory object which is removed or not present
+     *
+     *  @param[in] path - object path of the inventory object
+     */
+    void removeFRU(const std::string& path);
+
+    /** @brief Apply the interfaces added to an inventory object, and update
+     *         its FRU records
+     *
+     *  @param[in] path - object path of the inventory object
+     *  @param[in] interfaces - the interfaces added, with their properties
+     */
+    void interfacesAdded(const std::string& path,
+                         dbus::InterfaceMap&& interfaces);
+
+    /** @brief Apply the interfaces removed from an inventory object, and
+     *         update its FRU records
+     *
+     *  @param[in] path - object path of the inventory object
+     *  @param[in] interfaces - the interfaces removed
+     */
+    void interfacesRemoved(const std::string& path,
+                           const std::vector<std::string>& interfaces);
+
+    /** @brief Apply the properties changed on an inventory object, and update
+     *         its FRU records if the FRU table uses the interface
+     *
+     *  @param[in] path - object path of the inventory object
+     *  @param[in] interface - the interface of the properties
+     *  @param[in] properties - the properties changed
+     */
+    void propertiesChanged(const std::string& path,
+                           const std::string& interface,
+                           dbus::PropertyMap&& properties);
+
   private:
     uint16_t nextRSI()
     {
@@ -215,9 +344,13 @@ class FruImpl
     uint32_t rh = 0;
     uint16_t rsi = 0;
     uint16_t numRecs = 0;
-    uint8_t padBytes = 0;
     std::vector<uint8_t> table;
     uint32_t checksum = 0;
+
+    /** @brief The FRU table padded to a multiple of 4 bytes and followed by
+     *         its checksum, as sent in the GetFRURecordTable response
+     */
+    std::shared_ptr<const std::vector<uint8_t>> tableImage;
     bool isBuilt = false;
 
     fru_parser::FruParser parser;
@@ -227,19 +360,147 @@ class FruImpl
     pldm::responder::oem_fru::Handler* oemFruHandler;
     dbus::ObjectValueTree objects;
 
+    /** @brief Item interfaces from FRU_Master.json, looked up when the FRU
+     *         table build starts
+     */
+    dbus::Interfaces itemIntfsLookup{};
+
+    /** @brief Interfaces the FRU records and the FRU presence are built from,
+     *         the other property changes of the inventory are ignored
+     */
+    dbus::Interfaces fruIntfs{};
+
+    /** @brief Inventory object the incremental FRU table build resumes from
+     */
+    std::optional<dbus::ObjectValueTree::const_iterator> nextObject{};
+
     std::map<dbus::ObjectPath, pldm_entity_node*> objToEntityNode{};
 
-    /** @brief populateRecord builds the FRU records for an instance of FRU and
-     *         updates the FRU table with the FRU records.
+    /** @brief FRU records of the inventory objects, in the order they are in
+     *         the FRU table
+     */
+    std::map<dbus::ObjectPath, FruRecordSet> recordSets{};
+
+    /** @brief Inventory object of each FRU record set identifier in the FRU
+     *         table, to look up the records of a record set
+     */
+    std::map<uint16_t, dbus::ObjectPath> recordSetPaths{};
+
+    /** @brief Running BMC firmware version, looked up once */
+    std::string currentBmcVersion;
+
+    /** @brief Number of times the FRU table changed after it was built */
+    uint32_t tableChangeCount = 0;
+
+    /** @brief Inventory objects which changed while the FRU table was being
+     *         built
+     */
+    std::set<std::string> pendingUpdates{};
+
+    /** @brief Callback notifying the PDRs changed by an update of the table */
+    PDRChangeCallback pdrChangeCallback;
+
+    /** @brief Callback called before a node is removed from the entity
+     *         association tree
+     */
+    EntityRemovalCallback entityRemovalCallback;
+
+    /** @brief D-Bus signal matches on the inventory, to keep the FRU table
+     *         in sync with it once it is built
+     */
+    std::vector<std::unique_ptr<sdbusplus::bus::match_t>> inventoryMatches;
+
+    /** @brief populateRecord builds the FRU records for an instance of FRU
      *
      *  @param[in] interfaces - D-Bus interfaces and the associated property
      *                          values for the FRU
      *  @param[in] recordInfos - FRU record info to build the FRU records
-     *  @param[in/out] entity - PLDM entity corresponding to FRU instance
+     *  @param[in/out] recordSet - FRU records of the FRU instance, a FRU
+     *                             record set PDR is added if it has no RSI
      */
     void populateRecords(const dbus::InterfaceMap& interfaces,
                          const fru_parser::FruRecordInfos& recordInfos,
-                         const pldm_entity& entity);
+                         FruRecordSet& recordSet);
+
+    /** @brief Build the FRU records of an inventory object
+     *
+     *  @param[in] path - object path of the inventory object
+     *  @param[in] interfaces - D-Bus interfaces of the inventory object
+     *  @param[in] recordSet - the previous FRU records of the object, its RSI
+     *                         and entity are kept
+     *
+     *  @return the FRU records, std::nullopt if the object is not a FRU or
+     *          the FRU is not present
+     */
+    std::optional<FruRecordSet>
+        buildRecordSet(const std::string& path,
+                       const dbus::InterfaceMap& interfaces,
+                       FruRecordSet recordSet);
+
+    /** @brief Refresh the padded FRU table image and its checksum after the
+     *         FRU table changes
+     */
+    void refreshTableImage();
+
+    /** @brief Append a FRU record with only the FRU fields of a field type
+     *
+     *  @param[in] record - the FRU record
+     *  @param[in] fieldType - the FRU field type, 0 for all the FRU fields
+     *  @param[out] fruData - the FRU record data to append to
+     *
+     *  @return size of the FRU record
+     */
+    static size_t appendRecord(const uint8_t* record, uint8_t fieldType,
+                               std::vector<uint8_t>& fruData);
+
+    /** @brief Insert the FRU records of an inventory object in the FRU table
+     *
+     *  @param[in] path - object path of the inventory object
+     *  @param[in] recordSet - the FRU records
+     */
+    void insertRecordSet(const std::string& path, FruRecordSet&& recordSet);
+
+    /** @brief Erase the FRU records of an inventory object from the FRU table
+     *
+     *  @param[in] path - object path of the inventory object
+     */
+    void eraseRecordSet(const std::string& path);
+
+    /** @brief Add an entity association PDR with a new entity association
+     *         node as the only child of its container
+     *
+     *  @param[in] node - the entity association node
+     *
+     *  @return record handle of the PDR
+     */
+    uint32_t addEntityAssociationPDR(pldm_entity_node* node);
+
+    /** @brief Subscribe to the changes of the inventory objects */
+    void watchInventory();
+
+    /** @brief Handle InterfacesAdded and InterfacesRemoved signals of the
+     *         inventory
+     *
+     *  @param[in] msg - D-Bus signal
+     *  @param[in] added - true for InterfacesAdded
+     */
+    void inventoryInterfacesChanged(sdbusplus::message_t& msg, bool added);
+
+    /** @brief Handle PropertiesChanged signals of the inventory
+     *
+     *  @param[in] msg - D-Bus signal
+     */
+    void inventoryPropertiesChanged(sdbusplus::message_t& msg);
+
+    /** @brief Notify the PDRs changed by an update of the FRU table
+     *
+     *  @param[in] eventDataOperation - PLDM_RECORDS_ADDED,
+     *                                  PLDM_RECORDS_DELETED or
+     *                                  PLDM_RECORDS_MODIFIED
+     *  @param[in] recordHandles - record handles of the changed PDRs
+     */
+    void notifyPDRChange(uint8_t eventDataOperation,
+                         std::vector<uint32_t>&& recordHandles);
 
     /** @brief Associate sensor/effecter to FRU entity
      */
@@ -267,8 +528,9 @@ class Handler : public CmdHandler
         });
         handlers.emplace(
             PLDM_GET_FRU_RECORD_TABLE,
-            [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
-            return this->getFRURecordTable(request, payloadLength);
+            [this](pldm_tid_t tid, const pldm_msg* request,
+                   size_t payloadLength) {
+            return this->getFRURecordTable(tid, request, payloadLength);
         });
         handlers.emplace(
             PLDM_GET_FRU_RECORD_BY_OPTION,
@@ -292,14 +554,18 @@ class Handler : public CmdHandler
     Response getFRURecordTableMetadata(const pldm_msg* request,
                                        size_t payloadLength);
 
-    /** @brief Handler for GetFRURecordTable
+    /** @brief Handler for GetFRURecordTable, the table is transferred in
+     *         parts of at most FRU_TABLE_TRANSFER_SIZE bytes, or in a single
+     *         part if it is 0
      *
+     *  @param[in] tid - TID of the requester
      *  @param[in] request - Request message payload
      *  @param[in] payloadLength - Request payload length
      *
      *  @return PLDM response message
      */
-    Response getFRURecordTable(const pldm_msg* request, size_t payloadLength);
+    Response getFRURecordTable(pldm_tid_t tid, const pldm_msg* request,
+                               size_t payloadLength);
 
     /** @brief Build FRU table is bnot already built
      *
@@ -309,6 +575,26 @@ class Handler : public CmdHandler
         impl.buildFRUTable();
     }
 
+    /** @brief Start building the FRU table incrementally
+     *
+     *  @return true if the build was started or is already in progress
+     */
+    bool startFRUTableBuild()
+    {
+        return impl.startFRUTableBuild();
+    }
+
+    /** @brief Build the FRU table for the next few inventory objects
+     *
+     *  @param[in] maxObjects - maximum number of inventory objects to process
+     *
+     *  @return true if the FRU table is built or no build is in progress
+     */
+    bool buildFRUTableSlice(size_t maxObjects)
+    {
+        return impl.buildFRUTableSlice(maxObjects);
+    }
+
     /** @brief Get std::map associated with the entity
      *         key: object path
      *         value: pldm_entity
@@ -321,6 +607,26 @@ class Handler : public CmdHandler
         return impl.getAssociateEntityMap();
     }
 
+    /** @brief Set the callback notifying the PDRs changed by an update of the
+     *         FRU table
+     *
+     *  @param[in] callback - the callback
+     */
+    void setPDRChangeCallback(PDRChangeCallback callback)
+    {
+        impl.setPDRChangeCallback(std::move(callback));
+    }
+
+    /** @brief Set the callback called before a node is removed from the
+     *         entity association tree, when a FRU is removed
+     *
+     *  @param[in] callback - the callback
+     */
+    void setEntityRemovalCallback(EntityRemovalCallback callback)
+    {
+        impl.setEntityRemovalCallback(std::move(callback));
+    }
+
     /** @brief Handler for GetFRURecordByOption
      *
      *  @param[in] request - Request message payload
@@ -342,8 +648,38 @@ class Handler : public CmdHandler
 
     using Table = std::vector<uint8_t>;
 
+    /** @brief Set the maximum size of a part of a GetFRURecordTable transfer
+     *
+     *  @param[in] size - maximum size of the FRU table data in a part, 0 to
+     *                    send the whole table in a single part
+     */
+    void setTransferSize(size_t size)
+    {
+        transferSize = size;
+    }
+
+    /** @brief Start building the FRU table incrementally from inventory
+     *         objects already looked up
+     *
+     *  @param[in] inventory - the inventory objects
+     */
+    void startFRUTableBuild(dbus::ObjectValueTree&& inventory)
+    {
+        impl.startFRUTableBuild(std::move(inventory));
+    }
+
   private:
     FruImpl impl;
+
+    /** @brief Maximum size of the FRU table data in a part of a
+     *         GetFRURecordTable transfer, 0 for no limit
+     */
+    size_t transferSize = FRU_TABLE_TRANSFER_SIZE;
+
+    /** @brief Version of the FRU table served to each requester of a
+     *         multipart GetFRURecordTable transfer
+     */
+    std::map<pldm_tid_t, std::shared_ptr<const Table>> getTableTransfers;
 };
 
 } // namespace fru
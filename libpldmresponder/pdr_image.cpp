@@ -0,0 +1,208 @@
+#include "pdr_image.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+namespace responder
+{
+namespace pdr_image
+{
+
+static constexpr std::array<char, 8> imageMagic{'P', 'L', 'D', 'M',
+                                                'P', 'D', 'R', '\0'};
+
+Json getManifest(const std::vector<fs::path>& dirs)
+{
+    Json manifest = Json::array();
+    for (const auto& directory : dirs)
+    {
+        if (!fs::exists(directory))
+        {
+            continue;
+        }
+
+        for (const auto& dirEntry : fs::directory_iterator(directory))
+        {
+            if (!dirEntry.is_regular_file())
+            {
+                continue;
+            }
+
+            manifest.push_back(Json{
+                {"path", dirEntry.path().string()},
+                {"size", dirEntry.file_size()},
+                {"mtime",
+                 dirEntry.last_write_time().time_since_epoch().count()}});
+        }
+    }
+
+    return manifest;
+}
+
+bool compile(const std::vector<fs::path>& dirs, const fs::path& imagePath)
+{
+    auto manifest = getManifest(dirs);
+    PdrJsons pdrJsons{};
+    for (const auto& source : manifest)
+    {
+        auto path = source["path"].get<std::string>();
+        try
+        {
+            pdrJsons.emplace_back(pdr_utils::readJson(path));
+        }
+        catch (const std::exception& e)
+        {
+            error(
+                "Failed to compile PDR JSON file '{PATH}' into PDR image, error - {ERROR}",
+                "PATH", path, "ERROR", e);
+            return false;
+        }
+    }
+
+    return write(manifest, pdrJsons, imagePath);
+}
+
+bool write(const Json& manifest, const PdrJsons& pdrJsons,
+           const fs::path& imagePath)
+{
+    auto tmpPath = imagePath;
+    tmpPath += ".tmp";
+    try
+    {
+        auto body = Json::to_cbor(manifest);
+        auto payload = Json::to_cbor(Json(pdrJsons));
+
+        ImageHeader header{};
+        header.magic = imageMagic;
+        header.version = imageVersion;
+        header.manifestSize = body.size();
+        header.payloadSize = payload.size();
+        body.insert(body.end(), payload.begin(), payload.end());
+        header.checksum = pldm::utils::calcCrc32(body.data(), body.size());
+
+        fs::create_directories(imagePath.parent_path());
+        std::ofstream stream(tmpPath, std::ios::out | std::ios::binary |
+                                          std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(body.data()), body.size());
+        stream.close();
+        if (!stream)
+        {
+            throw std::runtime_error("Failed to write compiled PDR image");
+        }
+        fs::rename(tmpPath, imagePath);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to write PDR image '{PATH}', error - {ERROR}", "PATH",
+              imagePath, "ERROR", e);
+        std::error_code ec;
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<PdrJsons> load(const std::vector<fs::path>& dirs,
+                             const fs::path& imagePath)
+{
+    int fd = open(imagePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return std::nullopt;
+    }
+    pldm::utils::CustomFD imageFd(fd);
+
+    struct stat sb;
+    if (fstat(imageFd(), &sb) < 0 ||
+        static_cast<size_t>(sb.st_size) < sizeof(ImageHeader))
+    {
+        error("Invalid PDR image '{PATH}'", "PATH", imagePath);
+        return std::nullopt;
+    }
+    size_t imageSize = sb.st_size;
+
+    auto mapped = mmap(nullptr, imageSize, PROT_READ, MAP_PRIVATE, imageFd(),
+                       0);
+    if (mapped == MAP_FAILED)
+    {
+        error("Failed to mmap PDR image '{PATH}', error number - {ERROR_NUM}",
+              "PATH", imagePath, "ERROR_NUM", errno);
+        return std::nullopt;
+    }
+    auto mmapCleanup = [imageSize](void* image) { munmap(image, imageSize); };
+    std::unique_ptr<void, decltype(mmapCleanup)> imagePtr(mapped, mmapCleanup);
+    auto image = static_cast<const uint8_t*>(imagePtr.get());
+
+    ImageHeader header{};
+    memcpy(&header, image, sizeof(header));
+    if (header.magic != imageMagic || header.version != imageVersion)
+    {
+        info("Ignoring PDR image '{PATH}' with version {VERSION}", "PATH",
+             imagePath, "VERSION", header.version);
+        return std::nullopt;
+    }
+
+    // The sizes are checked one at a time, so that a damaged header cannot
+    // wrap their sum around to the size of the image
+    auto bodySize = imageSize - sizeof(header);
+    if (header.manifestSize > bodySize ||
+        header.payloadSize != bodySize - header.manifestSize)
+    {
+        error("Invalid manifest and payload sizes in PDR image '{PATH}'",
+              "PATH", imagePath);
+        return std::nullopt;
+    }
+
+    auto body = image + sizeof(header);
+    if (pldm::utils::calcCrc32(body, bodySize) != header.checksum)
+    {
+        error("Checksum mismatch in PDR image '{PATH}'", "PATH", imagePath);
+        return std::nullopt;
+    }
+
+    try
+    {
+        auto manifest = Json::from_cbor(body, body + header.manifestSize);
+        if (manifest != getManifest(dirs))
+        {
+            info("PDR image '{PATH}' is stale, PDR JSON files have changed",
+                 "PATH", imagePath);
+            return std::nullopt;
+        }
+
+        auto payload = Json::from_cbor(body + header.manifestSize,
+                                       body + bodySize);
+        if (!payload.is_array() || payload.size() != manifest.size())
+        {
+            error("Malformed payload in PDR image '{PATH}'", "PATH",
+                  imagePath);
+            return std::nullopt;
+        }
+        return payload.get<PdrJsons>();
+    }
+    catch (const Json::exception& e)
+    {
+        error("Failed to decode PDR image '{PATH}', error - {ERROR}", "PATH",
+              imagePath, "ERROR", e);
+    }
+
+    return std::nullopt;
+}
+
+} // namespace pdr_image
+} // namespace responder
+} // namespace pldm
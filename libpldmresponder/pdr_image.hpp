@@ -0,0 +1,90 @@
+#pragma once
+
+#include "libpldmresponder/pdr_utils.hpp"
+
+#include <stdint.h>
+
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace pldm
+{
+namespace responder
+{
+namespace pdr_image
+{
+namespace fs = std::filesystem;
+using Json = nlohmann::json;
+using PdrJsons = std::vector<Json>;
+
+/** @brief Version of the compiled PDR image layout, bump this whenever the
+ *         header or the encoding of the manifest/payload changes so that an
+ *         image written by an older pldmd is treated as stale.
+ */
+constexpr uint32_t imageVersion = 1;
+
+/** @struct ImageHeader
+ *
+ *  Fixed size header at the start of a compiled PDR image. It is followed by
+ *  the CBOR encoded manifest of the PDR JSON files the image was compiled
+ *  from, and then the CBOR encoded array of those PDR JSON documents.
+ */
+struct ImageHeader
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t manifestSize;
+    uint64_t payloadSize;
+    uint32_t checksum; //!< crc32 of the manifest and the payload
+};
+
+/** @brief Build the manifest of the PDR JSON files in the directories, which
+ *         captures the path, size and modification time of every file. The
+ *         manifest lists the files in the order the PDRs are generated.
+ *
+ *  @param[in] dirs - directories housing platform specific PDR JSON files
+ *
+ *  @return Json - array describing each PDR JSON file
+ */
+Json getManifest(const std::vector<fs::path>& dirs);
+
+/** @brief Parse the PDR JSON files in the directories and write them out as a
+ *         compiled PDR image.
+ *
+ *  @param[in] dirs - directories housing platform specific PDR JSON files
+ *  @param[in] imagePath - path of the compiled PDR image
+ *
+ *  @return bool - true if the image was written
+ */
+bool compile(const std::vector<fs::path>& dirs, const fs::path& imagePath);
+
+/** @brief Write the already parsed PDR JSON documents as a compiled PDR image.
+ *         The image is written to a temporary file and renamed in place, so a
+ *         crash never leaves a partially written image behind.
+ *
+ *  @param[in] manifest - manifest of the PDR JSON files, see getManifest()
+ *  @param[in] pdrJsons - the parsed PDR JSON documents, in manifest order
+ *  @param[in] imagePath - path of the compiled PDR image
+ *
+ *  @return bool - true if the image was written
+ */
+bool write(const Json& manifest, const PdrJsons& pdrJsons,
+           const fs::path& imagePath);
+
+/** @brief Map the compiled PDR image and load the PDR JSON documents from it.
+ *
+ *  @param[in] dirs - directories housing platform specific PDR JSON files
+ *  @param[in] imagePath - path of the compiled PDR image
+ *
+ *  @return PdrJsons - the PDR JSON documents, std::nullopt if the image does
+ *          not exist, is corrupt or is stale with respect to the PDR JSON
+ *          files in dirs
+ */
+std::optional<PdrJsons> load(const std::vector<fs::path>& dirs,
+                             const fs::path& imagePath);
+
+} // namespace pdr_image
+} // namespace responder
+} // namespace pldm
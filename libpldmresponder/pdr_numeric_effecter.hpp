@@ -208,8 +208,7 @@ void generateNumericEffecterPDR(const DBusInterface& dBusIntf, const Json& json,
         pldm::utils::DBusMapping dbusMapping{};
         try
         {
-            auto service = dBusIntf.getService(objectPath.c_str(),
-                                               interface.c_str());
+            handler.checkDbusObject(dBusIntf, objectPath, interface);
 
             dbusMapping = pldm::utils::DBusMapping{objectPath, interface,
                                                    propertyName, propertyType};
@@ -4,6 +4,7 @@
 #include "common/utils.hpp"
 #include "event_parser.hpp"
 #include "pdr.hpp"
+#include "pdr_image.hpp"
 #include "pdr_numeric_effecter.hpp"
 #include "pdr_state_effecter.hpp"
 #include "pdr_state_sensor.hpp"
@@ -20,6 +21,9 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
+#include <iterator>
+
 PHOSPHOR_LOG2_USING;
 
 using namespace pldm::utils;
@@ -67,16 +71,234 @@ const std::tuple<pdr_utils::DbusMappings, pdr_utils::DbusValMaps>&
 
 void Handler::generate(const pldm::utils::DBusHandler& dBusIntf,
                        const std::vector<fs::path>& dir, Repo& repo)
+{
+    if (!startGenerate(dir))
+    {
+        return;
+    }
+
+    while (generateNext(dBusIntf, repo))
+    {}
+}
+
+bool Handler::startGenerate(const std::vector<fs::path>& dir)
 {
     for (const auto& directory : dir)
     {
         info("checking if : {DIR} exists", "DIR", directory);
         if (!fs::exists(directory))
         {
-            return;
+            return false;
         }
     }
 
+    PDRGeneration generation{};
+    generation.dirs = dir;
+
+    // Use the compiled PDR image when it is up to date with the PDR JSON
+    // files, which saves parsing every JSON file.
+    if (!pdrImagePath.empty())
+    {
+        auto pdrJsons = pdr_image::load(dir, pdrImagePath);
+        if (pdrJsons.has_value())
+        {
+            generation.fromImage = true;
+            generation.pdrJsons = std::move(*pdrJsons);
+        }
+    }
+
+    if (!generation.fromImage)
+    {
+        for (const auto& directory : dir)
+        {
+            for (const auto& dirEntry : fs::directory_iterator(directory))
+            {
+                generation.files.emplace_back(dirEntry.path());
+            }
+        }
+    }
+
+    pdrGeneration = std::move(generation);
+    return true;
+}
+
+bool Handler::generateNext(const pldm::utils::DBusHandler& dBusIntf,
+                           Repo& repo)
+{
+    if (!pdrGeneration)
+    {
+        return false;
+    }
+
+    auto& generation = *pdrGeneration;
+    auto start = std::chrono::steady_clock::now();
+    Type pdrType{};
+    if (generation.fromImage &&
+        generation.next < generation.pdrJsons.size())
+    {
+        try
+        {
+            const auto& json = generation.pdrJsons[generation.next++];
+            resolveDbusObjects(dBusIntf, json);
+            generatePDRs(dBusIntf, json, repo, pdrType);
+        }
+        catch (const std::exception& e)
+        {
+            error(
+                "Failed generating '{TYPE}' pdr from PDR image '{PATH}': {ERROR}",
+                "TYPE", pdrType, "PATH", pdrImagePath, "ERROR", e);
+        }
+        generation.elapsed += std::chrono::steady_clock::now() - start;
+        return true;
+    }
+
+    if (!generation.fromImage && generation.next < generation.files.size())
+    {
+        const auto& path = generation.files[generation.next++];
+        try
+        {
+            if (fs::is_regular_file(path.string()))
+            {
+                auto json = readJson(path.string());
+                if (!pdrImagePath.empty())
+                {
+                    generation.pdrJsons.emplace_back(json);
+                }
+                if (!json.empty())
+                {
+                    resolveDbusObjects(dBusIntf, json);
+                    generatePDRs(dBusIntf, json, repo, pdrType);
+                }
+            }
+        }
+        catch (const InternalFailure& e)
+        {
+            generation.parsed = false;
+            error(
+                "PDR config directory '{PATH}' does not exist or empty for '{TYPE}' pdr: {ERROR}",
+                "TYPE", pdrType, "PATH", path, "ERROR", e);
+        }
+        catch (const Json::exception& e)
+        {
+            generation.parsed = false;
+            error("Failed parsing PDR JSON file for '{TYPE}' pdr: {ERROR}",
+                  "TYPE", pdrType, "ERROR", e);
+            pldm::utils::reportError(
+                "xyz.openbmc_project.PLDM.Error.Generate.PDRJsonFileParseFail");
+        }
+        catch (const std::exception& e)
+        {
+            generation.parsed = false;
+            error("Failed parsing PDR JSON file for '{TYPE}' pdr: {ERROR}",
+                  "TYPE", pdrType, "ERROR", e);
+            pldm::utils::reportError(
+                "xyz.openbmc_project.PLDM.Error.Generate.PDRJsonFileParseFail");
+        }
+        generation.elapsed += std::chrono::steady_clock::now() - start;
+        return true;
+    }
+
+    // Compile the PDR image on first boot, or after the PDR JSON files have
+    // changed. Malformed JSON files are not compiled so that the errors are
+    // reported again on the next boot.
+    if (!generation.fromImage && !pdrImagePath.empty() && generation.parsed)
+    {
+        auto manifest = pdr_image::getManifest(generation.dirs);
+        if (generation.pdrJsons.size() == manifest.size())
+        {
+            pdr_image::write(manifest, generation.pdrJsons, pdrImagePath);
+        }
+    }
+
+    info(
+        "Generated PDRs from {COUNT} PDR JSON documents in {DURATION_MS} ms with {LOOKUPS} mapper lookups",
+        "COUNT", generation.next, "DURATION_MS",
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            generation.elapsed)
+            .count(),
+        "LOOKUPS", generation.mapperLookups);
+
+    pdrGeneration.reset();
+    return false;
+}
+
+/** @brief Collect the D-Bus interfaces of the "dbus" objects in a PDR JSON
+ *
+ *  @param[in] json - the PDR JSON, or a part of it
+ *  @param[out] interfaces - the D-Bus interfaces referred to by the JSON
+ */
+static void collectDbusInterfaces(const Json& json,
+                                  std::set<std::string>& interfaces)
+{
+    if (json.is_array())
+    {
+        for (const auto& item : json)
+        {
+            collectDbusInterfaces(item, interfaces);
+        }
+    }
+    else if (json.is_object())
+    {
+        for (const auto& [key, value] : json.items())
+        {
+            if (key == "dbus" && value.is_object())
+            {
+                auto interface = value.value("interface", "");
+                if (!interface.empty())
+                {
+                    interfaces.emplace(std::move(interface));
+                }
+            }
+            else
+            {
+                collectDbusInterfaces(value, interfaces);
+            }
+        }
+    }
+}
+
+void Handler::resolveDbusObjects(const pldm::utils::DBusHandler& dBusIntf,
+                                 const Json& json)
+{
+    std::set<std::string> interfaces{};
+    collectDbusInterfaces(json, interfaces);
+    std::vector<std::string> lookup{};
+    std::ranges::copy_if(interfaces, std::back_inserter(lookup),
+                         [this](const auto& interface) {
+        return !pdrGeneration->resolvedInterfaces.contains(interface);
+    });
+    if (lookup.empty())
+    {
+        return;
+    }
+
+    pdrGeneration->mapperLookups++;
+    try
+    {
+        auto response = dBusIntf.getSubtree("/", 0, lookup);
+        for (const auto& [objectPath, serviceMap] : response)
+        {
+            auto& objectInterfaces = pdrGeneration->dbusObjects[objectPath];
+            for (const auto& [service, serviceInterfaces] : serviceMap)
+            {
+                objectInterfaces.insert(serviceInterfaces.begin(),
+                                        serviceInterfaces.end());
+            }
+        }
+        pdrGeneration->resolvedInterfaces.insert(lookup.begin(),
+                                                 lookup.end());
+    }
+    catch (const std::exception& e)
+    {
+        // The D-Bus objects are then looked up one by one
+        error("Failed to look up D-Bus objects for PDR generation: {ERROR}",
+              "ERROR", e);
+    }
+}
+
+void Handler::generatePDRs(const pldm::utils::DBusHandler& dBusIntf,
+                           const Json& json, Repo& repo, Type& pdrType)
+{
     // A map of PDR type to a lambda that handles creation of that PDR type.
     // The lambda essentially would parse the platform specific PDR JSONs to
     // generate the PDR structures. This function iterates through the map to
@@ -103,58 +325,180 @@ void Handler::generate(const pldm::utils::DBusHandler& dBusIntf,
                                                           repo);
     }}};
 
-    Type pdrType{};
-    for (const auto& directory : dir)
+    auto effecterPDRs = json.value("effecterPDRs", empty);
+    for (const auto& effecter : effecterPDRs)
+    {
+        pdrType = effecter.value("pdrType", 0);
+        generateHandlers.at(pdrType)(dBusIntf, effecter, repo);
+    }
+
+    auto sensorPDRs = json.value("sensorPDRs", empty);
+    for (const auto& sensor : sensorPDRs)
+    {
+        pdrType = sensor.value("pdrType", 0);
+        generateHandlers.at(pdrType)(dBusIntf, sensor, repo);
+    }
+}
+
+void Handler::prepareRepo()
+{
+    generateTerminusLocatorPDR(pdrRepo);
+    if (oemPlatformHandler != nullptr)
+    {
+        oemPlatformHandler->buildOEMPDR(pdrRepo);
+    }
+}
+
+bool Handler::addSystemPDRJsonsDir()
+{
+    if (!platformConfigHandler)
+    {
+        return true;
+    }
+
+    auto systemType = platformConfigHandler->getPlatformName();
+    if (!systemType.has_value())
+    {
+        return false;
+    }
+    pdrJsonsDir.push_back(pdrJsonDir / systemType.value());
+    return true;
+}
+
+void Handler::systemTypeAvailable(const std::string& systemType)
+{
+    if (!pdrConstructionEvent ||
+        constructionStage != ConstructionStage::SystemType)
+    {
+        return;
+    }
+
+    info("Resuming PDR construction for system type '{TYPE}'", "TYPE",
+         systemType);
+    pdrJsonsDir.push_back(pdrJsonDir / systemType);
+    constructionStage = ConstructionStage::PDRRepo;
+    pdrConstructionEvent->set_enabled(sdeventplus::source::Enabled::On);
+}
+
+void Handler::finishPDRCreation()
+{
+    pdrCreated = true;
+
+    if (dbusToPLDMEventHandler)
+    {
+        deferredGetPDREvent = std::make_unique<sdeventplus::source::Defer>(
+            event, std::bind(std::mem_fn(&pldm::responder::platform::Handler::
+                                             _processPostGetPDRActions),
+                             this, std::placeholders::_1));
+    }
+}
+
+void Handler::startPDRConstruction()
+{
+    if (pdrCreated || pdrConstructionEvent)
+    {
+        return;
+    }
+
+    constructionStage = ConstructionStage::FRUTable;
+    pdrConstructionEvent = std::make_unique<sdeventplus::source::Defer>(
+        event,
+        std::bind(std::mem_fn(&pldm::responder::platform::Handler::
+                                  _processPDRConstruction),
+                  this, std::placeholders::_1));
+    // Only run a slice when there are no other events pending, so that PLDM
+    // requests and D-Bus signals are served in between slices.
+    pdrConstructionEvent->set_priority(SD_EVENT_PRIORITY_IDLE);
+}
+
+void Handler::_processPDRConstruction(sdeventplus::source::EventBase&
+                                      /*source */)
+{
+    // Number of inventory objects processed for the FRU table in one slice
+    constexpr size_t inventoryObjectsPerSlice = 8;
+
+    try
     {
-        for (const auto& dirEntry : fs::directory_iterator(directory))
+        switch (constructionStage)
         {
-            try
-            {
-                if (fs::is_regular_file(dirEntry.path().string()))
+            case ConstructionStage::FRUTable:
+                if (fruHandler)
                 {
-                    auto json = readJson(dirEntry.path().string());
-                    if (!json.empty())
-                    {
-                        auto effecterPDRs = json.value("effecterPDRs", empty);
-                        for (const auto& effecter : effecterPDRs)
-                        {
-                            pdrType = effecter.value("pdrType", 0);
-                            generateHandlers.at(pdrType)(dBusIntf, effecter,
-                                                         repo);
-                        }
-
-                        auto sensorPDRs = json.value("sensorPDRs", empty);
-                        for (const auto& sensor : sensorPDRs)
-                        {
-                            pdrType = sensor.value("pdrType", 0);
-                            generateHandlers.at(pdrType)(dBusIntf, sensor,
-                                                         repo);
-                        }
-                    }
+                    fruHandler->startFRUTableBuild();
                 }
-            }
-            catch (const InternalFailure& e)
-            {
-                error(
-                    "PDR config directory '{PATH}' does not exist or empty for '{TYPE}' pdr: {ERROR}",
-                    "TYPE", pdrType, "PATH", dirEntry.path(), "ERROR", e);
-            }
-            catch (const Json::exception& e)
-            {
-                error("Failed parsing PDR JSON file for '{TYPE}' pdr: {ERROR}",
-                      "TYPE", pdrType, "ERROR", e);
-                pldm::utils::reportError(
-                    "xyz.openbmc_project.PLDM.Error.Generate.PDRJsonFileParseFail");
-            }
-            catch (const std::exception& e)
-            {
-                error("Failed parsing PDR JSON file for '{TYPE}' pdr: {ERROR}",
-                      "TYPE", pdrType, "ERROR", e);
-                pldm::utils::reportError(
-                    "xyz.openbmc_project.PLDM.Error.Generate.PDRJsonFileParseFail");
-            }
+                constructionStage = ConstructionStage::FRURecords;
+                break;
+            case ConstructionStage::FRURecords:
+                if (!fruHandler ||
+                    fruHandler->buildFRUTableSlice(inventoryObjectsPerSlice))
+                {
+                    constructionStage = ConstructionStage::SystemType;
+                }
+                break;
+            case ConstructionStage::SystemType:
+                // In case of normal poweron, the system type would have been
+                // already filled by entity manager when ever BMC reaches
+                // Ready state. Otherwise the construction waits for entity
+                // manager to publish it, or for the first GetPDR request.
+                if (addSystemPDRJsonsDir())
+                {
+                    constructionStage = ConstructionStage::PDRRepo;
+                    break;
+                }
+                if (!systemTypeCallbackRegistered)
+                {
+                    platformConfigHandler->registerSystemTypeCallback(
+                        [this](const std::string& systemType, bool) {
+                            systemTypeAvailable(systemType);
+                        });
+                    systemTypeCallbackRegistered = true;
+                }
+                info("Waiting for the system type to construct the PDRs");
+                pdrConstructionEvent->set_enabled(
+                    sdeventplus::source::Enabled::Off);
+                break;
+            case ConstructionStage::PDRRepo:
+                prepareRepo();
+                constructionStage = startGenerate(pdrJsonsDir)
+                                        ? ConstructionStage::PDRJsons
+                                        : ConstructionStage::Done;
+                break;
+            case ConstructionStage::PDRJsons:
+                if (!generateNext(*dBusIntf, pdrRepo))
+                {
+                    constructionStage = ConstructionStage::Done;
+                }
+                break;
+            case ConstructionStage::Done:
+                break;
         }
     }
+    catch (const std::exception& e)
+    {
+        error("Failed to construct PDR repository at stage {STAGE}: {ERROR}",
+              "STAGE", static_cast<int>(constructionStage), "ERROR", e);
+        switch (constructionStage)
+        {
+            case ConstructionStage::FRUTable:
+            case ConstructionStage::FRURecords:
+                constructionStage = ConstructionStage::SystemType;
+                break;
+            case ConstructionStage::SystemType:
+                constructionStage = ConstructionStage::PDRRepo;
+                break;
+            default:
+                constructionStage = ConstructionStage::Done;
+                break;
+        }
+    }
+
+    if (constructionStage == ConstructionStage::Done)
+    {
+        info("PDR repository constructed with {COUNT} records", "COUNT",
+             pdrRepo.getRecordCount());
+        finishPDRCreation();
+        pdrConstructionEvent.reset();
+    }
 }
 
 Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
@@ -171,6 +515,23 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
         }
     }
 
+    // PDRs are being constructed in the background, ask the requester to
+    // retry instead of blocking the event loop to complete the construction.
+    if (pdrConstructionEvent)
+    {
+        if (constructionStage == ConstructionStage::SystemType)
+        {
+            // The system type is not filled by time we get a getpdr
+            // request, we can assume that the entity manager service is not
+            // present on this system & continue to build the common PDR's.
+            info("No system type, constructing the common PDRs");
+            constructionStage = ConstructionStage::PDRRepo;
+            pdrConstructionEvent->set_enabled(
+                sdeventplus::source::Enabled::On);
+        }
+        return ccOnlyResponse(request, PLDM_ERROR_NOT_READY);
+    }
+
     // Build FRU table if not built, since entity association PDR's
     // are built when the FRU table is constructed.
     if (fruHandler)
@@ -180,37 +541,10 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
 
     if (!pdrCreated)
     {
-        generateTerminusLocatorPDR(pdrRepo);
-        if (platformConfigHandler)
-        {
-            auto systemType = platformConfigHandler->getPlatformName();
-            if (systemType.has_value())
-            {
-                // In case of normal poweron , the system type would have been
-                // already filled by entity manager when ever BMC reaches Ready
-                // state. If this is not filled by time we get a getpdr request
-                // we can assume that the entity manager service is not present
-                // on this system & continue to build the common PDR's.
-                pdrJsonsDir.push_back(pdrJsonDir / systemType.value());
-            }
-        }
-
-        if (oemPlatformHandler != nullptr)
-        {
-            oemPlatformHandler->buildOEMPDR(pdrRepo);
-        }
+        addSystemPDRJsonsDir();
+        prepareRepo();
         generate(*dBusIntf, pdrJsonsDir, pdrRepo);
-
-        pdrCreated = true;
-
-        if (dbusToPLDMEventHandler)
-        {
-            deferredGetPDREvent = std::make_unique<sdeventplus::source::Defer>(
-                event,
-                std::bind(std::mem_fn(&pldm::responder::platform::Handler::
-                                          _processPostGetPDRActions),
-                          this, std::placeholders::_1));
-        }
+        finishPDRCreation();
     }
 
     Response response(sizeof(pldm_msg_hdr) + PLDM_GET_PDR_MIN_RESP_BYTES, 0);
@@ -6,6 +6,7 @@
 #include "host-bmc/dbus_to_event_handler.hpp"
 #include "host-bmc/host_pdr_handler.hpp"
 #include "libpldmresponder/pdr.hpp"
+#include "libpldmresponder/pdr_image.hpp"
 #include "libpldmresponder/pdr_utils.hpp"
 #include "libpldmresponder/platform_config.hpp"
 #include "oem_handler.hpp"
@@ -18,7 +19,9 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <chrono>
 #include <map>
+#include <set>
 
 PHOSPHOR_LOG2_USING;
 
@@ -198,6 +201,26 @@ class Handler : public CmdHandler
                   const std::vector<fs::path>& dir,
                   pldm::responder::pdr_utils::Repo& repo);
 
+    /** @brief Set the path of the compiled PDR image. When set, generate()
+     *         loads the PDR JSONs from the image if it is up to date, and
+     *         (re)compiles the image from the PDR JSON files otherwise.
+     *
+     *  @param[in] path - path of the compiled PDR image
+     */
+    void setPDRImagePath(const fs::path& path)
+    {
+        pdrImagePath = path;
+    }
+
+    /** @brief Start constructing the FRU table and the PDR repository in the
+     *         background. The construction is split into small slices that
+     *         are run from an idle priority event source, so the event loop
+     *         keeps serving other requests. GetPDR requests received before
+     *         the construction completes are answered with
+     *         PLDM_ERROR_NOT_READY.
+     */
+    void startPDRConstruction();
+
     /** @brief Parse PDR JSONs and build state effecter PDR repository
      *
      *  @param[in] json - platform specific PDR JSON files
@@ -206,6 +229,36 @@ class Handler : public CmdHandler
     void generateStateEffecterRepo(const pldm::utils::Json& json,
                                    pldm::responder::pdr_utils::Repo& repo);
 
+    /** @brief Check that the D-Bus object implementing the interface exists,
+     *         before creating a PDR for it. The D-Bus objects are looked up
+     *         from the mapper in bulk for every PDR JSON document, the mapper
+     *         is only asked for an individual object missing from that lookup.
+     *
+     *  @param[in] dBusIntf - The interface object
+     *  @param[in] path - D-Bus object path
+     *  @param[in] interface - D-Bus interface
+     *
+     *  @throw std::exception when the D-Bus object does not exist
+     */
+    template <class DBusInterface>
+    void checkDbusObject(const DBusInterface& dBusIntf,
+                         const std::string& path,
+                         const std::string& interface)
+    {
+        if (pdrGeneration)
+        {
+            auto it = pdrGeneration->dbusObjects.find(path);
+            if (it != pdrGeneration->dbusObjects.end() &&
+                it->second.contains(interface))
+            {
+                return;
+            }
+            pdrGeneration->mapperLookups++;
+        }
+
+        dBusIntf.getService(path.c_str(), interface.c_str());
+    }
+
     /** @brief map of PLDM event type to EventHandlers
      *
      */
@@ -490,6 +543,111 @@ class Handler : public CmdHandler
     void setEventReceiver();
 
   private:
+    /** @struct PDRGeneration
+     *
+     *  State of the PDR generation from the PDR JSONs, which is done one JSON
+     *  document at a time.
+     */
+    struct PDRGeneration
+    {
+        std::vector<fs::path> dirs{};
+        std::vector<fs::path> files{}; //!< PDR JSON files to be parsed
+        pdr_image::PdrJsons pdrJsons{};
+        bool fromImage = false; //!< pdrJsons were loaded from the PDR image
+        bool parsed = true;     //!< all PDR JSON files parsed without errors
+        size_t next = 0;
+
+        /** @brief D-Bus objects and their interfaces, from the bulk lookups
+         */
+        std::map<std::string, std::set<std::string>> dbusObjects{};
+        std::set<std::string> resolvedInterfaces{}; //!< interfaces looked up
+        size_t mapperLookups = 0;                   //!< mapper calls made
+        std::chrono::steady_clock::duration elapsed{};
+    };
+
+    /** @brief Stages of the background PDR construction */
+    enum class ConstructionStage
+    {
+        FRUTable,
+        FRURecords,
+        SystemType,
+        PDRRepo,
+        PDRJsons,
+        Done
+    };
+
+    /** @brief Start generating the PDRs from the PDR JSONs, by loading the
+     *         PDR image or listing the PDR JSON files
+     *
+     *  @param[in] dir - directories housing platform specific PDR JSON files
+     *
+     *  @return true if the generation was started
+     */
+    bool startGenerate(const std::vector<fs::path>& dir);
+
+    /** @brief Generate the PDRs from the next PDR JSON document
+     *
+     *  @param[in] dBusIntf - The interface object
+     *  @param[in] repo - instance of concrete implementation of Repo
+     *
+     *  @return true if there are more PDR JSON documents to process
+     */
+    bool generateNext(const pldm::utils::DBusHandler& dBusIntf,
+                      pldm::responder::pdr_utils::Repo& repo);
+
+    /** @brief Look up from the mapper, with a single GetSubTree call, the
+     *         D-Bus objects implementing the interfaces referred to by a PDR
+     *         JSON document which were not looked up already.
+     *
+     *  @param[in] dBusIntf - The interface object
+     *  @param[in] json - the PDR JSON document
+     */
+    void resolveDbusObjects(const pldm::utils::DBusHandler& dBusIntf,
+                            const pldm::utils::Json& json);
+
+    /** @brief Generate the effecter and sensor PDRs in a PDR JSON document
+     *
+     *  @param[in] dBusIntf - The interface object
+     *  @param[in] json - the PDR JSON document
+     *  @param[in] repo - instance of concrete implementation of Repo
+     *  @param[out] pdrType - the type of the PDR being generated
+     */
+    void generatePDRs(const pldm::utils::DBusHandler& dBusIntf,
+                      const pldm::utils::Json& json,
+                      pldm::responder::pdr_utils::Repo& repo,
+                      pdr_utils::Type& pdrType);
+
+    /** @brief Add the terminus locator and the OEM PDRs, ahead of
+     *         generating the PDRs from the PDR JSONs
+     */
+    void prepareRepo();
+
+    /** @brief Add the system specific PDR JSON directory, if the system type
+     *         is known
+     *
+     *  @return false if the system type is not yet published by entity
+     *          manager
+     */
+    bool addSystemPDRJsonsDir();
+
+    /** @brief Resume the background PDR construction waiting for the system
+     *         type
+     *
+     *  @param[in] systemType - the system type published by entity manager
+     */
+    void systemTypeAvailable(const std::string& systemType);
+
+    /** @brief Mark the PDR repository as created and schedule the actions
+     *         that follow the PDR creation
+     */
+    void finishPDRCreation();
+
+    /** @brief Run one slice of the background PDR construction
+     *
+     *  @param[in] source - sdeventplus event source
+     */
+    void _processPDRConstruction(sdeventplus::source::EventBase& source);
+
     uint8_t eid;
     InstanceIdDb* instanceIdDb;
     pdr_utils::Repo pdrRepo;
@@ -508,6 +666,11 @@ class Handler : public CmdHandler
     fs::path pdrJsonDir;
     bool pdrCreated;
     std::vector<fs::path> pdrJsonsDir;
+    fs::path pdrImagePath{};
+    std::optional<PDRGeneration> pdrGeneration{};
+    ConstructionStage constructionStage = ConstructionStage::FRUTable;
+    std::unique_ptr<sdeventplus::source::Defer> pdrConstructionEvent;
+    bool systemTypeCallbackRegistered = false;
     std::unique_ptr<sdeventplus::source::Defer> deferredGetPDREvent;
 };
 
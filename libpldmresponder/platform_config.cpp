@@ -35,14 +35,13 @@ void Handler::systemCompatibleCallback(sdbusplus::message_t& msg)
     auto names =
         std::get<pldm::utils::Interfaces>(properties.at(namesProperty));
 
-    std::string systemType;
     if (!names.empty())
     {
         // get only the first system type
         systemType = names.front();
-        if (sysTypeCallback)
+        for (const auto& callback : sysTypeCallbacks)
         {
-            sysTypeCallback(systemType, true);
+            callback(systemType, true);
         }
     }
 
@@ -125,7 +124,7 @@ std::optional<std::filesystem::path> Handler::getPlatformName()
 
 void Handler::registerSystemTypeCallback(SystemTypeCallback callback)
 {
-    sysTypeCallback = callback;
+    sysTypeCallbacks.emplace_back(std::move(callback));
 }
 
 } // namespace platform_config
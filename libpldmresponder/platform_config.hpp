@@ -34,7 +34,6 @@ class Handler : public CmdHandler
                         "xyz.openbmc_project.EntityManager"),
                 std::bind(&Handler::systemCompatibleCallback, this,
                           std::placeholders::_1));
-        sysTypeCallback = nullptr;
     }
 
     /** @brief Interface to get the system type information using Dbus query
@@ -46,7 +45,9 @@ class Handler : public CmdHandler
     /** @brief D-Bus Interface added signal match for Entity Manager */
     void systemCompatibleCallback(sdbusplus::message_t& msg);
 
-    /** @brief Registers the callback from other objects */
+    /** @brief Registers a callback from other objects, called once the
+     *         system type is published by Entity Manager
+     */
     void registerSystemTypeCallback(SystemTypeCallback callback);
 
   private:
@@ -56,8 +57,8 @@ class Handler : public CmdHandler
     /** @brief D-Bus Interface added signal match for Entity Manager */
     std::unique_ptr<sdbusplus::bus::match_t> systemCompatibleMatchCallBack;
 
-    /** @brief Registered Callback */
-    SystemTypeCallback sysTypeCallback;
+    /** @brief Registered callbacks */
+    std::vector<SystemTypeCallback> sysTypeCallbacks;
 };
 
 } // namespace platform_config
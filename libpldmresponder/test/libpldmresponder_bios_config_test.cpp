@@ -7,6 +7,7 @@
 #include "mocked_bios.hpp"
 
 #include <nlohmann/json.hpp>
+#include <sdeventplus/event.hpp>
 
 #include <fstream>
 #include <memory>
@@ -281,6 +282,66 @@ TEST_F(TestBIOSConfig, setBIOSTable)
     EXPECT_TRUE(stringTable);
 }
 
+TEST_F(TestBIOSConfig, baseBIOSTableUnchanged)
+{
+    MockdBusHandler dbusHandler;
+    MockSystemConfig mockSystemConfig;
+
+    BIOSConfig biosConfig("./bios_jsons", tableDir.c_str(), &dbusHandler, 0, 0,
+                          nullptr, nullptr, &mockSystemConfig, []() {});
+
+    auto attrValueTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+    ASSERT_TRUE(attrValueTable);
+
+    auto before = biosConfig.getBaseBIOSTableStats();
+    auto rc = biosConfig.setBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE,
+                                      *attrValueTable);
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+
+    // Setting the same attribute values does not publish BaseBIOSTable
+    const auto& after = biosConfig.getBaseBIOSTableStats();
+    EXPECT_EQ(after.requests, before.requests + 1);
+    EXPECT_EQ(after.unchanged, before.unchanged + 1);
+    EXPECT_EQ(after.publications, before.publications);
+    EXPECT_GT(after.bytesSaved(), before.bytesSaved());
+}
+
+TEST_F(TestBIOSConfig, persistTables)
+{
+    MockdBusHandler dbusHandler;
+    MockSystemConfig mockSystemConfig;
+
+    BIOSConfig biosConfig("./", tableDir.c_str(), &dbusHandler, 0, 0, nullptr,
+                          nullptr, &mockSystemConfig, []() {});
+
+    Table table;
+    table::string::constructEntry(table, "pvm_system_name");
+    table::appendPadAndChecksum(table);
+    Table otherTable;
+    table::string::constructEntry(otherTable, "fw_boot_side");
+    table::appendPadAndChecksum(otherTable);
+
+    auto rc = biosConfig.setBIOSTable(PLDM_BIOS_STRING_TABLE, table);
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+    rc = biosConfig.setBIOSTable(PLDM_BIOS_STRING_TABLE, otherTable);
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+
+    // The table is served from memory, and persisted from the event loop
+    auto stringTable = biosConfig.getBIOSTable(PLDM_BIOS_STRING_TABLE);
+    ASSERT_TRUE(stringTable);
+    EXPECT_EQ(*stringTable, otherTable);
+    BIOSTable persisted((tableDir / "stringTable").c_str());
+    EXPECT_TRUE(persisted.isEmpty());
+
+    auto event = sdeventplus::Event::get_default();
+    event.run(std::chrono::microseconds{0});
+
+    ASSERT_FALSE(persisted.isEmpty());
+    Table persistedTable;
+    persisted.load(persistedTable);
+    EXPECT_EQ(persistedTable, otherTable);
+}
+
 TEST_F(TestBIOSConfig, getBIOSTableFailure)
 {
     MockdBusHandler dbusHandler;
@@ -393,3 +454,74 @@ TEST_F(TestBIOSConfig, setAttrValue)
     EXPECT_THAT(std::vector<uint8_t>(p, p + attrValueEntry.size()),
                 ElementsAreArray(attrValueEntry));
 }
+
+TEST_F(TestBIOSConfig, setAttrValues)
+{
+    MockdBusHandler dbusHandler;
+    MockSystemConfig mockSystemConfig;
+
+    BIOSConfig biosConfig("./bios_jsons", tableDir.c_str(), &dbusHandler, 0, 0,
+                          nullptr, nullptr, &mockSystemConfig, []() {});
+
+    auto stringTable = biosConfig.getBIOSTable(PLDM_BIOS_STRING_TABLE);
+    auto attrTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_TABLE);
+
+    BIOSStringTable biosStringTable(*stringTable);
+    auto stringHandle = biosStringTable.findHandle("str_example1");
+    uint16_t attrHandle{};
+
+    for (auto entry : BIOSTableIter<PLDM_BIOS_ATTR_TABLE>(attrTable->data(),
+                                                          attrTable->size()))
+    {
+        auto header = table::attribute::decodeHeader(entry);
+        if (header.stringHandle == stringHandle)
+        {
+            attrHandle = header.attrHandle;
+            break;
+        }
+    }
+
+    EXPECT_NE(attrHandle, 0);
+
+    Table attrValueEntry{
+        0,   0,             /* attr handle */
+        1,                  /* attr type string read-write */
+        4,   0,             /* current string length */
+        'a', 'b', 'c', 'd', /* defaut value string handle index */
+    };
+    attrValueEntry[0] = attrHandle & 0xff;
+    attrValueEntry[1] = (attrHandle >> 8) & 0xff;
+
+    // An entry for an attribute handle which does not exist
+    Table unknownEntry = attrValueEntry;
+    unknownEntry[0] = 0xff;
+    unknownEntry[1] = 0xff;
+
+    DBusMapping dbusMapping{"/xyz/abc/def",
+                            "xyz.openbmc_project.str_example1.value",
+                            "Str_example1", "string"};
+    PropertyValue value = std::string("abcd");
+    EXPECT_CALL(dbusHandler, setDbusProperty(dbusMapping, value)).Times(1);
+
+    auto rc = biosConfig.setAttrValues({unknownEntry, attrValueEntry}, false);
+    EXPECT_EQ(rc, PLDM_ERROR);
+
+    // The valid entry is still applied to the attribute value table
+    auto attrValueTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+    const pldm_bios_attr_val_table_entry* entry = nullptr;
+    for (auto valueEntry : BIOSTableIter<PLDM_BIOS_ATTR_VAL_TABLE>(
+             attrValueTable->data(), attrValueTable->size()))
+    {
+        auto header = table::attribute_value::decodeHeader(valueEntry);
+        if (header.attrHandle == attrHandle)
+        {
+            entry = valueEntry;
+            break;
+        }
+    }
+    ASSERT_NE(entry, nullptr);
+
+    auto p = reinterpret_cast<const uint8_t*>(entry);
+    EXPECT_THAT(std::vector<uint8_t>(p, p + attrValueEntry.size()),
+                ElementsAreArray(attrValueEntry));
+}
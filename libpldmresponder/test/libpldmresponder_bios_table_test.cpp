@@ -59,3 +59,31 @@ TEST_F(TestBIOSTable, testLoadOntoExisting)
     ASSERT_EQ(out[0], 99);
     ASSERT_EQ(out[1], 99);
 }
+
+TEST(BIOSStringTable, testFindByIndex)
+{
+    Table table;
+    std::vector<std::string> strings{"pvm_system_name", "pvm_stop_at_standby",
+                                     "fw_boot_side", "fw_next_boot_side"};
+    std::vector<uint16_t> handles{};
+    for (const auto& str : strings)
+    {
+        auto entry = table::string::constructEntry(table, str);
+        handles.push_back(table::string::decodeHandle(entry));
+    }
+    table::appendPadAndChecksum(table);
+
+    BIOSStringTable stringTable(table);
+    for (size_t i = 0; i < strings.size(); i++)
+    {
+        EXPECT_EQ(stringTable.findHandle(strings[i]), handles[i]);
+        EXPECT_EQ(stringTable.findString(handles[i]), strings[i]);
+        auto entry = stringTable.findEntry(handles[i]);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(table::string::decodeString(entry), strings[i]);
+    }
+
+    EXPECT_EQ(stringTable.findEntry(0xffff), nullptr);
+    EXPECT_THROW(stringTable.findString(0xffff), std::invalid_argument);
+    EXPECT_THROW(stringTable.findHandle("unknown"), std::invalid_argument);
+}
@@ -9,6 +9,9 @@
 #include <cstring>
 #include <ctime>
 #include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -17,6 +20,40 @@ using namespace pldm::responder;
 using namespace pldm::responder::bios;
 using namespace pldm::responder::utils;
 
+namespace fs = std::filesystem;
+
+namespace
+{
+
+Response setStringTablePart(bios::Handler& handler, uint32_t transferHandle,
+                            uint8_t transferFlag,
+                            std::span<const uint8_t> part)
+{
+    std::vector<uint8_t> request(
+        sizeof(pldm_msg_hdr) + PLDM_SET_BIOS_TABLE_MIN_REQ_BYTES + part.size());
+    auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+    auto payloadLength = request.size() - sizeof(pldm_msg_hdr);
+    auto rc = encode_set_bios_table_req(0, transferHandle, transferFlag,
+                                        PLDM_BIOS_STRING_TABLE, part.data(),
+                                        part.size(), requestMsg, payloadLength);
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+    return handler.setBIOSTable(1, requestMsg, payloadLength);
+}
+
+Response getStringTablePart(bios::Handler& handler, uint32_t transferHandle,
+                            uint8_t transferOpFlag)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_BIOS_TABLE_REQ_BYTES>
+        request{};
+    auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+    auto rc = encode_get_bios_table_req(0, transferHandle, transferOpFlag,
+                                        PLDM_BIOS_STRING_TABLE, requestMsg);
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+    return handler.getBIOSTable(1, requestMsg, PLDM_GET_BIOS_TABLE_REQ_BYTES);
+}
+
+} // namespace
+
 TEST(epochToBCDTime, testTime)
 {
     struct tm time
@@ -63,3 +100,135 @@ TEST(timeToEpoch, testTime0)
 
     EXPECT_EQ(ret, timeSec);
 }
+
+TEST(BIOSTableTransfer, multipartSetAndGet)
+{
+    char tmpdir[] = "/tmp/BIOSTables.XXXXXX";
+    fs::path tableDir(mkdtemp(tmpdir));
+    {
+        bios::Handler handler(0, 0, nullptr, nullptr, nullptr, []() {}, "./",
+                              tableDir.c_str());
+        constexpr size_t partSize = 64;
+        handler.setTransferSize(partSize);
+
+        Table table;
+        for (int i = 0; i < 20; i++)
+        {
+            table::string::constructEntry(table, "string" + std::to_string(i));
+        }
+        table::appendPadAndChecksum(table);
+        ASSERT_GT(table.size(), 3 * partSize);
+
+        // Set the table in parts, a part at the wrong handle is rejected
+        uint32_t transferHandle = 0;
+        while (transferHandle < table.size())
+        {
+            auto size = std::min(partSize, table.size() - transferHandle);
+            bool last = transferHandle + size == table.size();
+            uint8_t flag = last ? PLDM_END : PLDM_MIDDLE;
+            if (transferHandle == 0)
+            {
+                flag = PLDM_START;
+            }
+            std::span<const uint8_t> part(table.data() + transferHandle, size);
+            if (transferHandle != 0)
+            {
+                auto response = setStringTablePart(handler, transferHandle + 1,
+                                                   flag, part);
+                EXPECT_EQ(response[sizeof(pldm_msg_hdr)],
+                          PLDM_ERROR_INVALID_DATA);
+            }
+
+            auto response = setStringTablePart(handler, transferHandle, flag,
+                                               part);
+            uint8_t cc = 0;
+            uint32_t nextTransferHandle = 0;
+            ASSERT_EQ(decode_set_bios_table_resp(
+                          reinterpret_cast<pldm_msg*>(response.data()),
+                          response.size() - sizeof(pldm_msg_hdr), &cc,
+                          &nextTransferHandle),
+                      PLDM_SUCCESS);
+            ASSERT_EQ(cc, PLDM_SUCCESS);
+            transferHandle += size;
+            EXPECT_EQ(nextTransferHandle, last ? 0 : transferHandle);
+        }
+
+        // Get the table back in parts, a part at a handle that is not a part
+        // boundary is rejected
+        Response response;
+        Table received;
+        uint8_t transferOpFlag = PLDM_GET_FIRSTPART;
+        transferHandle = 0;
+        uint8_t transferFlag = 0;
+        do
+        {
+            response = getStringTablePart(handler, transferHandle,
+                                          transferOpFlag);
+            if (transferHandle != 0)
+            {
+                auto retry = getStringTablePart(handler, transferHandle + 1,
+                                                PLDM_GET_NEXTPART);
+                EXPECT_EQ(retry[sizeof(pldm_msg_hdr)], PLDM_ERROR_INVALID_DATA);
+            }
+
+            uint8_t cc = 0;
+            size_t offset = 0;
+            ASSERT_EQ(decode_get_bios_table_resp(
+                          reinterpret_cast<pldm_msg*>(response.data()),
+                          response.size() - sizeof(pldm_msg_hdr), &cc,
+                          &transferHandle, &transferFlag, &offset),
+                      PLDM_SUCCESS);
+            ASSERT_EQ(cc, PLDM_SUCCESS);
+            auto data = response.begin() + sizeof(pldm_msg_hdr) + offset;
+            EXPECT_LE(static_cast<size_t>(response.end() - data), partSize);
+            received.insert(received.end(), data, response.end());
+            if (transferOpFlag == PLDM_GET_FIRSTPART)
+            {
+                EXPECT_EQ(transferFlag, PLDM_START);
+            }
+            transferOpFlag = PLDM_GET_NEXTPART;
+        } while (transferFlag != PLDM_END);
+        EXPECT_EQ(received, table);
+
+        // Without a part size the table is sent in a single part
+        handler.setTransferSize(0);
+        response = getStringTablePart(handler, 0, PLDM_GET_FIRSTPART);
+        uint8_t cc = 0;
+        size_t offset = 0;
+        ASSERT_EQ(decode_get_bios_table_resp(
+                      reinterpret_cast<pldm_msg*>(response.data()),
+                      response.size() - sizeof(pldm_msg_hdr), &cc,
+                      &transferHandle, &transferFlag, &offset),
+                  PLDM_SUCCESS);
+        EXPECT_EQ(transferFlag, PLDM_START_AND_END);
+        EXPECT_EQ(transferHandle, 0);
+        EXPECT_EQ(response.size() - sizeof(pldm_msg_hdr) - offset,
+                  table.size());
+    }
+    fs::remove_all(tableDir);
+}
+
+TEST(BIOSTableTransfer, setTableSizeBound)
+{
+    char tmpdir[] = "/tmp/BIOSTables.XXXXXX";
+    fs::path tableDir(mkdtemp(tmpdir));
+    {
+        bios::Handler handler(0, 0, nullptr, nullptr, nullptr, []() {}, "./",
+                              tableDir.c_str());
+
+        // Without a string table, a transfer may reach 64 KiB
+        std::vector<uint8_t> part(60 * 1024);
+        auto response = setStringTablePart(handler, 0, PLDM_START, part);
+        EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_SUCCESS);
+
+        part.resize(10 * 1024);
+        response = setStringTablePart(handler, 60 * 1024, PLDM_MIDDLE, part);
+        EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_ERROR_INVALID_LENGTH);
+
+        // The rejected transfer is dropped
+        part.resize(1024);
+        response = setStringTablePart(handler, 60 * 1024, PLDM_MIDDLE, part);
+        EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_ERROR_INVALID_DATA);
+    }
+    fs::remove_all(tableDir);
+}
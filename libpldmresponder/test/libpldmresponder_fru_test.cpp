@@ -4,9 +4,12 @@
 
 #include <config.h>
 #include <libpldm/pdr.h>
+#include <libpldm/platform.h>
 
 #include <sdbusplus/message.hpp>
 
+#include <array>
+
 #include <gtest/gtest.h>
 
 TEST(FruParser, allScenarios)
@@ -182,3 +185,351 @@ TEST(FruImpl, entityByObjectPath)
     entityPtr = mockedFruHandler.getEntityByObjectPath(invalidIface);
     ASSERT_TRUE(!entityPtr);
 }
+
+TEST(FruImpl, inventoryChanges)
+{
+    using namespace pldm::responder::dbus;
+    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo(
+        pldm_pdr_init(), pldm_pdr_destroy);
+    std::unique_ptr<pldm_entity_association_tree,
+                    decltype(&pldm_entity_association_tree_destroy)>
+        entityTree(pldm_entity_association_tree_init(),
+                   pldm_entity_association_tree_destroy);
+    std::unique_ptr<pldm_entity_association_tree,
+                    decltype(&pldm_entity_association_tree_destroy)>
+        bmcEntityTree(pldm_entity_association_tree_init(),
+                      pldm_entity_association_tree_destroy);
+
+    constexpr auto itemIntf = "xyz.openbmc_project.Inventory.Item";
+    constexpr auto assetIntf = "xyz.openbmc_project.Inventory.Decorator.Asset";
+    const std::string board =
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard";
+    const std::string cpu0 = board + "/cpu0";
+    const std::string cpu1 = board + "/cpu1";
+    auto cpuInterfaces = [&](const std::string& serialNumber) {
+        return InterfaceMap{
+            {"xyz.openbmc_project.Inventory.Item.Cpu", {}},
+            {itemIntf, {{"Present", true}}},
+            {assetIntf,
+             {{"PartNumber", std::string("02CY211")},
+              {"SerialNumber", serialNumber}}}};
+    };
+
+    ObjectValueTree objects{
+        {sdbusplus::message::object_path(
+             "/xyz/openbmc_project/inventory/system"),
+         {{"xyz.openbmc_project.Inventory.Item.System", {}},
+          {itemIntf, {{"Present", true}}}}},
+        {sdbusplus::message::object_path(
+             "/xyz/openbmc_project/inventory/system/chassis"),
+         {{"xyz.openbmc_project.Inventory.Item.Chassis", {}},
+          {itemIntf, {{"Present", true}}}}},
+        {sdbusplus::message::object_path(board),
+         {{"xyz.openbmc_project.Inventory.Item.Board.Motherboard", {}},
+          {itemIntf, {{"Present", true}}}}},
+        {sdbusplus::message::object_path(cpu0), cpuInterfaces("YL10")}};
+
+    pldm::responder::FruImpl fruImpl(
+        "./fru_jsons/good", "./fru_jsons/fru_master/fru_master.json",
+        pdrRepo.get(), entityTree.get(), bmcEntityTree.get(), nullptr);
+
+    std::vector<std::pair<uint8_t, std::vector<uint32_t>>> pdrChanges;
+    fruImpl.setPDRChangeCallback(
+        [&pdrChanges](uint8_t operation, std::vector<uint32_t>&& handles) {
+        pdrChanges.emplace_back(operation, std::move(handles));
+    });
+    std::vector<const pldm_entity_node*> removedNodes;
+    fruImpl.setEntityRemovalCallback(
+        [&removedNodes](const pldm_entity_node* node) {
+        removedNodes.emplace_back(node);
+    });
+
+    fruImpl.startFRUTableBuild(std::move(objects));
+    fruImpl.buildFRUTable();
+    // The CPU item has two FRU records
+    ASSERT_EQ(fruImpl.numRSI(), 1);
+    ASSERT_EQ(fruImpl.numRecords(), 2);
+    auto tableSize = fruImpl.size();
+
+    // Add a FRU
+    fruImpl.interfacesAdded(cpu1, cpuInterfaces("YL11"));
+    EXPECT_EQ(fruImpl.numRSI(), 2);
+    EXPECT_EQ(fruImpl.numRecords(), 4);
+    EXPECT_GT(fruImpl.size(), tableSize);
+    EXPECT_EQ(fruImpl.changeCount(), 1);
+    ASSERT_EQ(pdrChanges.size(), 1);
+    EXPECT_EQ(pdrChanges[0].first, PLDM_RECORDS_ADDED);
+    EXPECT_FALSE(pdrChanges[0].second.empty());
+
+    auto entity = fruImpl.getAssociateEntityMap().at(cpu1);
+    auto node = pldm_entity_association_tree_find_with_locality(
+        entityTree.get(), &entity, false);
+    ASSERT_NE(node, nullptr);
+    auto bmcNode = pldm_entity_association_tree_find_with_locality(
+        bmcEntityTree.get(), &entity, false);
+    ASSERT_NE(bmcNode, nullptr);
+    EXPECT_EQ(pldm_entity_extract(bmcNode).entity_instance_num,
+              entity.entity_instance_num);
+
+    // Properties the FRU records are not built from are ignored
+    fruImpl.propertiesChanged(
+        cpu1, "xyz.openbmc_project.State.Decorator.OperationalStatus",
+        {{"Functional", true}});
+    EXPECT_EQ(fruImpl.changeCount(), 1);
+    EXPECT_EQ(pdrChanges.size(), 1);
+
+    // Modify a FRU
+    fruImpl.propertiesChanged(cpu1, assetIntf,
+                              {{"SerialNumber", std::string("YL12")}});
+    EXPECT_EQ(fruImpl.numRSI(), 2);
+    EXPECT_EQ(fruImpl.numRecords(), 4);
+    EXPECT_EQ(fruImpl.changeCount(), 2);
+    ASSERT_EQ(pdrChanges.size(), 2);
+    EXPECT_EQ(pdrChanges[1].first, PLDM_RECORDS_MODIFIED);
+
+    // Unchanged records leave the FRU table as is
+    fruImpl.propertiesChanged(cpu1, assetIntf,
+                              {{"SerialNumber", std::string("YL12")}});
+    EXPECT_EQ(fruImpl.changeCount(), 2);
+
+    // Remove a FRU, it is no longer present
+    fruImpl.propertiesChanged(cpu1, itemIntf, {{"Present", false}});
+    EXPECT_EQ(fruImpl.numRSI(), 1);
+    EXPECT_EQ(fruImpl.numRecords(), 2);
+    EXPECT_EQ(fruImpl.size(), tableSize);
+    EXPECT_EQ(fruImpl.changeCount(), 3);
+    ASSERT_GE(pdrChanges.size(), 3);
+    EXPECT_EQ(pdrChanges[2].first, PLDM_RECORDS_DELETED);
+    EXPECT_FALSE(fruImpl.getAssociateEntityMap().contains(cpu1));
+
+    ASSERT_EQ(removedNodes.size(), 1);
+    EXPECT_EQ(removedNodes[0], node);
+    EXPECT_EQ(pldm_entity_association_tree_find_with_locality(
+                  entityTree.get(), &entity, false),
+              nullptr);
+    EXPECT_EQ(pldm_entity_association_tree_find_with_locality(
+                  bmcEntityTree.get(), &entity, false),
+              nullptr);
+}
+
+TEST(FruImpl, getFRURecordByOption)
+{
+    using namespace pldm::responder::dbus;
+    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo(
+        pldm_pdr_init(), pldm_pdr_destroy);
+    std::unique_ptr<pldm_entity_association_tree,
+                    decltype(&pldm_entity_association_tree_destroy)>
+        entityTree(pldm_entity_association_tree_init(),
+                   pldm_entity_association_tree_destroy);
+    std::unique_ptr<pldm_entity_association_tree,
+                    decltype(&pldm_entity_association_tree_destroy)>
+        bmcEntityTree(pldm_entity_association_tree_init(),
+                      pldm_entity_association_tree_destroy);
+
+    constexpr auto itemIntf = "xyz.openbmc_project.Inventory.Item";
+    constexpr auto assetIntf = "xyz.openbmc_project.Inventory.Decorator.Asset";
+    const std::string board =
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard";
+    auto cpuInterfaces = [&](const std::string& serialNumber) {
+        return InterfaceMap{
+            {"xyz.openbmc_project.Inventory.Item.Cpu", {}},
+            {itemIntf, {{"Present", true}}},
+            {assetIntf,
+             {{"PartNumber", std::string("02CY211")},
+              {"SerialNumber", serialNumber},
+              {"Model", std::string("POWER10")}}}};
+    };
+
+    ObjectValueTree objects{
+        {sdbusplus::message::object_path(
+             "/xyz/openbmc_project/inventory/system"),
+         {{"xyz.openbmc_project.Inventory.Item.System", {}},
+          {itemIntf, {{"Present", true}}}}},
+        {sdbusplus::message::object_path(
+             "/xyz/openbmc_project/inventory/system/chassis"),
+         {{"xyz.openbmc_project.Inventory.Item.Chassis", {}},
+          {itemIntf, {{"Present", true}}}}},
+        {sdbusplus::message::object_path(board),
+         {{"xyz.openbmc_project.Inventory.Item.Board.Motherboard", {}},
+          {itemIntf, {{"Present", true}}}}},
+        {sdbusplus::message::object_path(board + "/cpu0"),
+         cpuInterfaces("YL10")},
+        {sdbusplus::message::object_path(board + "/cpu1"),
+         cpuInterfaces("YL11")}};
+
+    pldm::responder::FruImpl fruImpl(
+        "./fru_jsons/good", "./fru_jsons/fru_master/fru_master.json",
+        pdrRepo.get(), entityTree.get(), bmcEntityTree.get(), nullptr);
+    fruImpl.startFRUTableBuild(std::move(objects));
+    fruImpl.buildFRUTable();
+    ASSERT_EQ(fruImpl.numRSI(), 2);
+
+    // The records looked up through the index match a scan of the FRU table
+    auto compareWithTableScan = [&fruImpl]() {
+        auto table = fruImpl.getFRUTable();
+        size_t tableSize = fruImpl.size();
+        for (uint16_t rsi : {0, 1, 2, 3})
+        {
+            for (uint8_t recordType : {0, 1, 2})
+            {
+                for (uint8_t fieldType : {0, 2, 3, 4})
+                {
+                    std::vector<uint8_t> expected(tableSize + 7, 0);
+                    size_t expectedSize = expected.size();
+                    ASSERT_EQ(get_fru_record_by_option_check(
+                                  table->data(), tableSize, expected.data(),
+                                  &expectedSize, rsi, recordType, fieldType),
+                              PLDM_SUCCESS);
+
+                    std::vector<uint8_t> fruData;
+                    auto rc = fruImpl.getFRURecordByOption(
+                        fruData, 0, rsi, recordType, fieldType);
+                    if (expectedSize == 0)
+                    {
+                        EXPECT_EQ(rc,
+                                  PLDM_FRU_DATA_STRUCTURE_TABLE_UNAVAILABLE);
+                        continue;
+                    }
+                    ASSERT_EQ(rc, PLDM_SUCCESS);
+                    auto pads = pldm::utils::getNumPadBytes(expectedSize);
+                    ASSERT_EQ(fruData.size(),
+                              expectedSize + pads + sizeof(uint32_t));
+                    EXPECT_TRUE(std::equal(expected.begin(),
+                                           expected.begin() + expectedSize,
+                                           fruData.begin()));
+                }
+            }
+        }
+    };
+
+    compareWithTableScan();
+
+    // Rebuild the records of a FRU, with a longer field
+    fruImpl.propertiesChanged(board + "/cpu0", assetIntf,
+                              {{"SerialNumber", std::string("YL10-REWORKED")}});
+    ASSERT_EQ(fruImpl.changeCount(), 1);
+    compareWithTableScan();
+}
+
+TEST(FruHandler, getFRURecordTableMultipart)
+{
+    using namespace pldm::responder::dbus;
+    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo(
+        pldm_pdr_init(), pldm_pdr_destroy);
+    std::unique_ptr<pldm_entity_association_tree,
+                    decltype(&pldm_entity_association_tree_destroy)>
+        entityTree(pldm_entity_association_tree_init(),
+                   pldm_entity_association_tree_destroy);
+    std::unique_ptr<pldm_entity_association_tree,
+                    decltype(&pldm_entity_association_tree_destroy)>
+        bmcEntityTree(pldm_entity_association_tree_init(),
+                      pldm_entity_association_tree_destroy);
+
+    constexpr auto itemIntf = "xyz.openbmc_project.Inventory.Item";
+    const std::string board =
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard";
+    ObjectValueTree objects{
+        {sdbusplus::message::object_path(board),
+         {{"xyz.openbmc_project.Inventory.Item.Board.Motherboard", {}},
+          {itemIntf, {{"Present", true}}}}}};
+    for (const auto& cpu : {"cpu0", "cpu1", "cpu2"})
+    {
+        objects.emplace(
+            sdbusplus::message::object_path(board + "/" + cpu),
+            InterfaceMap{{"xyz.openbmc_project.Inventory.Item.Cpu", {}},
+                         {itemIntf, {{"Present", true}}},
+                         {"xyz.openbmc_project.Inventory.Decorator.Asset",
+                          {{"PartNumber", std::string("02CY211")},
+                           {"SerialNumber", std::string(cpu)}}}});
+    }
+
+    pldm::responder::fru::Handler handler(
+        "./fru_jsons/good", "./fru_jsons/fru_master/fru_master.json",
+        pdrRepo.get(), entityTree.get(), bmcEntityTree.get(), nullptr);
+    handler.startFRUTableBuild(std::move(objects));
+    handler.buildFRUTable();
+
+    struct Part
+    {
+        uint8_t cc;
+        uint32_t nextTransferHandle;
+        uint8_t transferFlag;
+        std::vector<uint8_t> data;
+    };
+    auto getPart = [&handler](pldm_tid_t tid, uint32_t transferHandle,
+                              uint8_t transferOpFlag) {
+        std::array<uint8_t,
+                   sizeof(pldm_msg_hdr) + PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES>
+            requestMsg{};
+        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+        EXPECT_EQ(encode_get_fru_record_table_req(
+                      0, transferHandle, transferOpFlag, request,
+                      PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES),
+                  PLDM_SUCCESS);
+        auto response = handler.getFRURecordTable(
+            tid, request, PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
+
+        Part part{};
+        part.data.resize(response.size());
+        size_t length = 0;
+        auto responsePtr = reinterpret_cast<const pldm_msg*>(response.data());
+        if (responsePtr->payload[0] != PLDM_SUCCESS)
+        {
+            part.cc = responsePtr->payload[0];
+            part.data.clear();
+            return part;
+        }
+        EXPECT_EQ(decode_get_fru_record_table_resp(
+                      responsePtr, response.size() - sizeof(pldm_msg_hdr),
+                      &part.cc, &part.nextTransferHandle, &part.transferFlag,
+                      part.data.data(), &length),
+                  PLDM_SUCCESS);
+        part.data.resize(length);
+        return part;
+    };
+
+    // By default the whole table is sent in a single part
+    auto whole = getPart(1, 0, PLDM_GET_FIRSTPART);
+    ASSERT_EQ(whole.cc, PLDM_SUCCESS);
+    EXPECT_EQ(whole.transferFlag, PLDM_START_AND_END);
+    EXPECT_EQ(whole.nextTransferHandle, 0);
+    ASSERT_GT(whole.data.size(), 48);
+    EXPECT_EQ(getPart(1, 16, PLDM_GET_NEXTPART).cc,
+              PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+
+    // The parts of a multipart transfer add up to the table
+    handler.setTransferSize(16);
+    std::vector<uint8_t> table;
+    auto part = getPart(1, 0, PLDM_GET_FIRSTPART);
+    ASSERT_EQ(part.cc, PLDM_SUCCESS);
+    EXPECT_EQ(part.transferFlag, PLDM_START);
+    EXPECT_EQ(part.data.size(), 16);
+    table.insert(table.end(), part.data.begin(), part.data.end());
+    while (part.transferFlag != PLDM_END)
+    {
+        auto transferHandle = part.nextTransferHandle;
+        EXPECT_EQ(transferHandle, table.size());
+        part = getPart(1, transferHandle, PLDM_GET_NEXTPART);
+        ASSERT_EQ(part.cc, PLDM_SUCCESS);
+        ASSERT_TRUE(part.transferFlag == PLDM_MIDDLE ||
+                    part.transferFlag == PLDM_END);
+        table.insert(table.end(), part.data.begin(), part.data.end());
+
+        // A part whose response got lost can be requested again
+        if (part.transferFlag == PLDM_MIDDLE)
+        {
+            auto again = getPart(1, transferHandle, PLDM_GET_NEXTPART);
+            EXPECT_EQ(again.data, part.data);
+        }
+    }
+    EXPECT_EQ(part.nextTransferHandle, 0);
+    EXPECT_EQ(table, whole.data);
+
+    // Parts must be requested at a handle of the transfer of the requester
+    EXPECT_EQ(getPart(1, 5, PLDM_GET_NEXTPART).cc,
+              PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+    EXPECT_EQ(getPart(1, table.size(), PLDM_GET_NEXTPART).cc,
+              PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+    EXPECT_EQ(getPart(2, 16, PLDM_GET_NEXTPART).cc,
+              PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+}
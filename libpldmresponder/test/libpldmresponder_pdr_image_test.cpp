@@ -0,0 +1,98 @@
+#include "libpldmresponder/pdr_image.hpp"
+#include "libpldmresponder/pdr_utils.hpp"
+
+#include <stdlib.h>
+
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+
+class TestPDRImage : public testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        char tmpdir[] = "/tmp/pldm_pdr_image.XXXXXX";
+        dir = fs::path(mkdtemp(tmpdir));
+        jsonDir = dir / "pdr";
+        fs::create_directories(jsonDir);
+        fs::copy("./pdr_jsons/state_sensor/good", jsonDir);
+        image = dir / "pdr.img";
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(dir);
+    }
+
+    fs::path dir;
+    fs::path jsonDir;
+    fs::path image;
+};
+
+TEST_F(TestPDRImage, testCompileLoad)
+{
+    ASSERT_FALSE(pdr_image::load({jsonDir}, image).has_value());
+
+    ASSERT_TRUE(pdr_image::compile({jsonDir}, image));
+    auto pdrJsons = pdr_image::load({jsonDir}, image);
+    ASSERT_TRUE(pdrJsons.has_value());
+
+    auto manifest = pdr_image::getManifest({jsonDir});
+    ASSERT_EQ(pdrJsons->size(), manifest.size());
+    for (size_t i = 0; i < manifest.size(); ++i)
+    {
+        auto json =
+            pdr_utils::readJson(manifest[i]["path"].get<std::string>());
+        EXPECT_EQ(pdrJsons->at(i), json);
+    }
+}
+
+TEST_F(TestPDRImage, testStaleImage)
+{
+    ASSERT_TRUE(pdr_image::compile({jsonDir}, image));
+    ASSERT_TRUE(pdr_image::load({jsonDir}, image).has_value());
+
+    std::ofstream extra(jsonDir / "extra.json");
+    extra << "{}";
+    extra.close();
+
+    ASSERT_FALSE(pdr_image::load({jsonDir}, image).has_value());
+}
+
+TEST_F(TestPDRImage, testCorruptImage)
+{
+    ASSERT_TRUE(pdr_image::compile({jsonDir}, image));
+
+    std::fstream stream(image, std::ios::in | std::ios::out |
+                                   std::ios::binary);
+    stream.seekp(sizeof(pdr_image::ImageHeader));
+    stream.put(static_cast<char>(0xff));
+    stream.close();
+
+    ASSERT_FALSE(pdr_image::load({jsonDir}, image).has_value());
+}
+
+TEST_F(TestPDRImage, testWrappingSizes)
+{
+    ASSERT_TRUE(pdr_image::compile({jsonDir}, image));
+
+    // Sizes whose sum wraps around to the size of the image, leaving the
+    // checksum of the body valid
+    pdr_image::ImageHeader header{};
+    std::fstream stream(image, std::ios::in | std::ios::out |
+                                   std::ios::binary);
+    stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+    auto bodySize = fs::file_size(image) - sizeof(header);
+    header.manifestSize = bodySize + 1;
+    header.payloadSize = std::numeric_limits<uint64_t>::max();
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.close();
+
+    ASSERT_FALSE(pdr_image::load({jsonDir}, image).has_value());
+}
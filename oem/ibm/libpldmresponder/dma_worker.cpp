@@ -0,0 +1,164 @@
+#include "dma_worker.hpp"
+
+#include <libpldm/base.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <stdexcept>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+namespace responder
+{
+namespace dma
+{
+
+Worker::Worker(sdeventplus::Event& event, size_t maxPending) :
+    maxPending(maxPending), eventFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+    if (eventFd() < 0)
+    {
+        throw std::runtime_error("Failed to create DMA worker eventfd");
+    }
+
+    completionEvent = std::make_unique<sdeventplus::source::IO>(
+        event, eventFd(), EPOLLIN,
+        [this](sdeventplus::source::IO&, int, uint32_t) { complete(); });
+    thread = std::thread(&Worker::run, this);
+}
+
+Worker::~Worker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    workAvailable.notify_one();
+    thread.join();
+}
+
+bool Worker::submit(uint32_t length, Job&& job, Completion&& completion)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto pending = queue.size() + done.size() + (progress.active ? 1 : 0);
+        if (pending >= maxPending)
+        {
+            progress.refused++;
+            return false;
+        }
+
+        queue.push_back(Transfer{length, std::move(job), std::move(completion),
+                                 Response{}, std::chrono::steady_clock::now(),
+                                 std::chrono::steady_clock::duration{}});
+        progress.queued++;
+        progress.queuedBytes += length;
+    }
+    workAvailable.notify_one();
+    return true;
+}
+
+Progress Worker::getProgress() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return progress;
+}
+
+void Worker::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        workAvailable.wait(lock, [this] { return stop || !queue.empty(); });
+        if (stop)
+        {
+            return;
+        }
+
+        auto transfer = std::move(queue.front());
+        queue.pop_front();
+        progress.queued--;
+        progress.queuedBytes -= transfer.length;
+        progress.active = true;
+        progress.activeLength = transfer.length;
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            transfer.response = transfer.job();
+        }
+        catch (const std::exception& e)
+        {
+            error(
+                "Failed to run DMA transfer of length '{LENGTH}', error - {ERROR}",
+                "LENGTH", transfer.length, "ERROR", e);
+        }
+        transfer.duration = std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+        progress.active = false;
+        progress.activeLength = 0;
+        done.emplace_back(std::move(transfer));
+
+        uint64_t value = 1;
+        if (write(eventFd(), &value, sizeof(value)) < 0)
+        {
+            error(
+                "Failed to signal DMA transfer completion, error number - {ERROR_NUM}",
+                "ERROR_NUM", errno);
+        }
+    }
+}
+
+void Worker::complete()
+{
+    uint64_t value = 0;
+    if (read(eventFd(), &value, sizeof(value)) < 0 && errno != EAGAIN)
+    {
+        error(
+            "Failed to read DMA transfer completion, error number - {ERROR_NUM}",
+            "ERROR_NUM", errno);
+    }
+
+    std::deque<Transfer> completed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        completed.swap(done);
+        for (const auto& transfer : completed)
+        {
+            auto responsePtr = reinterpret_cast<const pldm_msg*>(
+                transfer.response.data());
+            if (transfer.response.size() <= sizeof(pldm_msg_hdr) ||
+                responsePtr->payload[0] != PLDM_SUCCESS)
+            {
+                progress.failed++;
+            }
+            progress.completed++;
+            progress.bytes += transfer.length;
+        }
+    }
+
+    for (auto& transfer : completed)
+    {
+        auto queuedFor = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - transfer.queued -
+            transfer.duration);
+        auto ranFor = std::chrono::duration_cast<std::chrono::milliseconds>(
+            transfer.duration);
+        debug(
+            "DMA transfer of length '{LENGTH}' done in '{DURATION}' ms after waiting '{QUEUED}' ms",
+            "LENGTH", transfer.length, "DURATION", ranFor.count(), "QUEUED",
+            queuedFor.count());
+        transfer.completion(std::move(transfer.response));
+    }
+}
+
+} // namespace dma
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "common/utils.hpp"
+#include "pldmd/handler.hpp"
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace pldm
+{
+namespace responder
+{
+namespace dma
+{
+
+/** @struct Progress
+ *
+ *  Snapshot of the transfers handed to the I/O worker
+ */
+struct Progress
+{
+    size_t queued = 0;          //!< transfers waiting for the worker
+    uint64_t queuedBytes = 0;   //!< bytes of the transfers waiting
+    bool active = false;        //!< a transfer is running on the worker
+    uint32_t activeLength = 0;  //!< length of the transfer running
+    uint64_t completed = 0;     //!< transfers done since startup
+    uint64_t failed = 0;        //!< transfers done with an error response
+    uint64_t bytes = 0;         //!< bytes of the transfers done
+    uint64_t refused = 0;       //!< transfers refused as the queue was full
+};
+
+/** @class Worker
+ *
+ *  Runs DMA transfers on a dedicated I/O thread, so that a multi-megabyte
+ *  transfer does not stall the event loop. The PLDM response of a transfer is
+ *  built on the worker thread and handed back to the event loop through an
+ *  eventfd, where the completion callback sends it. Jobs must not touch the
+ *  D-Bus connection or any other state owned by the event loop.
+ */
+class Worker
+{
+  public:
+    /** @brief The transfer, run on the worker thread, returns the response */
+    using Job = std::function<Response()>;
+
+    /** @brief Called on the event loop with the response of the transfer,
+     *         which is empty if the job threw
+     */
+    using Completion = std::function<void(Response&& response)>;
+
+    Worker() = delete;
+    Worker(const Worker&) = delete;
+    Worker(Worker&&) = delete;
+    Worker& operator=(const Worker&) = delete;
+    Worker& operator=(Worker&&) = delete;
+
+    /** @brief Start the worker thread
+     *
+     *  @param[in] event - event loop the completions are called on
+     *  @param[in] maxPending - maximum number of transfers queued or running
+     */
+    Worker(sdeventplus::Event& event, size_t maxPending);
+
+    /** @brief Stop the worker thread, the transfer running is completed but
+     *         the transfers still queued are dropped without a response
+     */
+    ~Worker();
+
+    /** @brief Queue a transfer on the worker thread
+     *
+     *  @param[in] length - length of the transfer, for accounting
+     *  @param[in] job - the transfer
+     *  @param[in] completion - called with the response of the transfer
+     *
+     *  @return bool - false if maxPending transfers are already queued or
+     *          running, the transfer is not queued then
+     */
+    bool submit(uint32_t length, Job&& job, Completion&& completion);
+
+    /** @brief Get a snapshot of the transfers handed to the worker */
+    Progress getProgress() const;
+
+  private:
+    /** @struct Transfer
+     *
+     *  A transfer queued on, or completed by, the worker thread
+     */
+    struct Transfer
+    {
+        uint32_t length;
+        Job job;
+        Completion completion;
+        Response response;
+        std::chrono::steady_clock::time_point queued;
+        std::chrono::steady_clock::duration duration;
+    };
+
+    /** @brief Main loop of the worker thread */
+    void run();
+
+    /** @brief Deliver the completed transfers, on the event loop */
+    void complete();
+
+    size_t maxPending;
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::deque<Transfer> queue;
+    std::deque<Transfer> done;
+    Progress progress;
+    bool stop = false;
+
+    /** @brief Signalled by the worker thread when a transfer is done */
+    pldm::utils::CustomFD eventFd;
+    std::unique_ptr<sdeventplus::source::IO> completionEvent;
+
+    std::thread thread;
+};
+
+} // namespace dma
+} // namespace responder
+} // namespace pldm
@@ -7,15 +7,16 @@
 
 #include <fcntl.h>
 #include <libpldm/base.h>
+#include <poll.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/event.hpp>
 
 #include <cstring>
-#include <fstream>
 #include <memory>
 
 PHOSPHOR_LOG2_USING;
@@ -47,211 +48,328 @@ struct AspeedXdmaOp
 
 constexpr auto xdmaDev = "/dev/aspeed-xdma";
 
-int DMA::transferHostDataToSocket(int fd, uint32_t length, uint64_t address)
+DMA& DMA::getSession()
 {
+    static DMA session;
+    return session;
+}
+
+int DMA::openSession()
+{
+    lastUsed = std::chrono::steady_clock::now();
+    if (!buffers.empty())
+    {
+        return buffers.size();
+    }
+
     static const size_t pageSize = getpagesize();
-    uint32_t numPages = length / pageSize;
-    uint32_t pageAlignedLength = numPages * pageSize;
+    const size_t mappingLength = (maxSize + pageSize - 1) / pageSize *
+                                 pageSize;
 
-    if (length > pageAlignedLength)
+    for (size_t index = 0; index < numBuffers; ++index)
     {
-        pageAlignedLength += pageSize;
+        // Non-blocking, so that a DMA operation is started without waiting
+        // for it to complete, the completion is then polled for
+        int dmaFd = open(xdmaDev, O_RDWR | O_NONBLOCK);
+        if (dmaFd < 0)
+        {
+            int rc = -errno;
+            error(
+                "Failed to open the XDMA device for data transfer between BMC and remote terminus with response code '{RC}'",
+                "RC", rc);
+            break;
+        }
+        auto xdmaFd = std::make_unique<pldm::utils::CustomFD>(dmaFd);
+
+        auto mapped = mmap(nullptr, mappingLength, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, dmaFd, 0);
+        if (MAP_FAILED == mapped)
+        {
+            int rc = -errno;
+            error(
+                "Failed to mmap staging buffer {INDEX} of the XDMA device with response code '{RC}'",
+                "INDEX", index, "RC", rc);
+            break;
+        }
+
+        StagingBuffer buffer{};
+        buffer.xdmaFd = std::move(xdmaFd);
+        buffer.mapping = std::unique_ptr<void, std::function<void(void*)>>(
+            mapped,
+            [mappingLength](void* p) { munmap(p, mappingLength); });
+        buffer.data = std::span<uint8_t>(static_cast<uint8_t*>(mapped),
+                                         maxSize);
+        buffers.emplace_back(std::move(buffer));
     }
 
-    auto mmapCleanup = [pageAlignedLength](void* vgaMem) {
-        munmap(vgaMem, pageAlignedLength);
-    };
+    // The staging buffers are carved out of the memory reserved for XDMA, if
+    // there is room for only one the transfers go ahead without overlapping
+    // the file I/O with the DMA operations
+    if (buffers.empty())
+    {
+        return -ENOMEM;
+    }
 
-    int dmaFd = -1;
-    int rc = 0;
-    dmaFd = open(xdmaDev, O_RDWR);
-    if (dmaFd < 0)
+    // Writing to the VGA memory should be aligned at page boundary, so the
+    // file data is read into a buffer aligned at page boundary and then
+    // written to the VGA memory
+    auto mapped = mmap(nullptr, mappingLength, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == mapped)
     {
-        rc = -errno;
+        int rc = -errno;
         error(
-            "Failed to open the XDMA device for transferring remote terminus data to socket with response code '{RC}'",
+            "Failed to allocate the bounce buffer of the XDMA staging buffers with response code '{RC}'",
             "RC", rc);
+        buffers.clear();
         return rc;
     }
+    bounce.mapping = std::unique_ptr<void, std::function<void(void*)>>(
+        mapped, [mappingLength](void* p) { munmap(p, mappingLength); });
+    bounce.data = std::span<uint8_t>(static_cast<uint8_t*>(mapped), maxSize);
+
+    return buffers.size();
+}
+
+void DMA::watchIdle()
+{
+    if (!idleTimer)
+    {
+        idleTimer = std::make_unique<
+            sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>(
+            sdeventplus::Event::get_default(), [this](auto&) {
+            auto left = closeIdleSession();
+            if (left)
+            {
+                idleTimer->restartOnce(*left);
+            }
+        });
+    }
+    if (!idleTimer->isEnabled())
+    {
+        idleTimer->restartOnce(idleTimeout);
+    }
+}
 
-    pldm::utils::CustomFD xdmaFd(dmaFd);
+std::optional<std::chrono::microseconds> DMA::closeIdleSession()
+{
+    auto lock = tryLock();
+    if (!lock.owns_lock())
+    {
+        // A transfer is running on the I/O worker, check again after it
+        return idleTimeout;
+    }
+    if (buffers.empty())
+    {
+        return std::nullopt;
+    }
 
-    void* vgaMem;
-    vgaMem = mmap(nullptr, pageAlignedLength, PROT_READ, MAP_SHARED, xdmaFd(),
-                  0);
-    if (MAP_FAILED == vgaMem)
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastUsed < idleTimeout)
     {
-        rc = -errno;
-        error(
-            "Failed to mmap the XDMA device for transferring remote terminus data to socket with response code '{RC}'",
-            "RC", rc);
-        return rc;
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            lastUsed + idleTimeout - now);
     }
 
-    std::unique_ptr<void, decltype(mmapCleanup)> vgaMemPtr(vgaMem, mmapCleanup);
+    info("Unmapping the XDMA staging buffers, no transfer for {SECONDS}s",
+         "SECONDS", idleTimeout.count());
+    buffers.clear();
+    bounce = {};
+    return std::nullopt;
+}
 
+std::span<uint8_t> DMA::getBuffer(size_t index)
+{
+    return buffers.at(index).data;
+}
+
+int DMA::startTransfer(size_t index, uint32_t length, uint64_t address,
+                       bool upstream)
+{
     AspeedXdmaOp xdmaOp;
-    xdmaOp.upstream = 0;
+    xdmaOp.upstream = upstream ? 1 : 0;
     xdmaOp.hostAddr = address;
     xdmaOp.len = length;
 
-    rc = write(xdmaFd(), &xdmaOp, sizeof(xdmaOp));
+    int rc = write((*buffers.at(index).xdmaFd)(), &xdmaOp, sizeof(xdmaOp));
     if (rc < 0)
     {
         rc = -errno;
         error(
-            "Failed to execute the DMA operation for transfering remote terminus data to socket at address '{ADDRESS}' and length '{LENGTH}' with response code '{RC}'",
-            "RC", rc, "ADDRESS", address, "LENGTH", length);
-        return rc;
-    }
-
-    rc = writeToUnixSocket(fd, static_cast<const char*>(vgaMemPtr.get()),
-                           length);
-    if (rc < 0)
-    {
-        rc = -errno;
-        close(fd);
-        error(
-            "Failed to write to Unix socket, closing socket for transfering remote terminus data to socket with response code '{RC}'",
-            "RC", rc);
+            "Failed to execute the DMA operation on data between BMC and remote terminus for upstream '{UPSTREAM}' of length '{LENGTH}' at address '{ADDRESS}', response code '{RC}'",
+            "RC", rc, "UPSTREAM", upstream, "ADDRESS", address, "LENGTH",
+            length);
         return rc;
     }
     return 0;
 }
 
-int DMA::transferDataHost(int fd, uint32_t offset, uint32_t length,
-                          uint64_t address, bool upstream)
+int DMA::waitTransfer(size_t index)
 {
-    static const size_t pageSize = getpagesize();
-    uint32_t numPages = length / pageSize;
-    uint32_t pageAlignedLength = numPages * pageSize;
-
-    if (length > pageAlignedLength)
-    {
-        pageAlignedLength += pageSize;
-    }
+    pollfd fds{};
+    fds.fd = (*buffers.at(index).xdmaFd)();
+    fds.events = POLLIN;
 
+    // The DMA operation goes on regardless of signals, it has to be waited
+    // for before the staging buffer is reused
     int rc = 0;
-    auto mmapCleanup = [pageAlignedLength, &rc](void* vgaMem) {
-        if (rc != -EINTR)
-        {
-            munmap(vgaMem, pageAlignedLength);
-        }
-        else
-        {
-            error(
-                "Received interrupt during DMA transfer for data between BMC and remote terminus. Skipping Unmap.");
-        }
-    };
+    do
+    {
+        rc = poll(&fds, 1, -1);
+    } while (rc < 0 && errno == EINTR);
 
-    int dmaFd = -1;
-    dmaFd = open(xdmaDev, O_RDWR);
-    if (dmaFd < 0)
+    if (rc < 0)
     {
         rc = -errno;
         error(
-            "Failed to open the XDMA device for data transfer between BMC and remote terminus with response code '{RC}'",
+            "Failed to wait for the DMA operation on data between BMC and remote terminus, response code '{RC}'",
             "RC", rc);
         return rc;
     }
-
-    pldm::utils::CustomFD xdmaFd(dmaFd);
-
-    void* vgaMem;
-    vgaMem = mmap(nullptr, pageAlignedLength, upstream ? PROT_WRITE : PROT_READ,
-                  MAP_SHARED, xdmaFd(), 0);
-    if (MAP_FAILED == vgaMem)
+    if (fds.revents & (POLLERR | POLLHUP | POLLNVAL))
     {
-        rc = -errno;
         error(
-            "Failed to mmap the XDMA device for data transfer between BMC and remote terminus with response code '{RC}'",
-            "RC", rc);
-        return rc;
+            "Failed DMA operation on data between BMC and remote terminus, poll events '{EVENTS}'",
+            "EVENTS", fds.revents);
+        return -EIO;
     }
+    return 0;
+}
 
-    std::unique_ptr<void, decltype(mmapCleanup)> vgaMemPtr(vgaMem, mmapCleanup);
+int transferFileChunk(int fd, uint32_t offset, bool upstream,
+                      std::span<uint8_t> bounce, std::span<uint8_t> buffer,
+                      uint32_t chunkOffset)
+{
+    off_t fileOffset = static_cast<off_t>(offset) + chunkOffset;
+    uint32_t length = buffer.size();
+    if (upstream && bounce.size() < length)
+    {
+        error(
+            "Failed to transfer data between BMC and remote terminus, bounce buffer of size '{SIZE}' is shorter than the length '{LENGTH}'",
+            "SIZE", bounce.size(), "LENGTH", length);
+        return -1;
+    }
 
-    if (upstream)
+    // Upstream the file is read into the bounce buffer, in cached memory,
+    // downstream it is written straight from the staging buffer
+    for (size_t done = 0; done < length;)
     {
-        rc = lseek(fd, offset, SEEK_SET);
-        if (rc == -1)
+        auto rc = upstream ? pread(fd, bounce.data() + done, length - done,
+                                   fileOffset + done)
+                           : pwrite(fd, buffer.data() + done, length - done,
+                                    fileOffset + done);
+        if (rc == -1 && errno == EINTR)
         {
-            error(
-                "Failed to transfer data between BMC and remote terminus due to lseek failure with upstream '{UPSTREAM}' at offset '{OFFSET}', error number - {ERROR_NUM}",
-                "ERROR_NUM", errno, "UPSTREAM", upstream, "OFFSET", offset);
-            return rc;
+            continue;
         }
-
-        // Writing to the VGA memory should be aligned at page boundary,
-        // otherwise write data into a buffer aligned at page boundary and
-        // then write to the VGA memory.
-        std::vector<char> buffer{};
-        buffer.resize(pageAlignedLength);
-        rc = read(fd, buffer.data(), length);
         if (rc == -1)
         {
             error(
-                "Failed to transfer data between BMC and remote terminus with file read on upstream '{UPSTREAM}' of length '{LENGTH}' at offset '{OFFSET}' failed, error number - {ERROR_NUM}",
+                "Failed to transfer data between BMC and remote terminus with file I/O on upstream '{UPSTREAM}' of length '{LENGTH}' at offset '{OFFSET}' failed, error number - {ERROR_NUM}",
                 "ERROR_NUM", errno, "UPSTREAM", upstream, "LENGTH", length,
-                "OFFSET", offset);
-            return rc;
+                "OFFSET", fileOffset);
+            return -1;
         }
-        if (rc != static_cast<int>(length))
+        if (rc == 0)
         {
             error(
                 "Failed to transfer data between BMC and remote terminus mismatched for number of characters to read on upstream '{UPSTREAM}' and the length '{LENGTH}' read  and count '{RC}'",
-                "UPSTREAM", upstream, "LENGTH", length, "RC", rc);
+                "UPSTREAM", upstream, "LENGTH", length, "RC", done);
             return -1;
         }
-        memcpy(static_cast<char*>(vgaMemPtr.get()), buffer.data(),
-               pageAlignedLength);
+        done += rc;
     }
 
-    AspeedXdmaOp xdmaOp;
-    xdmaOp.upstream = upstream ? 1 : 0;
-    xdmaOp.hostAddr = address;
-    xdmaOp.len = length;
+    if (upstream)
+    {
+        memcpy(buffer.data(), bounce.data(), length);
+    }
+    return 0;
+}
 
-    rc = write(xdmaFd(), &xdmaOp, sizeof(xdmaOp));
+int transferSocketChunk(int fd, std::span<uint8_t> buffer,
+                        uint32_t /*chunkOffset*/)
+{
+    int rc = writeToUnixSocket(fd, reinterpret_cast<const char*>(buffer.data()),
+                               buffer.size());
     if (rc < 0)
     {
         rc = -errno;
+        close(fd);
         error(
-            "Failed to execute the DMA operation on data between BMC and remote terminus for upstream '{UPSTREAM}' of length '{LENGTH}' at address '{ADDRESS}', response code '{RC}'",
-            "RC", rc, "UPSTREAM", upstream, "ADDRESS", address, "LENGTH",
-            length);
+            "Failed to write to Unix socket, closing socket for transfering remote terminus data to socket with response code '{RC}'",
+            "RC", rc);
         return rc;
     }
+    return 0;
+}
+
+} // namespace dma
+
+namespace oem_ibm
+{
+Response Handler::transferFile(pldm_tid_t tid, uint8_t command,
+                                const fs::path& path, uint32_t offset,
+                                uint32_t length, uint64_t address,
+                                bool upstream, uint8_t instanceId)
+{
+    auto job = [command, path, offset, length, address, upstream,
+                instanceId]() mutable {
+        auto& session = dma::DMA::getSession();
+        auto lock = session.lock();
+        return dma::transferAll<dma::DMA>(&session, command, path, offset,
+                                          length, address, upstream,
+                                          instanceId);
+    };
+    if (!responseSender)
+    {
+        auto response = job();
+        dma::DMA::getSession().watchIdle();
+        return response;
+    }
 
-    if (!upstream)
+    if (!worker)
     {
-        rc = lseek(fd, offset, SEEK_SET);
-        if (rc == -1)
-        {
-            error(
-                "Failed to transfer data between BMC and remote terminus due to lseek failure '{UPSTREAM}' at offset '{OFFSET}' failed, error number - {ERROR_NUM}",
-                "ERROR_NUM", errno, "UPSTREAM", upstream, "OFFSET", offset);
-            return rc;
-        }
-        rc = write(fd, static_cast<const char*>(vgaMemPtr.get()), length);
-        if (rc == -1)
+        auto event = sdeventplus::Event::get_default();
+        worker = std::make_unique<dma::Worker>(event,
+                                               DMA_MAX_PENDING_TRANSFERS);
+    }
+
+    auto completion = [this, tid, command, instanceId](Response&& response) {
+        if (response.empty())
         {
-            error(
-                "Failed to transfer data between BMC and remote terminus where file write upstream '{UPSTREAM}' of length '{LENGTH}' at offset '{OFFSET}' failed, error number - {ERROR_NUM}",
-                "ERROR_NUM", errno, "UPSTREAM", upstream, "LENGTH", length,
-                "OFFSET", offset);
-            return rc;
+            response.resize(sizeof(pldm_msg_hdr) +
+                            PLDM_RW_FILE_MEM_RESP_BYTES);
+            encode_rw_file_memory_resp(
+                instanceId, command, PLDM_ERROR, 0,
+                reinterpret_cast<pldm_msg*>(response.data()));
         }
+        responseSender(tid, response);
+        serveDeferredRequests();
+        dma::DMA::getSession().watchIdle();
+    };
+    if (!worker->submit(length, std::move(job), std::move(completion)))
+    {
+        auto progress = worker->getProgress();
+        error(
+            "Failed to queue DMA transfer of length '{LENGTH}' for file '{PATH}', too many transfers pending, '{QUEUED}' transfers of '{QUEUED_BYTES}' bytes queued, '{COMPLETED}' completed and '{FAILED}' failed since startup",
+            "LENGTH", length, "PATH", path, "QUEUED", progress.queued,
+            "QUEUED_BYTES", progress.queuedBytes, "COMPLETED",
+            progress.completed, "FAILED", progress.failed);
+        Response response(sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES,
+                          0);
+        encode_rw_file_memory_resp(instanceId, command, PLDM_ERROR_NOT_READY,
+                                   0,
+                                   reinterpret_cast<pldm_msg*>(
+                                       response.data()));
+        return response;
     }
 
-    return 0;
+    // The response is sent by the completion of the transfer
+    return {};
 }
 
-} // namespace dma
-
-namespace oem_ibm
-{
-Response Handler::readFileIntoMemory(const pldm_msg* request,
+Response Handler::readFileIntoMemory(pldm_tid_t tid, const pldm_msg* request,
                                      size_t payloadLength)
 {
     uint32_t fileHandle = 0;
@@ -329,14 +447,11 @@ Response Handler::readFileIntoMemory(const pldm_msg* request,
         return response;
     }
 
-    using namespace dma;
-    DMA intf;
-    return transferAll<DMA>(&intf, PLDM_READ_FILE_INTO_MEMORY, value.fsPath,
-                            offset, length, address, true,
-                            request->hdr.instance_id);
+    return transferFile(tid, PLDM_READ_FILE_INTO_MEMORY, value.fsPath, offset,
+                        length, address, true, request->hdr.instance_id);
 }
 
-Response Handler::writeFileFromMemory(const pldm_msg* request,
+Response Handler::writeFileFromMemory(pldm_tid_t tid, const pldm_msg* request,
                                       size_t payloadLength)
 {
     uint32_t fileHandle = 0;
@@ -410,11 +525,9 @@ Response Handler::writeFileFromMemory(const pldm_msg* request,
         return response;
     }
 
-    using namespace dma;
-    DMA intf;
-    return transferAll<DMA>(&intf, PLDM_WRITE_FILE_FROM_MEMORY, value.fsPath,
-                            offset, length, address, false,
-                            request->hdr.instance_id);
+    return transferFile(tid, PLDM_WRITE_FILE_FROM_MEMORY, value.fsPath,
+                        offset, length, address, false,
+                        request->hdr.instance_id);
 }
 
 Response Handler::getFileTable(const pldm_msg* request, size_t payloadLength)
@@ -453,7 +566,7 @@ Response Handler::getFileTable(const pldm_msg* request, size_t payloadLength)
     }
 
     using namespace pldm::filetable;
-    auto table = buildFileTable(FILE_TABLE_JSON);
+    auto& table = buildFileTable(FILE_TABLE_JSON);
     auto attrTable = table();
     response.resize(response.size() + attrTable.size());
     responsePtr = reinterpret_cast<pldm_msg*>(response.data());
@@ -516,7 +629,7 @@ Response Handler::readFile(const pldm_msg* request, size_t payloadLength)
         return response;
     }
 
-    if (!fs::exists(value.fsPath))
+    if (!value.fd)
     {
         error("File '{PATH}' and handle {FILE_HANDLE} does not exist", "PATH",
               value.fsPath, "FILE_HANDLE", fileHandle);
@@ -525,7 +638,7 @@ Response Handler::readFile(const pldm_msg* request, size_t payloadLength)
         return response;
     }
 
-    auto fileSize = fs::file_size(value.fsPath);
+    auto fileSize = value.size;
     if (offset >= fileSize)
     {
         error(
@@ -547,9 +660,28 @@ Response Handler::readFile(const pldm_msg* request, size_t payloadLength)
     auto fileDataPos = reinterpret_cast<char*>(responsePtr);
     fileDataPos += sizeof(pldm_msg_hdr) + sizeof(uint8_t) + sizeof(length);
 
-    std::ifstream stream(value.fsPath, std::ios::in | std::ios::binary);
-    stream.seekg(offset);
-    stream.read(fileDataPos, length);
+    // Read straight into the response, the file is kept open by the table
+    auto bytes = pread((*value.fd)(), fileDataPos, length, offset);
+    if (bytes < 0)
+    {
+        error(
+            "Failed to read file '{PATH}' and handle {FILE_HANDLE}, error number - {ERROR_NUM}",
+            "PATH", value.fsPath, "FILE_HANDLE", fileHandle, "ERROR_NUM",
+            errno);
+        response.resize(sizeof(pldm_msg_hdr) + PLDM_READ_FILE_RESP_BYTES);
+        responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+        encode_read_file_resp(request->hdr.instance_id, PLDM_ERROR, 0,
+                              responsePtr);
+        return response;
+    }
+    if (static_cast<uint32_t>(bytes) < length)
+    {
+        // The file was truncated since its size was last refreshed
+        length = bytes;
+        response.resize(sizeof(pldm_msg_hdr) + PLDM_READ_FILE_RESP_BYTES +
+                        length);
+        responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    }
 
     encode_read_file_resp(request->hdr.instance_id, PLDM_SUCCESS, length,
                           responsePtr);
@@ -601,7 +733,7 @@ Response Handler::writeFile(const pldm_msg* request, size_t payloadLength)
         return response;
     }
 
-    if (!fs::exists(value.fsPath))
+    if (!value.fd)
     {
         error("File '{PATH}' and handle {FILE_HANDLE} does not exist", "PATH",
               value.fsPath, "FILE_HANDLE", fileHandle);
@@ -610,7 +742,7 @@ Response Handler::writeFile(const pldm_msg* request, size_t payloadLength)
         return response;
     }
 
-    auto fileSize = fs::file_size(value.fsPath);
+    auto fileSize = value.size;
     if (offset >= fileSize)
     {
         error(
@@ -625,10 +757,18 @@ Response Handler::writeFile(const pldm_msg* request, size_t payloadLength)
     auto fileDataPos = reinterpret_cast<const char*>(request->payload) +
                        fileDataOffset;
 
-    std::ofstream stream(value.fsPath,
-                         std::ios::in | std::ios::out | std::ios::binary);
-    stream.seekp(offset);
-    stream.write(fileDataPos, length);
+    auto bytes = pwrite((*value.fd)(), fileDataPos, length, offset);
+    if (bytes < 0)
+    {
+        error(
+            "Failed to write file '{PATH}' and handle {FILE_HANDLE}, error number - {ERROR_NUM}",
+            "PATH", value.fsPath, "FILE_HANDLE", fileHandle, "ERROR_NUM",
+            errno);
+        encode_write_file_resp(request->hdr.instance_id, PLDM_ERROR, 0,
+                               responsePtr);
+        return response;
+    }
+    length = bytes;
 
     encode_write_file_resp(request->hdr.instance_id, PLDM_SUCCESS, length,
                            responsePtr);
@@ -701,6 +841,70 @@ Response rwFileByTypeIntoMemory(uint8_t cmd, const pldm_msg* request,
     return response;
 }
 
+Response Handler::rwFileByTypeMemory(pldm_tid_t tid, uint8_t command,
+                                     const pldm_msg* request,
+                                     size_t payloadLength)
+{
+    if (!responseSender)
+    {
+        return rwFileByTypeIntoMemory(command, request, payloadLength,
+                                      oemPlatformHandler);
+    }
+
+    auto& session = dma::DMA::getSession();
+    auto lock = session.tryLock();
+    if (!lock.owns_lock())
+    {
+        // The I/O worker holds the session, the completion of its transfer
+        // serves the request before the worker takes the session again
+        auto message = reinterpret_cast<const uint8_t*>(request);
+        deferredRequests.emplace_back(
+            tid, command,
+            std::vector<uint8_t>(message, message + sizeof(pldm_msg_hdr) +
+                                              payloadLength));
+        session.deferWorker();
+        return {};
+    }
+
+    // Keep the requests in the order they were received
+    serveDeferredRequests();
+    return rwFileByTypeIntoMemory(command, request, payloadLength,
+                                  oemPlatformHandler);
+}
+
+void Handler::serveDeferredRequests()
+{
+    if (deferredRequests.empty())
+    {
+        return;
+    }
+
+    auto& session = dma::DMA::getSession();
+    auto lock = session.tryLock();
+    if (!lock.owns_lock())
+    {
+        // The next worker transfer started already, its completion serves
+        // the requests
+        return;
+    }
+
+    while (!deferredRequests.empty())
+    {
+        auto deferred = std::move(deferredRequests.front());
+        deferredRequests.pop_front();
+        auto request = reinterpret_cast<const pldm_msg*>(
+            deferred.message.data());
+        auto response = rwFileByTypeIntoMemory(
+            deferred.command, request,
+            deferred.message.size() - sizeof(pldm_msg_hdr),
+            oemPlatformHandler);
+        responseSender(deferred.tid, response);
+    }
+    lock.unlock();
+    session.resumeWorker();
+    session.watchIdle();
+}
+
 Response Handler::writeFileByTypeFromMemory(const pldm_msg* request,
                                             size_t payloadLength)
 {
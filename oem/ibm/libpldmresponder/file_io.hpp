@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/utils.hpp"
+#include "dma_worker.hpp"
 #include "oem/ibm/requester/dbus_to_file_handler.hpp"
 #include "oem_ibm_handler.hpp"
 #include "pldmd/handler.hpp"
@@ -16,9 +17,21 @@
 #include <unistd.h>
 
 #include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/utility/timer.hpp>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <vector>
 
 PHOSPHOR_LOG2_USING;
@@ -36,22 +49,127 @@ constexpr size_t maxSize = DMA_MAXSIZE;
 
 namespace fs = std::filesystem;
 
+/** @brief Number of staging buffers of the DMA session. While the DMA engine
+ *         works on the chunk in one of them, the file I/O for the next or the
+ *         previous chunk is done on another.
+ */
+constexpr size_t numBuffers = 2;
+
 /**
  * @class DMA
  *
  * Expose API to initiate transfer of data by DMA
  *
- * This class only exposes the public API transferDataHost to transfer data
- * between BMC and host using DMA. This allows for mocking the transferDataHost
- * for unit testing purposes.
+ * The XDMA device is opened and its staging buffers are mapped on the first
+ * transfer, and are kept until no transfer is done for idleTimeout, so that
+ * their memory is given back to the XDMA reserved memory in between bursts
+ * of transfers. Each staging
+ * buffer is backed by its own XDMA client, as the driver DMAs from or to the
+ * start of the mapping of the client that starts the operation. The class is
+ * the DMAInterface of transferData(), which allows for faking the device for
+ * unit testing purposes.
+ *
+ * Transfers run both on the event loop and on the I/O worker, the session has
+ * to be locked for the duration of a transfer. The event loop must not wait
+ * for the worker, so it only tries to lock the session. If the worker holds
+ * it, the event loop defers the request and has the worker wait for it to be
+ * served, by the completion of the worker transfer, before the next one. The
+ * event loop may lock the session again while holding it.
  */
 class DMA
 {
   public:
-    /** @brief API to transfer data between BMC and host using DMA
+    DMA() = default;
+    DMA(const DMA&) = delete;
+    DMA(DMA&&) = delete;
+    DMA& operator=(const DMA&) = delete;
+    DMA& operator=(DMA&&) = delete;
+    ~DMA() = default;
+
+    /** @brief The DMA session of the process */
+    static DMA& getSession();
+
+    /** @brief Lock the session for a transfer on the I/O worker, after the
+     *         requests deferred by the event loop are served
+     *
+     * @return the lock, held until it goes out of scope
+     */
+    std::unique_lock<std::recursive_mutex> lock()
+    {
+        {
+            std::unique_lock<std::mutex> waitLock(waitMutex);
+            eventLoopServed.wait(waitLock,
+                                 [this] { return !eventLoopWaiting; });
+        }
+        return std::unique_lock<std::recursive_mutex>(mutex);
+    }
+
+    /** @brief Lock the session for a transfer, without waiting for the
+     *         transfer in progress if there is one
+     *
+     * @return the lock, which owns the session only if it was free
+     */
+    std::unique_lock<std::recursive_mutex> tryLock()
+    {
+        return std::unique_lock<std::recursive_mutex>(mutex,
+                                                      std::try_to_lock);
+    }
+
+    /** @brief Have the I/O worker wait for the event loop before its next
+     *         transfer, as requests on the event loop wait for the session
+     */
+    void deferWorker()
+    {
+        std::lock_guard<std::mutex> waitLock(waitMutex);
+        eventLoopWaiting = true;
+    }
+
+    /** @brief Let the I/O worker go on with its transfers */
+    void resumeWorker()
+    {
+        {
+            std::lock_guard<std::mutex> waitLock(waitMutex);
+            eventLoopWaiting = false;
+        }
+        eventLoopServed.notify_all();
+    }
+
+    /** @brief Open the XDMA device and map the staging buffers, if not done
+     *         already
+     *
+     * @return the number of staging buffers on success, negative errno on
+     *         failure
+     */
+    int openSession();
+
+    /** @brief Unmap the staging buffers once the session is idle for
+     *         idleTimeout, to be called on the event loop after transfers
+     */
+    void watchIdle();
+
+    /** @brief Get a staging buffer
+     *
+     * @param[in] index - index of the staging buffer
      *
-     * @param[in] path     - pathname of the file to transfer data from or to
-     * @param[in] offset   - offset in the file
+     * @return the staging buffer, maxSize bytes long
+     */
+    std::span<uint8_t> getBuffer(size_t index);
+
+    /** @brief Get the page aligned bounce buffer, in cached memory, the file
+     *         data is read into before it is copied to a staging buffer
+     *
+     * @return the bounce buffer, at least maxSize bytes long
+     */
+    std::span<uint8_t> getBounceBuffer()
+    {
+        return bounce.data;
+    }
+
+    /** @brief Start a DMA operation between a staging buffer and the host,
+     *         without waiting for it to complete. The DMA engine does one
+     *         operation at a time, the previous one has to be waited for first.
+     *
+     * @param[in] index    - index of the staging buffer
      * @param[in] length   - length of the data to transfer
      * @param[in] address  - DMA address on the host
      * @param[in] upstream - indicates direction of the transfer; true indicates
@@ -59,20 +177,251 @@ class DMA
      *
      * @return returns 0 on success, negative errno on failure
      */
-    int transferDataHost(int fd, uint32_t offset, uint32_t length,
-                         uint64_t address, bool upstream);
+    int startTransfer(size_t index, uint32_t length, uint64_t address,
+                      bool upstream);
 
-    /** @brief API to transfer data on to unix socket from host using DMA
+    /** @brief Wait for the DMA operation of a staging buffer to complete
      *
-     * @param[in] path     - pathname of the file to transfer data from or to
-     * @param[in] length   - length of the data to transfer
-     * @param[in] address  - DMA address on the host
+     * @param[in] index - index of the staging buffer
      *
      * @return returns 0 on success, negative errno on failure
      */
-    int transferHostDataToSocket(int fd, uint32_t length, uint64_t address);
+    int waitTransfer(size_t index);
+
+  private:
+    /** @struct StagingBuffer
+     *
+     *  A staging buffer and the XDMA client it is mapped from
+     */
+    struct StagingBuffer
+    {
+        std::unique_ptr<pldm::utils::CustomFD> xdmaFd;
+        std::unique_ptr<void, std::function<void(void*)>> mapping;
+        std::span<uint8_t> data;
+    };
+
+    /** @brief Unmap the staging buffers if the session is idle
+     *
+     * @return the time left until the session is idle, std::nullopt if the
+     *         staging buffers are not mapped anymore
+     */
+    std::optional<std::chrono::microseconds> closeIdleSession();
+
+    std::vector<StagingBuffer> buffers;
+    StagingBuffer bounce;
+    std::recursive_mutex mutex;
+
+    /** @brief Set while requests deferred by the event loop wait for the
+     *         session, guarded by waitMutex
+     */
+    bool eventLoopWaiting = false;
+    std::mutex waitMutex;
+    std::condition_variable eventLoopServed;
+
+    /** @brief When the staging buffers were last used, guarded by mutex */
+    std::chrono::steady_clock::time_point lastUsed;
+
+    static constexpr std::chrono::seconds idleTimeout{
+        DMA_IDLE_TIMEOUT_SECONDS};
+
+    /** @brief Timer of the idle session, only used on the event loop */
+    std::unique_ptr<
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
+        idleTimer;
 };
 
+/** @brief The file I/O of a chunk transferred by DMA, reads the chunk from the
+ *         file into the staging buffer through the bounce buffer upstream, or
+ *         writes it from the staging buffer to the file downstream
+ *
+ * @param[in] fd          - file descriptor of the file
+ * @param[in] offset      - offset in the file of the transfer
+ * @param[in] upstream    - indicates direction of the transfer; true indicates
+ *                          transfer to the host
+ * @param[in] bounce      - page aligned buffer, at least as long as the chunk
+ * @param[in] buffer      - the staging buffer, as long as the chunk
+ * @param[in] chunkOffset - offset of the chunk in the transfer
+ *
+ * @return returns 0 on success, negative value on failure
+ */
+int transferFileChunk(int fd, uint32_t offset, bool upstream,
+                      std::span<uint8_t> bounce, std::span<uint8_t> buffer,
+                      uint32_t chunkOffset);
+
+/** @brief Write a chunk DMAed from the host to a unix socket, the socket is
+ *         closed on failure
+ *
+ * @param[in] fd          - the unix socket
+ * @param[in] buffer      - the staging buffer, as long as the chunk
+ * @param[in] chunkOffset - offset of the chunk in the transfer
+ *
+ * @return returns 0 on success, negative errno on failure
+ */
+int transferSocketChunk(int fd, std::span<uint8_t> buffer,
+                        uint32_t chunkOffset);
+
+/** @brief Transfer data between the BMC and the host in chunks of at most
+ *         maxSize, pipelining the file I/O with the DMA operations.
+ *
+ *  Upstream, the file I/O fills a staging buffer with the next chunk while the
+ *  previous chunk is DMAed to the host. Downstream, the next chunk is DMAed
+ *  from the host while the file I/O consumes the current one.
+ *
+ * @tparam[in] DMAInterface - DMA interface type
+ * @tparam[in] FileIO - callable int(std::span<uint8_t> buffer,
+ *                      uint32_t chunkOffset) filling the buffer with the data
+ *                      at chunkOffset upstream, or consuming it downstream and
+ *                      returning a negative value on failure
+ * @param[in] intf - interface passed to invoke DMA transfer
+ * @param[in] length   - length of the data to transfer
+ * @param[in] address  - DMA address on the host
+ * @param[in] upstream - indicates direction of the transfer; true indicates
+ *                       transfer to the host
+ * @param[in] fileIO - the file I/O of a chunk
+ *
+ * @return returns 0 on success, negative value on failure
+ */
+template <class DMAInterface, class FileIO>
+int transferData(DMAInterface* intf, uint32_t length, uint64_t address,
+                 bool upstream, FileIO&& fileIO)
+{
+    int count = intf->openSession();
+    if (count <= 0)
+    {
+        return count < 0 ? count : -ENOMEM;
+    }
+    size_t bufferCount = count;
+
+    auto chunkLength = [length](uint64_t chunkOffset) {
+        return static_cast<uint32_t>(
+            std::min<uint64_t>(maxSize, length - chunkOffset));
+    };
+    auto chunkBuffer = [intf, &chunkLength](size_t index,
+                                            uint64_t chunkOffset) {
+        return intf->getBuffer(index).first(chunkLength(chunkOffset));
+    };
+
+    // The DMA engine works on whole pages, the tail of the last page of a
+    // chunk is zeroed so no stale data of an earlier chunk goes to the host
+    static const size_t pageSize = getpagesize();
+    auto zeroPadding = [intf](size_t index, uint32_t length) {
+        auto buffer = intf->getBuffer(index);
+        auto padded = std::min<size_t>(
+            (length + pageSize - 1) / pageSize * pageSize, buffer.size());
+        std::fill(buffer.begin() + length, buffer.begin() + padded, 0);
+    };
+
+    // The staging buffer of the DMA operation started and not waited for yet
+    constexpr size_t noTransfer = std::numeric_limits<size_t>::max();
+    size_t inFlight = noTransfer;
+    auto wait = [intf, &inFlight]() {
+        auto rc = intf->waitTransfer(inFlight);
+        inFlight = noTransfer;
+        return rc;
+    };
+
+    int rc = 0;
+    size_t index = 0;
+    if (upstream)
+    {
+        for (uint64_t chunkOffset = 0; chunkOffset < length;
+             chunkOffset += maxSize, index = (index + 1) % bufferCount)
+        {
+            if (inFlight == index)
+            {
+                // Only one staging buffer, nothing to overlap with
+                rc = wait();
+                if (rc < 0)
+                {
+                    break;
+                }
+            }
+            rc = fileIO(chunkBuffer(index, chunkOffset),
+                        static_cast<uint32_t>(chunkOffset));
+            if (rc < 0)
+            {
+                break;
+            }
+            zeroPadding(index, chunkLength(chunkOffset));
+            if (inFlight != noTransfer)
+            {
+                rc = wait();
+                if (rc < 0)
+                {
+                    break;
+                }
+            }
+            rc = intf->startTransfer(index, chunkLength(chunkOffset),
+                                     address + chunkOffset, true);
+            if (rc < 0)
+            {
+                break;
+            }
+            inFlight = index;
+        }
+    }
+    else if (length)
+    {
+        rc = intf->startTransfer(index, chunkLength(0), address, false);
+        if (rc >= 0)
+        {
+            inFlight = index;
+        }
+        for (uint64_t chunkOffset = 0; rc >= 0 && chunkOffset < length;
+             chunkOffset += maxSize)
+        {
+            index = inFlight;
+            rc = wait();
+            if (rc < 0)
+            {
+                break;
+            }
+
+            auto nextOffset = chunkOffset + maxSize;
+            auto nextIndex = (index + 1) % bufferCount;
+            if (nextOffset < length && nextIndex != index)
+            {
+                rc = intf->startTransfer(nextIndex, chunkLength(nextOffset),
+                                         address + nextOffset, false);
+                if (rc < 0)
+                {
+                    break;
+                }
+                inFlight = nextIndex;
+            }
+
+            rc = fileIO(chunkBuffer(index, chunkOffset),
+                        static_cast<uint32_t>(chunkOffset));
+            if (rc < 0)
+            {
+                break;
+            }
+
+            if (nextOffset < length && inFlight == noTransfer)
+            {
+                rc = intf->startTransfer(nextIndex, chunkLength(nextOffset),
+                                         address + nextOffset, false);
+                if (rc >= 0)
+                {
+                    inFlight = nextIndex;
+                }
+            }
+        }
+    }
+
+    if (inFlight != noTransfer)
+    {
+        // The staging buffer may not be reused before the DMA is done
+        auto waitRc = wait();
+        if (rc >= 0)
+        {
+            rc = waitRc;
+        }
+    }
+
+    return rc < 0 ? rc : 0;
+}
+
 /** @brief Transfer the data between BMC and host using DMA.
  *
  *  There is a max size for each DMA operation, transferAll API abstracts this
@@ -124,23 +473,12 @@ Response transferAll(DMAInterface* intf, uint8_t command, fs::path& path,
     }
     pldm::utils::CustomFD fd(file);
 
-    while (length > dma::maxSize)
-    {
-        auto rc = intf->transferDataHost(fd(), offset, dma::maxSize, address,
-                                         upstream);
-        if (rc < 0)
-        {
-            encode_rw_file_memory_resp(instanceId, command, PLDM_ERROR, 0,
-                                       responsePtr);
-            return response;
-        }
-
-        offset += dma::maxSize;
-        length -= dma::maxSize;
-        address += dma::maxSize;
-    }
-
-    auto rc = intf->transferDataHost(fd(), offset, length, address, upstream);
+    auto fileIO = [intf, &fd, offset, upstream](std::span<uint8_t> buffer,
+                                                uint32_t chunkOffset) {
+        return transferFileChunk(fd(), offset, upstream,
+                                 intf->getBounceBuffer(), buffer, chunkOffset);
+    };
+    auto rc = transferData(intf, length, address, upstream, fileIO);
     if (rc < 0)
     {
         encode_rw_file_memory_resp(instanceId, command, PLDM_ERROR, 0,
@@ -175,23 +513,31 @@ class Handler : public CmdHandler
     {
         handlers.emplace(
             PLDM_READ_FILE_INTO_MEMORY,
-            [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
-            return this->readFileIntoMemory(request, payloadLength);
+            [this](pldm_tid_t tid, const pldm_msg* request,
+                   size_t payloadLength) {
+            return this->readFileIntoMemory(tid, request, payloadLength);
         });
         handlers.emplace(
             PLDM_WRITE_FILE_FROM_MEMORY,
-            [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
-            return this->writeFileFromMemory(request, payloadLength);
+            [this](pldm_tid_t tid, const pldm_msg* request,
+                   size_t payloadLength) {
+            return this->writeFileFromMemory(tid, request, payloadLength);
         });
         handlers.emplace(
             PLDM_WRITE_FILE_BY_TYPE_FROM_MEMORY,
-            [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
-            return this->writeFileByTypeFromMemory(request, payloadLength);
+            [this](pldm_tid_t tid, const pldm_msg* request,
+                   size_t payloadLength) {
+            return this->rwFileByTypeMemory(
+                tid, PLDM_WRITE_FILE_BY_TYPE_FROM_MEMORY, request,
+                payloadLength);
         });
         handlers.emplace(
             PLDM_READ_FILE_BY_TYPE_INTO_MEMORY,
-            [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
-            return this->readFileByTypeIntoMemory(request, payloadLength);
+            [this](pldm_tid_t tid, const pldm_msg* request,
+                   size_t payloadLength) {
+            return this->rwFileByTypeMemory(
+                tid, PLDM_READ_FILE_BY_TYPE_INTO_MEMORY, request,
+                payloadLength);
         });
         handlers.emplace(
             PLDM_READ_FILE_BY_TYPE,
@@ -318,21 +664,27 @@ class Handler : public CmdHandler
 
     /** @brief Handler for readFileIntoMemory command
      *
+     *  @param[in] tid - PLDM request TID
      *  @param[in] request - pointer to PLDM request payload
      *  @param[in] payloadLength - length of the message
      *
-     *  @return PLDM response message
+     *  @return PLDM response message, empty if the transfer was queued on the
+     *          I/O worker and the response is sent once it is done
      */
-    Response readFileIntoMemory(const pldm_msg* request, size_t payloadLength);
+    Response readFileIntoMemory(pldm_tid_t tid, const pldm_msg* request,
+                                size_t payloadLength);
 
     /** @brief Handler for writeFileIntoMemory command
      *
+     *  @param[in] tid - PLDM request TID
      *  @param[in] request - pointer to PLDM request payload
      *  @param[in] payloadLength - length of the message
      *
-     *  @return PLDM response message
+     *  @return PLDM response message, empty if the transfer was queued on the
+     *          I/O worker and the response is sent once it is done
      */
-    Response writeFileFromMemory(const pldm_msg* request, size_t payloadLength);
+    Response writeFileFromMemory(pldm_tid_t tid, const pldm_msg* request,
+                                 size_t payloadLength);
 
     /** @brief Handler for writeFileByTypeFromMemory command
      *
@@ -413,7 +765,67 @@ class Handler : public CmdHandler
      */
     Response newFileAvailable(const pldm_msg* request, size_t payloadLength);
 
+    /** @brief Let the I/O worker finish, the requests deferred by the event
+     *         loop are dropped
+     */
+    ~Handler()
+    {
+        dma::DMA::getSession().resumeWorker();
+    }
+
   private:
+    /** @brief Transfer a file table file between the BMC and the host. If
+     *         asynchronous responses can be sent, the transfer is queued on
+     *         the I/O worker, so that the event loop keeps serving other
+     *         requests.
+     *
+     *  @param[in] tid - PLDM request TID
+     *  @param[in] command - PLDM command
+     *  @param[in] path - path of the file
+     *  @param[in] offset - offset in the file
+     *  @param[in] length - length of the data to transfer
+     *  @param[in] address - DMA address on the host
+     *  @param[in] upstream - indicates direction of the transfer; true
+     *                        indicates transfer to the host
+     *  @param[in] instanceId - instance id of the request
+     *
+     *  @return PLDM response message, empty if the transfer was queued
+     */
+    Response transferFile(pldm_tid_t tid, uint8_t command,
+                          const std::filesystem::path& path, uint32_t offset,
+                          uint32_t length, uint64_t address, bool upstream,
+                          uint8_t instanceId);
+
+    /** @brief Serve a ReadFileByTypeIntoMemory or WriteFileByTypeFromMemory
+     *         request. If the I/O worker holds the DMA session, the request
+     *         is deferred until the worker is done with its transfer.
+     *
+     *  @param[in] tid - PLDM request TID
+     *  @param[in] command - PLDM command
+     *  @param[in] request - PLDM request msg
+     *  @param[in] payloadLength - length of the message payload
+     *
+     *  @return PLDM response message, empty if the request was deferred
+     */
+    Response rwFileByTypeMemory(pldm_tid_t tid, uint8_t command,
+                                const pldm_msg* request, size_t payloadLength);
+
+    /** @brief Serve the deferred requests, once the I/O worker is done with
+     *         a transfer
+     */
+    void serveDeferredRequests();
+
+    /** @struct DeferredRequest
+     *
+     *  A request waiting for the DMA session held by the I/O worker
+     */
+    struct DeferredRequest
+    {
+        pldm_tid_t tid;
+        uint8_t command;
+        std::vector<uint8_t> message;
+    };
+
     oem_platform::Handler* oemPlatformHandler;
     int hostSockFd;
     uint8_t hostEid;
@@ -433,6 +845,16 @@ class Handler : public CmdHandler
     pldm::requester::Handler<pldm::requester::Request>* handler;
     std::vector<std::unique_ptr<pldm::requester::oem_ibm::DbusToFileHandler>>
         dbusToFileHandlers;
+
+    /** @brief I/O worker running the file table DMA transfers, started on the
+     *         first transfer
+     */
+    std::unique_ptr<dma::Worker> worker;
+
+    /** @brief Requests deferred while the I/O worker holds the DMA session,
+     *         in the order they were received
+     */
+    std::deque<DeferredRequest> deferredRequests;
 };
 
 } // namespace oem_ibm
@@ -21,6 +21,7 @@
 #include <exception>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <vector>
 
 PHOSPHOR_LOG2_USING;
@@ -34,40 +35,42 @@ using namespace sdbusplus::xyz::openbmc_project::Common::Error;
 int FileHandler::transferFileData(int32_t fd, bool upstream, uint32_t offset,
                                   uint32_t& length, uint64_t address)
 {
-    dma::DMA xdmaInterface;
-    while (length > dma::maxSize)
+    auto& session = dma::DMA::getSession();
+    auto lock = session.tryLock();
+    if (!lock.owns_lock())
     {
-        auto rc = xdmaInterface.transferDataHost(fd, offset, dma::maxSize,
-                                                 address, upstream);
-        if (rc < 0)
-        {
-            return PLDM_ERROR;
-        }
-        offset += dma::maxSize;
-        length -= dma::maxSize;
-        address += dma::maxSize;
+        // The by-type memory requests are deferred until the session is
+        // free, this is only reached when called from elsewhere
+        return PLDM_ERROR_NOT_READY;
     }
-    auto rc = xdmaInterface.transferDataHost(fd, offset, length, address,
-                                             upstream);
+    auto rc = dma::transferData(
+        &session, length, address, upstream,
+        [&session, fd, offset, upstream](std::span<uint8_t> buffer,
+                                         uint32_t chunkOffset) {
+        return dma::transferFileChunk(fd, offset, upstream,
+                                      session.getBounceBuffer(), buffer,
+                                      chunkOffset);
+    });
+    lock.unlock();
+    session.watchIdle();
     return rc < 0 ? PLDM_ERROR : PLDM_SUCCESS;
 }
 
 int FileHandler::transferFileDataToSocket(int32_t fd, uint32_t& length,
                                           uint64_t address)
 {
-    dma::DMA xdmaInterface;
-    while (length > dma::maxSize)
+    auto& session = dma::DMA::getSession();
+    auto lock = session.tryLock();
+    if (!lock.owns_lock())
     {
-        auto rc = xdmaInterface.transferHostDataToSocket(fd, dma::maxSize,
-                                                         address);
-        if (rc < 0)
-        {
-            return PLDM_ERROR;
-        }
-        length -= dma::maxSize;
-        address += dma::maxSize;
+        // The by-type memory requests are deferred until the session is
+        // free, this is only reached when called from elsewhere
+        return PLDM_ERROR_NOT_READY;
     }
-    auto rc = xdmaInterface.transferHostDataToSocket(fd, length, address);
+    auto rc = dma::transferData(&session, length, address, false,
+                                std::bind_front(dma::transferSocketChunk, fd));
+    lock.unlock();
+    session.watchIdle();
     return rc < 0 ? PLDM_ERROR : PLDM_SUCCESS;
 }
 
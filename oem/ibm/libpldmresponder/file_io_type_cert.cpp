@@ -61,6 +61,10 @@ int CertHandler::readIntoMemory(uint32_t offset, uint32_t length,
         return PLDM_ERROR_INVALID_DATA;
     }
     auto rc = transferFileData(filePath.c_str(), true, offset, length, address);
+    if (rc == PLDM_ERROR_NOT_READY)
+    {
+        return rc;
+    }
     fs::remove(filePath);
     if (rc)
     {
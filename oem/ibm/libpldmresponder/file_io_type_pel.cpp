@@ -6,17 +6,22 @@
 #include <libpldm/base.h>
 #include <libpldm/oem/ibm/file_io.h>
 #include <stdint.h>
+#include <sys/stat.h>
 #include <systemd/sd-bus.h>
 #include <unistd.h>
 
 #include <org/open_power/Logging/PEL/server.hpp>
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/server.hpp>
+#include <sdeventplus/event.hpp>
 #include <xyz/openbmc_project/Logging/Entry/server.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <exception>
 #include <filesystem>
 #include <fstream>
+#include <system_error>
 #include <vector>
 
 PHOSPHOR_LOG2_USING;
@@ -90,26 +95,112 @@ Entry::Level getEntryLevelFromPEL(const std::string& pelFileName)
 }
 } // namespace detail
 
+static constexpr auto logObjPath = "/xyz/openbmc_project/logging";
+static constexpr auto logInterface = "org.open_power.Logging.PEL";
+
+/** @brief Number of PELs the host may read at the same time without their
+ *         fds being reopened
+ */
+static constexpr size_t maxCachedPels = 4;
+
+/** @brief Time after which the fd of a PEL that is not read anymore, and that
+ *         was never acked, is closed
+ */
+static constexpr std::chrono::seconds pelIdleTimeout{30};
+
+PelFdCache PelHandler::pelFds(
+    [](uint32_t pelId) {
+    auto& bus = pldm::utils::DBusHandler::getBus();
+    auto service = pldm::utils::DBusHandler().getService(logObjPath,
+                                                         logInterface);
+    auto method = bus.new_method_call(service.c_str(), logObjPath,
+                                      logInterface, "GetPEL");
+    method.append(pelId);
+    auto reply = bus.call(method, dbusTimeout);
+    sdbusplus::message::unix_fd fd{};
+    reply.read(fd);
+
+    // The fd received is owned by the reply
+    int pelFd = dup(fd);
+    if (pelFd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to dup PEL fd");
+    }
+    return pelFd;
+},
+    maxCachedPels, pelIdleTimeout);
+
+int PelFdCache::get(uint32_t pelId)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [pelId](const auto& entry) {
+        return entry.pelId == pelId;
+    });
+    if (it == entries.end())
+    {
+        auto fd = std::make_unique<pldm::utils::CustomFD>(getPel(pelId));
+        if (entries.size() >= capacity)
+        {
+            entries.pop_back();
+        }
+        entries.push_front(Entry{pelId, std::move(fd), now});
+    }
+    else
+    {
+        it->lastUsed = now;
+        entries.splice(entries.begin(), entries, it);
+    }
+
+    if (!idleTimer)
+    {
+        idleTimer = std::make_unique<
+            sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>(
+            sdeventplus::Event::get_default(), [this](auto&) { expire(); });
+    }
+    if (!idleTimer->isEnabled())
+    {
+        idleTimer->restartOnce(idleTimeout);
+    }
+
+    return (*entries.front().fd)();
+}
+
+void PelFdCache::release(uint32_t pelId)
+{
+    std::erase_if(entries,
+                  [pelId](const auto& entry) { return entry.pelId == pelId; });
+}
+
+void PelFdCache::expire()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::erase_if(entries, [this, now](const auto& entry) {
+        return now - entry.lastUsed >= idleTimeout;
+    });
+
+    if (!entries.empty())
+    {
+        // The least recently used fd is the next one to expire
+        idleTimer->restartOnce(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                entries.back().lastUsed + idleTimeout - now));
+    }
+}
+
 int PelHandler::readIntoMemory(uint32_t offset, uint32_t length,
                                uint64_t address,
                                oem_platform::Handler* /*oemPlatformHandler*/)
 {
-    static constexpr auto logObjPath = "/xyz/openbmc_project/logging";
-    static constexpr auto logInterface = "org.open_power.Logging.PEL";
-
-    auto& bus = pldm::utils::DBusHandler::getBus();
-
     try
     {
-        auto service = pldm::utils::DBusHandler().getService(logObjPath,
-                                                             logInterface);
-        auto method = bus.new_method_call(service.c_str(), logObjPath,
-                                          logInterface, "GetPEL");
-        method.append(fileHandle);
-        auto reply = bus.call(method, dbusTimeout);
-        sdbusplus::message::unix_fd fd{};
-        reply.read(fd);
-        auto rc = transferFileData(fd, true, offset, length, address);
+        auto rc = transferFileData(pelFds.get(fileHandle), true, offset,
+                                   length, address);
+        if (rc != PLDM_SUCCESS && rc != PLDM_ERROR_NOT_READY)
+        {
+            pelFds.release(fileHandle);
+        }
         return rc;
     }
     catch (const std::exception& e)
@@ -126,27 +217,18 @@ int PelHandler::readIntoMemory(uint32_t offset, uint32_t length,
 int PelHandler::read(uint32_t offset, uint32_t& length, Response& response,
                      oem_platform::Handler* /*oemPlatformHandler*/)
 {
-    static constexpr auto logObjPath = "/xyz/openbmc_project/logging";
-    static constexpr auto logInterface = "org.open_power.Logging.PEL";
-    auto& bus = pldm::utils::DBusHandler::getBus();
-
     try
     {
-        auto service = pldm::utils::DBusHandler().getService(logObjPath,
-                                                             logInterface);
-        auto method = bus.new_method_call(service.c_str(), logObjPath,
-                                          logInterface, "GetPEL");
-        method.append(fileHandle);
-        auto reply = bus.call(method, dbusTimeout);
-        sdbusplus::message::unix_fd fd{};
-        reply.read(fd);
-
-        off_t fileSize = lseek(fd, 0, SEEK_END);
-        if (fileSize == -1)
+        auto fd = pelFds.get(fileHandle);
+
+        struct stat sb;
+        if (fstat(fd, &sb) == -1)
         {
-            error("File lseek failed");
+            error("File fstat failed");
+            pelFds.release(fileHandle);
             return PLDM_ERROR;
         }
+        off_t fileSize = sb.st_size;
         if (offset >= fileSize)
         {
             error(
@@ -158,23 +240,17 @@ int PelHandler::read(uint32_t offset, uint32_t& length, Response& response,
         {
             length = fileSize - offset;
         }
-        auto rc = lseek(fd, offset, SEEK_SET);
-        if (rc == -1)
-        {
-            error("Failed to do file lseek at offset '{OFFSET}'", "OFFSET",
-                  offset);
-            return PLDM_ERROR;
-        }
         size_t currSize = response.size();
         response.resize(currSize + length);
         auto filePos = reinterpret_cast<char*>(response.data());
         filePos += currSize;
-        rc = ::read(fd, filePos, length);
+        auto rc = pread(fd, filePos, length, offset);
         if (rc == -1)
         {
             error(
                 "Failed to do file read of length '{LENGTH}' at offset '{OFFSET}'",
-                "LENGTH", length, "OFFSET", filePos);
+                "LENGTH", length, "OFFSET", offset);
+            pelFds.release(fileHandle);
             return PLDM_ERROR;
         }
         if (rc != length)
@@ -182,6 +258,7 @@ int PelHandler::read(uint32_t offset, uint32_t& length, Response& response,
             error(
                 "Mismatch between number of characters to read and the read length '{LENGTH}' and count '{RC}'",
                 "LENGTH", length, "RC", rc);
+            pelFds.release(fileHandle);
             return PLDM_ERROR;
         }
     }
@@ -220,8 +297,9 @@ int PelHandler::writeFromMemory(uint32_t offset, uint32_t length,
 
 int PelHandler::fileAck(uint8_t fileStatus)
 {
-    static constexpr auto logObjPath = "/xyz/openbmc_project/logging";
-    static constexpr auto logInterface = "org.open_power.Logging.PEL";
+    // The host is done reading the PEL
+    pelFds.release(fileHandle);
+
     static std::string service;
     auto& bus = pldm::utils::DBusHandler::getBus();
 
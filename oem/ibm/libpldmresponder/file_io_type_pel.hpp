@@ -1,12 +1,95 @@
 #pragma once
 
+#include "common/utils.hpp"
 #include "file_io_by_type.hpp"
 
+#include <sdeventplus/utility/timer.hpp>
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+
 namespace pldm
 {
 namespace responder
 {
 
+/** @class PelFdCache
+ *
+ *  @brief Keeps the fds of the PELs the host is reading, so that reading a
+ *  PEL in chunks costs a single GetPEL D-Bus call. The least recently used fd
+ *  is closed when the cache is full, the fd of a PEL is closed once the host
+ *  acks the PEL or once it has not been read for idleTimeout.
+ */
+class PelFdCache
+{
+  public:
+    /** @brief Gets a new fd of a PEL, throws on failure */
+    using GetPel = std::function<int(uint32_t pelId)>;
+
+    /** @brief PelFdCache constructor
+     *
+     *  @param[in] getPel - gets a new fd of a PEL
+     *  @param[in] capacity - maximum number of PEL fds kept open
+     *  @param[in] idleTimeout - time after which an unused fd is closed
+     */
+    PelFdCache(GetPel&& getPel, size_t capacity,
+               std::chrono::milliseconds idleTimeout) :
+        getPel(std::move(getPel)),
+        capacity(capacity), idleTimeout(idleTimeout)
+    {}
+
+    /** @brief Get the fd of a PEL, opening it if it is not cached. The fd is
+     *         shared by all the reads of the PEL, it must be read with pread.
+     *
+     *  @param[in] pelId - the PEL ID
+     *
+     *  @return the fd, owned by the cache
+     */
+    int get(uint32_t pelId);
+
+    /** @brief Close the fd of a PEL, if cached
+     *
+     *  @param[in] pelId - the PEL ID
+     */
+    void release(uint32_t pelId);
+
+    /** @brief Get the number of PEL fds kept open */
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+  private:
+    /** @brief Close the fds not used for idleTimeout, and arm the timer for
+     *         the next one to expire
+     */
+    void expire();
+
+    /** @struct Entry
+     *
+     *  The fd of a PEL and when it was last used
+     */
+    struct Entry
+    {
+        uint32_t pelId;
+        std::unique_ptr<pldm::utils::CustomFD> fd;
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+
+    GetPel getPel;
+    size_t capacity;
+    std::chrono::milliseconds idleTimeout;
+
+    /** @brief The cached fds, most recently used first */
+    std::list<Entry> entries;
+
+    std::unique_ptr<
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
+        idleTimer;
+};
+
 /** @class PelHandler
  *
  *  @brief Inherits and implements FileHandler. This class is used
@@ -51,6 +134,10 @@ class PelHandler : public FileHandler
     /** @brief PelHandler destructor
      */
     ~PelHandler() {}
+
+  private:
+    /** @brief The fds of the PELs being read by the host */
+    static PelFdCache pelFds;
 };
 
 } // namespace responder
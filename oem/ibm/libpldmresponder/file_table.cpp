@@ -1,6 +1,10 @@
 #include "file_table.hpp"
 
+#include <fcntl.h>
 #include <libpldm/utils.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <phosphor-logging/lg2.hpp>
 
@@ -30,6 +34,18 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
         return;
     }
 
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        error(
+            "Failed to watch the file table files, error number - {ERROR_NUM}",
+            "ERROR_NUM", errno);
+    }
+    else
+    {
+        inotifyFd = std::make_unique<pldm::utils::CustomFD>(fd);
+    }
+
     uint16_t fileNameLength = 0;
     uint32_t fileSize = 0;
     uint32_t traits = 0;
@@ -88,6 +104,7 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
                     fileNameLength, iter);
         std::advance(iter, fileNameLength);
 
+        sizeOffsets.emplace(handle, std::distance(fileTable.begin(), iter));
         std::copy_n(reinterpret_cast<uint8_t*>(&fileSize), sizeof(fileSize),
                     iter);
         std::advance(iter, sizeof(fileSize));
@@ -100,10 +117,14 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
         entry.handle = handle;
         entry.fsPath = std::move(fsPath);
         entry.traits.value = traits;
+        entry.size = fileSize;
 
         // Insert the file entries in the map
-        tableEntries.emplace(handle, std::move(entry));
+        auto& inserted = tableEntries.emplace(handle, std::move(entry))
+                             .first->second;
         handle++;
+
+        open(inserted);
     }
 
     constexpr uint8_t padWidth = 4;
@@ -119,8 +140,166 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
     checkSum = crc32(fileTable.data(), fileTable.size());
 }
 
-Table FileTable::operator()() const
+void FileTable::open(FileEntry& entry)
+{
+    int fd = ::open(entry.fsPath.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0 && (errno == EACCES || errno == EROFS))
+    {
+        fd = ::open(entry.fsPath.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0)
+    {
+        error(
+            "Failed to open file table file '{PATH}', error number - {ERROR_NUM}",
+            "PATH", entry.fsPath, "ERROR_NUM", errno);
+        return;
+    }
+    entry.fd = std::make_shared<pldm::utils::CustomFD>(fd);
+
+    if (inotifyFd)
+    {
+        int wd = inotify_add_watch(
+            (*inotifyFd)(), entry.fsPath.c_str(),
+            IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF |
+                IN_DELETE_SELF);
+        if (wd < 0)
+        {
+            error(
+                "Failed to watch file table file '{PATH}', error number - {ERROR_NUM}",
+                "PATH", entry.fsPath, "ERROR_NUM", errno);
+        }
+        else
+        {
+            watches[wd] = entry.handle;
+        }
+    }
+
+    // The file may have been replaced between the open and the watch
+    revalidate(entry);
+}
+
+void FileTable::revalidate(FileEntry& entry)
+{
+    if (!entry.fd)
+    {
+        return;
+    }
+
+    struct stat sb;
+    if (fstat((*entry.fd)(), &sb) < 0 || sb.st_nlink == 0)
+    {
+        close(entry);
+        return;
+    }
+    updateSize(entry, static_cast<uint32_t>(sb.st_size));
+}
+
+void FileTable::close(FileEntry& entry)
 {
+    entry.fd.reset();
+    for (auto it = watches.begin(); it != watches.end(); ++it)
+    {
+        if (it->second == entry.handle)
+        {
+            inotify_rm_watch((*inotifyFd)(), it->first);
+            watches.erase(it);
+            break;
+        }
+    }
+}
+
+void FileTable::updateSize(FileEntry& entry, uint32_t size)
+{
+    if (entry.size == size)
+    {
+        return;
+    }
+    entry.size = size;
+
+    auto offset = sizeOffsets.find(entry.handle);
+    if (offset != sizeOffsets.end())
+    {
+        std::copy_n(reinterpret_cast<const uint8_t*>(&size), sizeof(size),
+                    fileTable.begin() + offset->second);
+        checkSum = crc32(fileTable.data(), fileTable.size());
+    }
+}
+
+void FileTable::refresh()
+{
+    if (!inotifyFd)
+    {
+        return;
+    }
+
+    alignas(struct inotify_event) char buffer[4096];
+    while (true)
+    {
+        auto length = read((*inotifyFd)(), buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            if (length < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        for (char* ptr = buffer; ptr < buffer + length;)
+        {
+            auto event = reinterpret_cast<const struct inotify_event*>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            auto watch = watches.find(event->wd);
+            if (watch == watches.end())
+            {
+                continue;
+            }
+            auto& entry = tableEntries.at(watch->second);
+            if (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED))
+            {
+                // The path no longer names the open file, it is reopened
+                // on the next lookup
+                close(entry);
+                continue;
+            }
+            revalidate(entry);
+        }
+    }
+}
+
+FileEntry FileTable::at(Handle handle)
+{
+    auto& entry = tableEntries.at(handle);
+    refresh();
+    if (!entry.fd)
+    {
+        open(entry);
+    }
+    else if (!inotifyFd)
+    {
+        // Without inotify only the file being looked up is checked
+        revalidate(entry);
+    }
+    return entry;
+}
+
+Table FileTable::operator()()
+{
+    refresh();
+    for (auto& [handle, entry] : tableEntries)
+    {
+        if (!entry.fd)
+        {
+            open(entry);
+        }
+        else if (!inotifyFd)
+        {
+            // The table carries the size of every file
+            revalidate(entry);
+        }
+    }
+
     Table table(fileTable);
     table.resize(fileTable.size() + sizeof(checkSum));
     auto iter = table.begin() + fileTable.size();
@@ -1,11 +1,15 @@
 #pragma once
 
+#include "common/utils.hpp"
+
 #include <libpldm/pldm_types.h>
 #include <stdint.h>
 
 #include <nlohmann/json.hpp>
 
 #include <filesystem>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace pldm
@@ -31,6 +35,9 @@ struct FileEntry
     Handle handle;       //!< File handle
     fs::path fsPath;     //!< File path
     bitfield32_t traits; //!< File traits
+    std::shared_ptr<pldm::utils::CustomFD> fd; //!< Open file, null if the
+                                               //!< file could not be opened
+    uint32_t size = 0;                         //!< Current file size
 };
 
 /** @class FileTable
@@ -40,6 +47,10 @@ struct FileEntry
  *  file handle and extract the file attribute table. The file attribute table
  *  comprises of metadata for files. Metadata includes the file handle, file
  *  name, current file size and file traits.
+ *
+ *  The files are kept open, and their sizes are kept up to date by watching
+ *  them with inotify. The pending inotify events are processed on every
+ *  lookup, so a lookup costs a single non-blocking read when no file changed.
  */
 class FileTable
 {
@@ -53,27 +64,32 @@ class FileTable
     FileTable(const std::string& fileTableConfigPath);
     FileTable() = default;
     ~FileTable() = default;
-    FileTable(const FileTable&) = default;
-    FileTable& operator=(const FileTable&) = default;
+    FileTable(const FileTable&) = delete;
+    FileTable& operator=(const FileTable&) = delete;
     FileTable(FileTable&&) = default;
     FileTable& operator=(FileTable&&) = default;
 
-    /** @brief Get the file attribute table
+    /** @brief Get the file attribute table, with the current file sizes
      *
      * @return Table- contents of the file attribute table
      */
-    Table operator()() const;
+    Table operator()();
 
-    /** @brief Get the FileEntry at the file handle
+    /** @brief Get the FileEntry at the file handle, the file is reopened if
+     *         it was replaced or removed since it was last looked up
      *
      * @param[in] handle - file handle
      *
      * @return FileEntry - file entry at the handle
      */
-    FileEntry at(Handle handle) const
-    {
-        return tableEntries.at(handle);
-    }
+    FileEntry at(Handle handle);
+
+    /** @brief Process the pending inotify events, refreshing the sizes of the
+     *         files that changed and closing the files that were replaced or
+     *         removed, without inotify the entries are instead
+     *         revalidated when they are looked up
+     */
+    void refresh();
 
     /** @brief Check is file attribute table is empty
      *
@@ -93,9 +109,38 @@ class FileTable
         fileTable.clear();
         padCount = 0;
         checkSum = 0;
+        sizeOffsets.clear();
+        watches.clear();
+        inotifyFd.reset();
     }
 
   private:
+    /** @brief Open the file of an entry and watch it, and refresh its size
+     *
+     * @param[in] entry - the file entry
+     */
+    void open(FileEntry& entry);
+
+    /** @brief Refresh the size of the file of an entry from its descriptor,
+     *         the file is closed if it was removed
+     *
+     * @param[in] entry - the file entry
+     */
+    void revalidate(FileEntry& entry);
+
+    /** @brief Close the file of an entry and stop watching it
+     *
+     * @param[in] entry - the file entry
+     */
+    void close(FileEntry& entry);
+
+    /** @brief Update the size of a file in the file attribute table
+     *
+     * @param[in] entry - the file entry
+     * @param[in] size - the file size
+     */
+    void updateSize(FileEntry& entry, uint32_t size);
+
     /** @brief handle to FileEntry mappings for lookups based on file handle */
     std::unordered_map<Handle, FileEntry> tableEntries;
 
@@ -109,6 +154,19 @@ class FileTable
 
     /** @brief the checksum of the file attribute table */
     uint32_t checkSum = 0;
+
+    /** @brief offset of the file size of each file in the file attribute
+     *         table
+     */
+    std::unordered_map<Handle, size_t> sizeOffsets;
+
+    /** @brief inotify instance watching the files, null if inotify is not
+     *         available and the files are checked on every lookup instead
+     */
+    std::unique_ptr<pldm::utils::CustomFD> inotifyFd;
+
+    /** @brief inotify watch descriptor to file handle mappings */
+    std::unordered_map<int, Handle> watches;
 };
 
 /** @brief Build the file attribute table if not already built using the
@@ -11,11 +11,19 @@
 
 #include <libpldm/base.h>
 #include <libpldm/oem/ibm/file_io.h>
+#include <sys/mman.h>
 
 #include <nlohmann/json.hpp>
+#include <sdeventplus/event.hpp>
 
+#include <chrono>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <optional>
+#include <span>
+#include <tuple>
 
 #include <gmock/gmock-matchers.h>
 #include <gmock/gmock.h>
@@ -97,11 +105,101 @@ namespace responder
 namespace dma
 {
 
-class MockDMA
+/** @class FakeDMA
+ *
+ *  Fake XDMA device, the host memory and the staging buffers are memfds. Like
+ *  the DMA engine it does one operation at a time.
+ */
+class FakeDMA
 {
   public:
-    MOCK_METHOD5(transferDataHost, int(int fd, uint32_t offset, uint32_t length,
-                                       uint64_t address, bool upstream));
+    FakeDMA(size_t bufferCount, size_t hostMemorySize) :
+        bufferCount(bufferCount), hostFd(memfd_create("host", 0)),
+        stagingFd(memfd_create("staging", 0))
+    {
+        EXPECT_EQ(ftruncate(hostFd(), hostMemorySize), 0);
+        EXPECT_EQ(ftruncate(stagingFd(), bufferCount * maxSize), 0);
+        staging = static_cast<uint8_t*>(mmap(nullptr, bufferCount * maxSize,
+                                             PROT_READ | PROT_WRITE,
+                                             MAP_SHARED, stagingFd(), 0));
+        EXPECT_NE(staging, MAP_FAILED);
+    }
+
+    ~FakeDMA()
+    {
+        munmap(staging, bufferCount * maxSize);
+    }
+
+    int openSession()
+    {
+        return bufferCount;
+    }
+
+    std::span<uint8_t> getBuffer(size_t index)
+    {
+        EXPECT_LT(index, bufferCount);
+        return {staging + index * maxSize, maxSize};
+    }
+
+    std::span<uint8_t> getBounceBuffer()
+    {
+        return bounce;
+    }
+
+    int startTransfer(size_t index, uint32_t length, uint64_t address,
+                      bool upstream)
+    {
+        EXPECT_FALSE(inFlight.has_value());
+        transfers.emplace_back(index, length, address, upstream);
+        if (failTransfer == transfers.size())
+        {
+            return -EIO;
+        }
+
+        auto buffer = getBuffer(index).data();
+        auto rc = upstream ? pwrite(hostFd(), buffer, length, address)
+                           : pread(hostFd(), buffer, length, address);
+        EXPECT_EQ(rc, length);
+        inFlight = index;
+        return 0;
+    }
+
+    int waitTransfer(size_t index)
+    {
+        EXPECT_EQ(inFlight, index);
+        inFlight.reset();
+        return 0;
+    }
+
+    std::vector<uint8_t> readHostMemory(uint64_t address, size_t length)
+    {
+        std::vector<uint8_t> data(length);
+        EXPECT_EQ(pread(hostFd(), data.data(), length, address), length);
+        return data;
+    }
+
+    void writeHostMemory(uint64_t address, const std::vector<uint8_t>& data)
+    {
+        EXPECT_EQ(pwrite(hostFd(), data.data(), data.size(), address),
+                  data.size());
+    }
+
+    size_t bufferCount;
+    pldm::utils::CustomFD hostFd;
+    pldm::utils::CustomFD stagingFd;
+    uint8_t* staging = nullptr;
+    std::vector<uint8_t> bounce = std::vector<uint8_t>(maxSize);
+
+    /** @brief Staging buffer of the DMA operation in progress */
+    std::optional<size_t> inFlight;
+
+    /** @brief Staging buffer, length, host address and direction of the DMA
+     *         operations started
+     */
+    std::vector<std::tuple<size_t, uint32_t, uint64_t, bool>> transfers;
+
+    /** @brief Fail the n-th DMA operation, counting from 1 */
+    size_t failTransfer = 0;
 };
 
 } // namespace dma
@@ -109,99 +207,378 @@ class MockDMA
 } // namespace pldm
 using namespace pldm::responder;
 using ::testing::_;
+using ::testing::ElementsAre;
 using ::testing::Return;
 
+static std::vector<uint8_t> makeFile(const fs::path& path, size_t size)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        data[i] = static_cast<uint8_t>(i * 7 + i / 4096);
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return data;
+}
+
 TEST(TransferDataHost, GoodPath)
 {
     using namespace pldm::responder::dma;
 
-    MockDMA dmaObj;
     char tmpfile[] = "/tmp/pldm_fileio_table.XXXXXX";
     int fd = mkstemp(tmpfile);
     close(fd);
     fs::path path(tmpfile);
-
-    // Minimum length of 16 and expect transferDataHost to be called once
-    // returns the default value of 0 (the return type of transferDataHost is
-    // int, the default value for int is 0)
+    auto data = makeFile(path, 3 * maxSize);
+    auto fileData = [&data](uint32_t offset, uint32_t length) {
+        return std::vector<uint8_t>(data.begin() + offset,
+                                    data.begin() + offset + length);
+    };
+
+    // Minimum length of 16 is one DMA operation
+    FakeDMA dmaObj(numBuffers, 3 * maxSize);
     uint32_t length = minSize;
-    EXPECT_CALL(dmaObj, transferDataHost(_, 0, length, 0, true)).Times(1);
-    auto response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY,
+    auto response = transferAll<FakeDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY,
                                          path, 0, length, 0, true, 0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
     ASSERT_EQ(0, memcmp(responsePtr->payload + sizeof(responsePtr->payload[0]),
                         &length, sizeof(length)));
+    EXPECT_THAT(dmaObj.transfers,
+                ElementsAre(std::make_tuple(0, length, 0, true)));
+    EXPECT_EQ(dmaObj.readHostMemory(0, length), fileData(0, length));
 
     // maxsize of DMA
+    dmaObj.transfers.clear();
     length = maxSize;
-    EXPECT_CALL(dmaObj, transferDataHost(_, 0, length, 0, true)).Times(1);
-    response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+    response = transferAll<FakeDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
                                     0, length, 0, true, 0);
     responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
     ASSERT_EQ(0, memcmp(responsePtr->payload + sizeof(responsePtr->payload[0]),
                         &length, sizeof(length)));
+    EXPECT_THAT(dmaObj.transfers,
+                ElementsAre(std::make_tuple(0, length, 0, true)));
+    EXPECT_EQ(dmaObj.readHostMemory(0, length), fileData(0, length));
 
-    // length greater than maxsize of DMA
+    // length greater than maxsize of DMA, from an offset in the file
+    dmaObj.transfers.clear();
     length = maxSize + minSize;
-    EXPECT_CALL(dmaObj, transferDataHost(_, 0, maxSize, 0, true)).Times(1);
-    EXPECT_CALL(dmaObj, transferDataHost(_, maxSize, minSize, maxSize, true))
-        .Times(1);
-    response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
-                                    0, length, 0, true, 0);
+    response = transferAll<FakeDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+                                    minSize, length, 0, true, 0);
     responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
     ASSERT_EQ(0, memcmp(responsePtr->payload + sizeof(responsePtr->payload[0]),
                         &length, sizeof(length)));
+    EXPECT_THAT(dmaObj.transfers,
+                ElementsAre(std::make_tuple(0, maxSize, 0, true),
+                            std::make_tuple(1, minSize, maxSize, true)));
+    EXPECT_EQ(dmaObj.readHostMemory(0, length), fileData(minSize, length));
 
     // length greater than 2*maxsize of DMA
+    dmaObj.transfers.clear();
     length = 3 * maxSize;
-    EXPECT_CALL(dmaObj, transferDataHost(_, _, _, _, true)).Times(3);
-    response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+    response = transferAll<FakeDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
                                     0, length, 0, true, 0);
     responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
     ASSERT_EQ(0, memcmp(responsePtr->payload + sizeof(responsePtr->payload[0]),
                         &length, sizeof(length)));
+    EXPECT_EQ(dmaObj.transfers.size(), 3);
+    EXPECT_EQ(dmaObj.readHostMemory(0, length), data);
 
     // check for downstream(copy data from host to BMC) parameter
-    length = minSize;
-    EXPECT_CALL(dmaObj, transferDataHost(_, 0, length, 0, false)).Times(1);
-    response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
-                                    0, length, 0, false, 0);
+    dmaObj.transfers.clear();
+    length = maxSize + minSize;
+    std::vector<uint8_t> hostData(length, 0x5a);
+    dmaObj.writeHostMemory(minSize, hostData);
+    response = transferAll<FakeDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+                                    0, length, minSize, false, 0);
     responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
     ASSERT_EQ(0, memcmp(responsePtr->payload + sizeof(responsePtr->payload[0]),
                         &length, sizeof(length)));
+    EXPECT_THAT(dmaObj.transfers,
+                ElementsAre(std::make_tuple(0, maxSize, minSize, false),
+                            std::make_tuple(1, minSize, maxSize + minSize,
+                                            false)));
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> written(length);
+    file.read(reinterpret_cast<char*>(written.data()), written.size());
+    EXPECT_EQ(written, hostData);
+
+    fs::remove(path);
 }
 
 TEST(TransferDataHost, BadPath)
 {
     using namespace pldm::responder::dma;
 
-    MockDMA dmaObj;
     char tmpfile[] = "/tmp/pldm_fileio_table.XXXXXX";
     int fd = mkstemp(tmpfile);
     close(fd);
     fs::path path(tmpfile);
+    makeFile(path, maxSize + minSize);
 
-    // Minimum length of 16 and transferDataHost returning a negative errno
+    // Minimum length of 16 and the DMA operation failing
+    FakeDMA dmaObj(numBuffers, maxSize + minSize);
+    dmaObj.failTransfer = 1;
     uint32_t length = minSize;
-    EXPECT_CALL(dmaObj, transferDataHost(_, _, _, _, _)).WillOnce(Return(-1));
-    auto response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY,
+    auto response = transferAll<FakeDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY,
                                          path, 0, length, 0, true, 0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR);
 
-    // length greater than maxsize of DMA and transferDataHost returning a
-    // negative errno
+    // length greater than maxsize of DMA and the second DMA operation failing,
+    // the first one is waited for before returning
+    dmaObj.transfers.clear();
+    dmaObj.failTransfer = 2;
     length = maxSize + minSize;
-    EXPECT_CALL(dmaObj, transferDataHost(_, _, _, _, _)).WillOnce(Return(-1));
-    response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+    response = transferAll<FakeDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
                                     0, length, 0, true, 0);
     responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR);
+    EXPECT_FALSE(dmaObj.inFlight.has_value());
+
+    // Reading beyond the end of the file
+    dmaObj.transfers.clear();
+    dmaObj.failTransfer = 0;
+    length = maxSize + 2 * minSize;
+    response = transferAll<FakeDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+                                    0, length, 0, true, 0);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR);
+    EXPECT_FALSE(dmaObj.inFlight.has_value());
+
+    fs::remove(path);
+}
+
+TEST(TransferDataHost, Pipeline)
+{
+    using namespace pldm::responder::dma;
+
+    // Whether a DMA operation was in progress during the file I/O of a chunk
+    std::vector<bool> overlapped;
+    FakeDMA dmaObj(numBuffers, 3 * maxSize);
+    auto fileIO = [&dmaObj, &overlapped](std::span<uint8_t> buffer,
+                                         uint32_t chunkOffset) {
+        overlapped.push_back(dmaObj.inFlight.has_value());
+        if (dmaObj.inFlight)
+        {
+            // The staging buffer in use by the DMA engine is left alone
+            EXPECT_NE(dmaObj.getBuffer(*dmaObj.inFlight).data(),
+                      buffer.data());
+        }
+        std::fill(buffer.begin(), buffer.end(), chunkOffset / maxSize + 1);
+        return 0;
+    };
+
+    // Upstream, the next chunk is read while the previous one is DMAed
+    ASSERT_EQ(transferData(&dmaObj, 3 * maxSize, 0, true, fileIO), 0);
+    EXPECT_THAT(overlapped, ElementsAre(false, true, true));
+    EXPECT_THAT(dmaObj.transfers,
+                ElementsAre(std::make_tuple(0, maxSize, 0, true),
+                            std::make_tuple(1, maxSize, maxSize, true),
+                            std::make_tuple(0, maxSize, 2 * maxSize, true)));
+    EXPECT_EQ(dmaObj.readHostMemory(2 * maxSize, maxSize),
+              std::vector<uint8_t>(maxSize, 3));
+
+    // Downstream, the next chunk is DMAed while the current one is written
+    overlapped.clear();
+    dmaObj.transfers.clear();
+    ASSERT_EQ(transferData(&dmaObj, 3 * maxSize, 0, false, fileIO), 0);
+    EXPECT_THAT(overlapped, ElementsAre(true, true, false));
+
+    // With a single staging buffer nothing overlaps
+    FakeDMA singleBuffer(1, 3 * maxSize);
+    overlapped.clear();
+    auto singleFileIO = [&singleBuffer, &overlapped](std::span<uint8_t>,
+                                                     uint32_t) {
+        overlapped.push_back(singleBuffer.inFlight.has_value());
+        return 0;
+    };
+    ASSERT_EQ(transferData(&singleBuffer, 3 * maxSize, 0, true, singleFileIO),
+              0);
+    EXPECT_THAT(overlapped, ElementsAre(false, false, false));
+    overlapped.clear();
+    ASSERT_EQ(transferData(&singleBuffer, 3 * maxSize, 0, false, singleFileIO),
+              0);
+    EXPECT_THAT(overlapped, ElementsAre(false, false, false));
+}
+
+TEST(TransferDataHost, ZeroPadding)
+{
+    using namespace pldm::responder::dma;
+
+    FakeDMA dmaObj(1, maxSize);
+    auto buffer = dmaObj.getBuffer(0);
+    std::fill(buffer.begin(), buffer.end(), 0xff);
+
+    // Only the tail of the last page of the chunk is zeroed
+    size_t pageSize = getpagesize();
+    ASSERT_EQ(transferData(&dmaObj, minSize, 0, true,
+                           [](std::span<uint8_t>, uint32_t) { return 0; }),
+              0);
+    EXPECT_TRUE(std::all_of(buffer.begin(), buffer.begin() + minSize,
+                            [](uint8_t byte) { return byte == 0xff; }));
+    EXPECT_TRUE(std::all_of(buffer.begin() + minSize,
+                            buffer.begin() + pageSize,
+                            [](uint8_t byte) { return byte == 0; }));
+    EXPECT_EQ(buffer[pageSize], 0xff);
+}
+
+TEST(TransferDataHost, testBenchmark)
+{
+    using namespace pldm::responder::dma;
+
+    char tmpfile[] = "/tmp/pldm_fileio_table.XXXXXX";
+    int fd = mkstemp(tmpfile);
+    close(fd);
+    fs::path path(tmpfile);
+    // Kept small so the test suite stays fast, enough to show the cost of
+    // the allocation per chunk
+    constexpr size_t chunks = 2;
+    constexpr uint32_t length = chunks * maxSize;
+    auto data = makeFile(path, length);
+    pldm::utils::CustomFD file(open(path.c_str(), O_RDONLY));
+    FakeDMA dmaObj(numBuffers, length);
+
+    // The chunk is read into a page aligned bounce buffer allocated for the
+    // chunk, as was done before the session kept one, compared with the
+    // bounce buffer of the session
+    auto allocated = [&file](std::span<uint8_t> buffer, uint32_t chunkOffset) {
+        static const size_t pageSize = getpagesize();
+        std::vector<char> bounce((buffer.size() + pageSize - 1) / pageSize *
+                                 pageSize);
+        auto rc = pread(file(), bounce.data(), buffer.size(), chunkOffset);
+        if (rc != static_cast<ssize_t>(buffer.size()))
+        {
+            return -1;
+        }
+        memcpy(buffer.data(), bounce.data(), buffer.size());
+        return 0;
+    };
+    auto persistent = std::bind_front(transferFileChunk, file(), 0, true,
+                                      dmaObj.getBounceBuffer());
+
+    auto measure = [&dmaObj, &data](auto&& fileIO, const std::string& name) {
+        constexpr int iterations = 2;
+        auto cpuStart = std::clock();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            EXPECT_EQ(transferData(&dmaObj, length, 0, true, fileIO), 0);
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto cpu = std::clock() - cpuStart;
+        EXPECT_EQ(dmaObj.readHostMemory(0, length), data);
+
+        auto seconds = std::chrono::duration<double>(end - start).count();
+        auto mibps = iterations * length / seconds / (1024 * 1024);
+        RecordProperty(name + "_MiBps", std::to_string(mibps));
+        RecordProperty(name + "_cpu_us",
+                       std::to_string(cpu * 1000000 / CLOCKS_PER_SEC));
+    };
+
+    measure(allocated, "bounce_per_chunk");
+    measure(persistent, "bounce_persistent");
+
+    fs::remove(path);
+}
+
+TEST(DMAWorker, DeferredResponses)
+{
+    using namespace pldm::responder::dma;
+
+    auto makeResponse = [](uint8_t cc) {
+        Response response(sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES,
+                          0);
+        encode_rw_file_memory_resp(0, PLDM_READ_FILE_INTO_MEMORY, cc, 0,
+                                   reinterpret_cast<pldm_msg*>(
+                                       response.data()));
+        return response;
+    };
+    std::vector<Response> responses;
+    auto completion = [&responses](Response&& response) {
+        responses.emplace_back(std::move(response));
+    };
+
+    auto event = sdeventplus::Event::get_new();
+    Worker worker(event, 2);
+
+    // The first transfer holds the worker thread until it is released
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    ASSERT_TRUE(worker.submit(
+        maxSize,
+        [released, &makeResponse]() {
+        released.wait();
+        return makeResponse(PLDM_SUCCESS);
+    },
+        completion));
+    ASSERT_TRUE(worker.submit(
+        minSize, [&makeResponse]() { return makeResponse(PLDM_ERROR); },
+        completion));
+
+    // Too many transfers pending
+    ASSERT_FALSE(worker.submit(
+        minSize, [&makeResponse]() { return makeResponse(PLDM_SUCCESS); },
+        completion));
+    auto progress = worker.getProgress();
+    EXPECT_EQ(progress.refused, 1);
+    EXPECT_EQ(progress.queued + progress.active, 2);
+    EXPECT_TRUE(responses.empty());
+
+    // The responses are delivered on the event loop, in order
+    release.set_value();
+    while (responses.size() < 2)
+    {
+        event.run(std::nullopt);
+    }
+    EXPECT_THAT(responses, ElementsAre(makeResponse(PLDM_SUCCESS),
+                                       makeResponse(PLDM_ERROR)));
+    progress = worker.getProgress();
+    EXPECT_EQ(progress.queued, 0);
+    EXPECT_FALSE(progress.active);
+    EXPECT_EQ(progress.completed, 2);
+    EXPECT_EQ(progress.failed, 1);
+    EXPECT_EQ(progress.bytes, maxSize + minSize);
+
+    // A transfer that throws completes with an empty response
+    responses.clear();
+    ASSERT_TRUE(worker.submit(
+        minSize, []() -> Response { throw std::runtime_error("I/O error"); },
+        completion));
+    while (responses.empty())
+    {
+        event.run(std::nullopt);
+    }
+    EXPECT_TRUE(responses[0].empty());
+    EXPECT_EQ(worker.getProgress().failed, 2);
+}
+
+TEST(DMASession, DeferWorker)
+{
+    using namespace std::chrono_literals;
+    auto& session = dma::DMA::getSession();
+
+    // The event loop defers a request, the worker waits for it to be served
+    session.deferWorker();
+    auto transfer = std::async(std::launch::async, [&session]() {
+        auto lock = session.lock();
+        return lock.owns_lock();
+    });
+    EXPECT_EQ(transfer.wait_for(100ms), std::future_status::timeout);
+
+    // The event loop may lock the session again while serving the request
+    auto lock = session.tryLock();
+    ASSERT_TRUE(lock.owns_lock());
+    EXPECT_TRUE(session.tryLock().owns_lock());
+    lock.unlock();
+
+    session.resumeWorker();
+    EXPECT_TRUE(transfer.get());
 }
 
 TEST(ReadFileIntoMemory, BadPath)
@@ -228,7 +605,7 @@ TEST(ReadFileIntoMemory, BadPath)
     std::unique_ptr<oem_platform::Handler> oemPlatformHandler{};
     oem_ibm::Handler handler(oemPlatformHandler.get(), hostSocketFd, host_eid,
                              nullptr, nullptr);
-    auto response = handler.readFileIntoMemory(request, 0);
+    auto response = handler.readFileIntoMemory(host_eid, request, 0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR_INVALID_LENGTH);
 }
@@ -262,7 +639,8 @@ TEST_F(TestFileTable, ReadFileInvalidFileHandle)
     std::unique_ptr<oem_platform::Handler> oemPlatformHandler{};
     oem_ibm::Handler handler(oemPlatformHandler.get(), hostSocketFd, host_eid,
                              nullptr, nullptr);
-    auto response = handler.readFileIntoMemory(request, requestPayloadLength);
+    auto response = handler.readFileIntoMemory(host_eid, request,
+                                               requestPayloadLength);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_INVALID_FILE_HANDLE);
     // Clear the file table contents.
@@ -297,7 +675,8 @@ TEST_F(TestFileTable, ReadFileInvalidOffset)
     std::unique_ptr<oem_platform::Handler> oemPlatformHandler{};
     oem_ibm::Handler handler(oemPlatformHandler.get(), hostSocketFd, host_eid,
                              nullptr, nullptr);
-    auto response = handler.readFileIntoMemory(request, requestPayloadLength);
+    auto response = handler.readFileIntoMemory(host_eid, request,
+                                               requestPayloadLength);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_DATA_OUT_OF_RANGE);
     // Clear the file table contents.
@@ -332,7 +711,8 @@ TEST_F(TestFileTable, ReadFileInvalidLength)
     std::unique_ptr<oem_platform::Handler> oemPlatformHandler{};
     oem_ibm::Handler handler(oemPlatformHandler.get(), hostSocketFd, host_eid,
                              nullptr, nullptr);
-    auto response = handler.readFileIntoMemory(request, requestPayloadLength);
+    auto response = handler.readFileIntoMemory(host_eid, request,
+                                               requestPayloadLength);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR_INVALID_LENGTH);
     // Clear the file table contents.
@@ -370,7 +750,8 @@ TEST_F(TestFileTable, ReadFileInvalidEffectiveLength)
     std::unique_ptr<oem_platform::Handler> oemPlatformHandler{};
     oem_ibm::Handler handler(oemPlatformHandler.get(), hostSocketFd, host_eid,
                              nullptr, nullptr);
-    auto response = handler.readFileIntoMemory(request, requestPayloadLength);
+    auto response = handler.readFileIntoMemory(host_eid, request,
+                                               requestPayloadLength);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR_INVALID_LENGTH);
     // Clear the file table contents.
@@ -402,12 +783,13 @@ TEST(WriteFileFromMemory, BadPath)
     std::unique_ptr<oem_platform::Handler> oemPlatformHandler{};
     oem_ibm::Handler handler(oemPlatformHandler.get(), hostSocketFd, host_eid,
                              nullptr, nullptr);
-    auto response = handler.writeFileFromMemory(request, 0);
+    auto response = handler.writeFileFromMemory(host_eid, request, 0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR_INVALID_LENGTH);
 
     // The length field is not a multiple of DMA minsize
-    response = handler.writeFileFromMemory(request, requestPayloadLength);
+    response = handler.writeFileFromMemory(host_eid, request,
+                                           requestPayloadLength);
     responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR_INVALID_LENGTH);
 }
@@ -441,7 +823,8 @@ TEST_F(TestFileTable, WriteFileInvalidFileHandle)
     std::unique_ptr<oem_platform::Handler> oemPlatformHandler{};
     oem_ibm::Handler handler(oemPlatformHandler.get(), hostSocketFd, host_eid,
                              nullptr, nullptr);
-    auto response = handler.writeFileFromMemory(request, requestPayloadLength);
+    auto response = handler.writeFileFromMemory(host_eid, request,
+                                                requestPayloadLength);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_INVALID_FILE_HANDLE);
     // Clear the file table contents.
@@ -477,7 +860,8 @@ TEST_F(TestFileTable, WriteFileInvalidOffset)
     std::unique_ptr<oem_platform::Handler> oemPlatformHandler{};
     oem_ibm::Handler handler(oemPlatformHandler.get(), hostSocketFd, host_eid,
                              nullptr, nullptr);
-    auto response = handler.writeFileFromMemory(request, requestPayloadLength);
+    auto response = handler.writeFileFromMemory(host_eid, request,
+                                                requestPayloadLength);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_DATA_OUT_OF_RANGE);
     // Clear the file table contents.
@@ -810,6 +1194,68 @@ TEST_F(TestFileTable, WriteFileGoodPath)
     table.clear();
 }
 
+TEST_F(TestFileTable, FileSizeChanges)
+{
+    uint32_t fileHandle = 1;
+    uint32_t offset = 16;
+    std::array<char, 4> fileData = {0x41, 0x42, 0x43, 0x44};
+    uint32_t length = fileData.size();
+    uint8_t host_eid = 0;
+    int hostSocketFd = 0;
+
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_READ_FILE_REQ_BYTES>
+        requestMsg{};
+    auto requestMsgPtr = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    auto payload_length = requestMsg.size() - sizeof(pldm_msg_hdr);
+    auto request = reinterpret_cast<pldm_read_file_req*>(requestMsg.data() +
+                                                         sizeof(pldm_msg_hdr));
+    request->file_handle = fileHandle;
+    request->offset = offset;
+    request->length = length;
+
+    using namespace pldm::filetable;
+    // Initialise the file table with 2 valid file handles 0 & 1.
+    auto& table = buildFileTable(fileTableConfig.c_str());
+    ASSERT_EQ(table.at(fileHandle).size, 16);
+
+    std::unique_ptr<oem_platform::Handler> oemPlatformHandler{};
+    oem_ibm::Handler handler(oemPlatformHandler.get(), hostSocketFd, host_eid,
+                             nullptr, nullptr);
+    auto responseMsg = handler.readFile(requestMsgPtr, payload_length);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_DATA_OUT_OF_RANGE);
+
+    // Grow the file, the appended data is read through the open file
+    std::ofstream stream(cksumFile, std::ios::app | std::ios::binary);
+    stream.write(fileData.data(), fileData.size());
+    stream.close();
+
+    ASSERT_EQ(table.at(fileHandle).size, 20);
+    responseMsg = handler.readFile(requestMsgPtr, payload_length);
+    auto response = reinterpret_cast<pldm_read_file_resp*>(
+        responseMsg.data() + sizeof(pldm_msg_hdr));
+    ASSERT_EQ(response->completion_code, PLDM_SUCCESS);
+    ASSERT_EQ(response->length, length);
+    ASSERT_EQ(0, memcmp(response->file_data, fileData.data(), length));
+
+    // The file attribute table and its checksum follow the new size
+    FileTable grown(fileTableConfig.c_str());
+    ASSERT_EQ(table(), grown());
+
+    // Replace the file, it is reopened on the next lookup
+    auto replacement = dir / "replacement";
+    std::ofstream(replacement, std::ios::binary) << std::string(8, 'x');
+    fs::rename(replacement, cksumFile);
+
+    auto value = table.at(fileHandle);
+    ASSERT_NE(value.fd, nullptr);
+    ASSERT_EQ(value.size, 8);
+    FileTable replaced(fileTableConfig.c_str());
+    ASSERT_EQ(table(), replaced());
+
+    table.clear();
+}
+
 TEST(writeFileByTypeFromMemory, testBadPath)
 {
     uint8_t host_eid = 0;
@@ -998,3 +1444,41 @@ TEST(readFileByType, testReadFile)
     ASSERT_EQ(response.size(), in.size());
     ASSERT_EQ(std::equal(in.begin(), in.end(), response.begin()), true);
 }
+
+TEST(PelFdCache, ChunkedReads)
+{
+    std::vector<uint32_t> opened;
+    PelFdCache cache(
+        [&opened](uint32_t pelId) {
+        opened.push_back(pelId);
+        return memfd_create("pel", 0);
+    },
+        2, std::chrono::milliseconds(10));
+
+    // The chunks of a PEL share the fd
+    auto fd = cache.get(1);
+    EXPECT_EQ(cache.get(1), fd);
+    EXPECT_THAT(opened, ElementsAre(1));
+
+    // The least recently used fd is closed when the cache is full
+    cache.get(2);
+    cache.get(1);
+    cache.get(3);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.get(1), fd);
+    cache.get(2);
+    EXPECT_THAT(opened, ElementsAre(1, 2, 3, 2));
+
+    // The fd of an acked PEL is closed
+    cache.release(2);
+    EXPECT_EQ(cache.size(), 1);
+    cache.get(2);
+    EXPECT_THAT(opened, ElementsAre(1, 2, 3, 2, 2));
+
+    // The fds not used for the idle timeout are closed
+    auto event = sdeventplus::Event::get_default();
+    while (cache.size())
+    {
+        event.run(std::nullopt);
+    }
+}
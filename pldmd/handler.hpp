@@ -5,6 +5,7 @@
 #include <cassert>
 #include <functional>
 #include <map>
+#include <utility>
 #include <vector>
 
 namespace pldm
@@ -20,6 +21,10 @@ class CmdHandler;
 using HandlerFunc = std::function<Response(
     pldm_tid_t tid, const pldm_msg* request, size_t reqMsgLen)>;
 
+/** @brief Sends the response of a request that was handled asynchronously */
+using ResponseSender =
+    std::function<void(pldm_tid_t tid, const Response& response)>;
+
 class CmdHandler
 {
   public:
@@ -39,6 +44,17 @@ class CmdHandler
         return handlers.at(pldmCommand)(tid, request, reqMsgLen);
     }
 
+    /** @brief Set the sender of asynchronous responses. A command handler
+     *         that can send its response later returns an empty response, and
+     *         sends the actual one through the sender once it is ready.
+     *
+     *  @param[in] sender - sender of asynchronous responses
+     */
+    void setResponseSender(ResponseSender sender)
+    {
+        responseSender = std::move(sender);
+    }
+
     /** @brief Create a response message containing only cc
      *
      *  @param[in] request - PLDM request message
@@ -61,6 +77,11 @@ class CmdHandler
      *         classes.
      */
     std::map<Command, HandlerFunc> handlers;
+
+    /** @brief sender of asynchronous responses, not set if the responses have
+     *         to be returned by the command handlers
+     */
+    ResponseSender responseSender;
 };
 
 } // namespace responder
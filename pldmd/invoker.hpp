@@ -28,6 +28,18 @@ class Invoker
         handlers.emplace(pldmType, std::move(handler));
     }
 
+    /** @brief Set the sender of asynchronous responses of all the handlers
+     *
+     *  @param[in] sender - sender of asynchronous responses
+     */
+    void setResponseSender(const ResponseSender& sender)
+    {
+        for (auto& [pldmType, handler] : handlers)
+        {
+            handler->setResponseSender(sender);
+        }
+    }
+
     /** @brief Invoke a PLDM command handler
      *
      *  @param[in] tid - PLDM request TID
@@ -142,6 +142,11 @@ static std::optional<Response>
             }
             response.insert(response.end(), completion_code);
         }
+        if (response.empty())
+        {
+            // The handler sends the response once it is ready
+            return std::nullopt;
+        }
         return response;
     }
     else if (PLDM_RESPONSE == hdrFields.msg_type)
@@ -275,15 +280,33 @@ int main(int argc, char** argv)
     auto fruHandler = std::make_unique<fru::Handler>(
         FRU_JSONS_DIR, FRU_MASTER_JSON, pdrRepo.get(), entityTree.get(),
         bmcEntityTree.get(), oemFruHandler.get());
+    if (hostPDRHandler)
+    {
+        // Let the host know of the PDRs changed by FRU hot plug
+        fruHandler->setPDRChangeCallback(
+            [hostPDRHandler](uint8_t eventDataOperation,
+                             std::vector<uint32_t>&& recordHandles) {
+            hostPDRHandler->sendPDRRecordsChgEvent(eventDataOperation,
+                                                   std::move(recordHandles));
+        });
+        // The host PDR merge indexes the nodes of the entity association
+        // tree, which FRU hot unplug removes
+        fruHandler->setEntityRemovalCallback(
+            [hostPDRHandler](const pldm_entity_node* node) {
+            hostPDRHandler->entityNodeRemoved(node);
+        });
+    }
 
-    // FRU table is built lazily when a FRU command or Get PDR command is
-    // handled. To enable building FRU table, the FRU handler is passed to the
-    // Platform handler.
+    // FRU table and PDR repository are built in the background once the event
+    // loop starts. To enable building FRU table, the FRU handler is passed to
+    // the Platform handler.
     auto platformHandler = std::make_unique<platform::Handler>(
         &dbusHandler, hostEID, &instanceIdDb, PDR_JSONS_DIR, pdrRepo.get(),
         hostPDRHandler.get(), dbusToPLDMEventHandler.get(), fruHandler.get(),
         oemPlatformHandler.get(), platformConfigHandler.get(), &reqHandler,
         event, true);
+    platformHandler->setPDRImagePath(PDR_IMAGE_PATH);
+    platformHandler->startPDRConstruction();
 #ifdef OEM_IBM
     pldm::responder::oem_ibm_platform::Handler* oemIbmPlatformHandler =
         dynamic_cast<pldm::responder::oem_ibm_platform::Handler*>(
@@ -313,8 +336,28 @@ int main(int argc, char** argv)
         std::make_unique<MctpDiscovery>(
             bus,
             std::initializer_list<MctpDiscoveryHandlerIntf*>{fwManager.get()});
-    auto callback = [verbose, &invoker, &reqHandler, &fwManager, &pldmTransport,
-                     TID](IO& io, int fd, uint32_t revents) mutable {
+    auto sendResponse = [verbose, &pldmTransport](pldm_tid_t tid,
+                                                  const Response& response) {
+        FlightRecorder::GetInstance().saveRecord(response, true);
+        if (verbose)
+        {
+            printBuffer(Tx, response);
+        }
+
+        auto returnCode = pldmTransport.sendMsg(tid, response.data(),
+                                                response.size());
+        if (returnCode != PLDM_REQUESTER_SUCCESS)
+        {
+            warning(
+                "Failed to send pldmTransport message for TID '{TID}', response code '{RETURN_CODE}'",
+                "TID", tid, "RETURN_CODE", returnCode);
+        }
+    };
+    invoker.setResponseSender(sendResponse);
+
+    auto callback = [verbose, &invoker, &reqHandler, &fwManager, &sendResponse,
+                     &pldmTransport, TID](IO& io, int fd,
+                                          uint32_t revents) mutable {
         if (!(revents & EPOLLIN))
         {
             return;
@@ -344,20 +387,7 @@ int main(int argc, char** argv)
                                          fwManager.get(), TID);
             if (response.has_value())
             {
-                FlightRecorder::GetInstance().saveRecord(*response, true);
-                if (verbose)
-                {
-                    printBuffer(Tx, *response);
-                }
-
-                returnCode = pldmTransport.sendMsg(TID, (*response).data(),
-                                                   (*response).size());
-                if (returnCode != PLDM_REQUESTER_SUCCESS)
-                {
-                    warning(
-                        "Failed to send pldmTransport message for TID '{TID}', response code '{RETURN_CODE}'",
-                        "TID", TID, "RETURN_CODE", returnCode);
-                }
+                sendResponse(TID, *response);
             }
         }
         // TODO check that we get here if mctp-demux dies?